@@ -0,0 +1,229 @@
+#!/usr/bin/env python
+#
+# Runs the micro-benchmarks for a set of systems, sizes, densities and list types and collects the results in a single
+# JSON file. For each case a topology is written, a random configuration is generated with confGenerator and the
+# benchmark executable is run on it. The output of two runs (e.g. of two commits) can be compared case by case, since
+# each case is identified by its label.
+#
+# usage: run_benchmarks.py bin_dir output_file [options]
+# options:
+#   -s, --systems LJ,DNA2,...   systems to benchmark (defaults to all)
+#   -N, --sizes 256,2048        numbers of particles (defaults to 256,2048)
+#   -t, --min-time 0.5          minimum duration of each measurement, in seconds
+
+from __future__ import print_function
+
+import sys
+import os
+import json
+import shutil
+import subprocess
+import tempfile
+import optparse
+import time
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+OXDNA_DIR = os.path.dirname(BENCH_DIR)
+PLUGIN_DIR = os.path.join(OXDNA_DIR, "contrib", "romano")
+
+# keys shared by all the systems
+COMMON_KEYS = {
+	"backend" : "CPU",
+	"backend_precision" : "double",
+	"sim_type" : "MC2",
+	"ensemble" : "NVT",
+	"seed" : "12345",
+	"steps" : "0",
+	"restart_step_counter" : "1",
+	"time_scale" : "linear",
+	"print_conf_interval" : "1000000000",
+	"print_energy_every" : "1000000000",
+	"no_stdout_energy" : "1",
+	"energy_file" : "energy.dat",
+	"trajectory_file" : "trajectory.dat",
+	"lastconf_file" : "last_conf.dat",
+	"conf_file" : "init_conf.dat",
+	"topology" : "topology.top",
+	"verlet_skin" : "0.2",
+	# required by the MC backends, although the moves have their own parameters
+	"delta_translation" : "0.1",
+	"delta_rotation" : "0.1",
+}
+
+
+def simple_topology(N):
+	return "%d 0\n" % N
+
+
+def dna_topology(N, strand_length=10):
+	N_strands = N // strand_length
+	lines = ["%d %d" % (N_strands * strand_length, N_strands)]
+	for s in range(N_strands):
+		for b in range(strand_length):
+			idx = s * strand_length + b
+			n3 = idx - 1 if b > 0 else -1
+			n5 = idx + 1 if b < strand_length - 1 else -1
+			lines.append("%d %s %d %d" % (s + 1, "ACGT"[idx % 4], n3, n5))
+	return "\n".join(lines) + "\n"
+
+
+def dan_topology(N):
+	# a single type of particles with four tetrahedral patches of a single type. PatchyInteractionDan parses the
+	# topology until the end of the file is reached, so there must be no trailing newline
+	patches = ["0 0.57735 0.57735 0.57735", "0 -0.57735 -0.57735 0.57735", "0 -0.57735 0.57735 -0.57735", "0 0.57735 -0.57735 -0.57735"]
+	return "%d 1 1\n%d 4\n%s\n0.3\n1.0" % (N, N, "\n".join(patches))
+
+
+def patchy_shape_topology(N):
+	return "%d 1\n%s\n" % (N, " ".join(["0"] * N))
+
+
+SYSTEMS = {
+	"LJ" : {
+		"keys" : { "interaction_type" : "LJ", "T" : "1.0" },
+		"topology" : simple_topology,
+		"moves" : [ "type = translation\ndelta = 0.1\nprob = 1" ],
+		"densities" : [ 0.1, 0.5 ],
+	},
+	"patchy" : {
+		"keys" : { "interaction_type" : "patchy", "PATCHY_N" : "4", "T" : "0.1" },
+		"topology" : simple_topology,
+		"moves" : [ "type = translation\ndelta = 0.1\nprob = 1", "type = rotation\ndelta = 0.1\nprob = 1" ],
+		"densities" : [ 0.1, 0.5 ],
+	},
+	"PatchyDan" : {
+		"keys" : { "interaction_type" : "patchyDan", "T" : "0.1" },
+		"topology" : dan_topology,
+		"moves" : [ "type = translation\ndelta = 0.1\nprob = 1", "type = rotation\ndelta = 0.1\nprob = 1" ],
+		"densities" : [ 0.1, 0.5 ],
+	},
+	"DNA2" : {
+		"keys" : { "interaction_type" : "DNA2", "T" : "20C", "salt_concentration" : "0.5", "verlet_skin" : "0.5" },
+		"topology" : dna_topology,
+		"moves" : [ "type = VMMC\ndelta_tras = 0.1\ndelta_rot = 0.2\nprob = 1" ],
+		"densities" : [ 0.01, 0.05 ],
+		# VMMC works only with cells
+		"list_types" : [ "cells" ],
+	},
+	"HardIco" : {
+		"keys" : { "interaction_type" : "HardIcoInteraction", "patchy_delta" : "0.2", "T" : "1.0", "plugin_search_path" : PLUGIN_DIR },
+		"topology" : simple_topology,
+		"moves" : [ "type = translation\ndelta = 0.05\nprob = 1", "type = rotation\ndelta = 0.1\nprob = 1" ],
+		"densities" : [ 0.1, 0.5 ],
+	},
+	"PatchyShape" : {
+		"keys" : {
+			"interaction_type" : "PatchyShapeInteraction",
+			"plugin_search_path" : PLUGIN_DIR,
+			"shape" : "icosahedron",
+			"particle_types_N" : "1",
+			"patch_types_N" : "6",
+			"patchy_file" : os.path.join(BENCH_DIR, "PatchyShape", "patches.txt"),
+			"particle_file" : os.path.join(BENCH_DIR, "PatchyShape", "particles.txt"),
+			"same_type_bonding" : "1",
+			"use_torsion" : "0",
+			"interaction_tensor" : "0",
+			"PATCHY_radius" : "0.5",
+			"PATCHY_alpha" : "0.05",
+			"no_multipatch" : "1",
+			"T" : "0.1",
+			"verlet_skin" : "0.5",
+		},
+		"topology" : patchy_shape_topology,
+		"moves" : [ "type = MCMovePatchyShape\ndelta_translation = 0.01\ndelta_rotation = 0.1\nprob = 1" ],
+		"densities" : [ 0.1, 0.5 ],
+	},
+}
+
+LIST_TYPES = [ "verlet", "cells" ]
+
+
+def write_input(filename, keys, moves):
+	with open(filename, "w") as out:
+		for k in sorted(keys.keys()):
+			print("%s = %s" % (k, keys[k]), file=out)
+		for i, move in enumerate(moves):
+			print("move_%d = {\n%s\n}" % (i + 1, move), file=out)
+
+
+def run_case(bin_dir, system, N, density, list_type, min_time):
+	label = "%s_N%d_rho%g_%s" % (system, N, density, list_type)
+	conf = SYSTEMS[system]
+	work_dir = tempfile.mkdtemp(prefix="oxDNA_bench_")
+	try:
+		keys = dict(COMMON_KEYS)
+		keys.update(conf["keys"])
+		keys["list_type"] = list_type
+		with open(os.path.join(work_dir, "topology.top"), "w") as out:
+			out.write(conf["topology"](N))
+		write_input(os.path.join(work_dir, "input"), keys, conf["moves"])
+
+		with open(os.path.join(work_dir, "log"), "w") as log:
+			subprocess.check_call([os.path.join(bin_dir, "confGenerator"), "input", str(density)], cwd=work_dir, stdout=log, stderr=log)
+			subprocess.check_call([os.path.join(bin_dir, "benchmark"), "input", "benchmark_output=bench.json", "benchmark_label=%s" % label, "benchmark_min_time=%g" % min_time], cwd=work_dir, stdout=log, stderr=log)
+		with open(os.path.join(work_dir, "bench.json")) as f:
+			return json.load(f)
+	except (subprocess.CalledProcessError, OSError, ValueError) as e:
+		print("Case %s failed (%s), its log follows" % (label, e), file=sys.stderr)
+		log_file = os.path.join(work_dir, "log")
+		if os.path.exists(log_file):
+			with open(log_file) as f:
+				print(f.read(), file=sys.stderr)
+		return None
+	finally:
+		shutil.rmtree(work_dir)
+
+
+def git_revision():
+	try:
+		return subprocess.check_output(["git", "rev-parse", "HEAD"], cwd=OXDNA_DIR).decode().strip()
+	except (subprocess.CalledProcessError, OSError):
+		return "unknown"
+
+
+def main():
+	parser = optparse.OptionParser(usage="%prog bin_dir output_file [options]")
+	parser.add_option("-s", "--systems", default=",".join(sorted(SYSTEMS.keys())))
+	parser.add_option("-N", "--sizes", default="256,2048")
+	parser.add_option("-t", "--min-time", type="float", default=0.5)
+	(options, args) = parser.parse_args()
+	if len(args) != 2:
+		parser.print_help()
+		sys.exit(1)
+	bin_dir, output_file = args
+
+	systems = options.systems.split(",")
+	for system in systems:
+		if system not in SYSTEMS:
+			print("Unknown system '%s', the available ones are %s" % (system, ", ".join(sorted(SYSTEMS.keys()))), file=sys.stderr)
+			sys.exit(1)
+	sizes = [int(N) for N in options.sizes.split(",")]
+
+	cases = []
+	failed = 0
+	for system in systems:
+		for N in sizes:
+			for density in SYSTEMS[system]["densities"]:
+				for list_type in SYSTEMS[system].get("list_types", LIST_TYPES):
+					result = run_case(bin_dir, system, N, density, list_type, options.min_time)
+					if result is None:
+						failed += 1
+					else:
+						cases.append(result)
+						print("%s done" % result["label"], file=sys.stderr)
+
+	output = {
+		"revision" : git_revision(),
+		"date" : time.strftime("%Y-%m-%d %H:%M:%S"),
+		"cases" : cases,
+	}
+	with open(output_file, "w") as out:
+		json.dump(output, out, indent=1)
+
+	if failed > 0:
+		print("%d cases failed" % failed, file=sys.stderr)
+		sys.exit(1)
+
+
+if __name__ == '__main__':
+	main()
@@ -10,6 +10,7 @@
 
 template<typename number>
 AVBDepletion<number>::AVBDepletion (){
+	this->_step_sizes.push_back(&_delta_rot);
 	_ntries = -1;
 	_sigma_dep = 0.5f;
 	_tryvolume = -1.f;
@@ -465,11 +466,11 @@ void AVBDepletion<number>::apply (llint curr_step) {
 	}
 
 	// we select the target particle
-	int pti = (int) (drand48() * (*this->_Info->N));
+	int pti = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * pt = this->_Info->particles[pti];
 	if (this->_restrict_to_type >= 0) {
 		while(pt->type != this->_restrict_to_type) {
-			pti = (int) (drand48() * (*this->_Info->N));
+			pti = (int) (this->_rand() * (*this->_Info->N));
 			pt = this->_Info->particles[pti];
 		}
 	}
@@ -483,10 +484,10 @@ void AVBDepletion<number>::apply (llint curr_step) {
 	}
 
 	// we select the particle to move
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * p = this->_Info->particles[pi];
 
-	bool move_in = drand48() < 0.5;
+	bool move_in = this->_rand() < 0.5;
 
 	if (move_in) {
 		/*
@@ -498,17 +499,17 @@ void AVBDepletion<number>::apply (llint curr_step) {
 		*/
 		// choose a NON neighbour of target
 		while (std::find(target_neighs.begin(), target_neighs.end(), p) != target_neighs.end() || p == pt) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 			p = this->_Info->particles[pi];
 			if (this->_restrict_to_type >= 0) {
 				while(p->type != this->_restrict_to_type) {
-					pi = (int) (drand48() * (*this->_Info->N));
+					pi = (int) (this->_rand() * (*this->_Info->N));
 					p = this->_Info->particles[pi];
 				}
 
 			}
 			else {
-				pi = (int) (drand48() * (*this->_Info->N));
+				pi = (int) (this->_rand() * (*this->_Info->N));
 				p = this->_Info->particles[pi];
 			}
 		}
@@ -529,17 +530,17 @@ void AVBDepletion<number>::apply (llint curr_step) {
 			pi = p->index;
 		}
 		else {
-			pi = (int) (drand48() * (target_neighs.size()));
+			pi = (int) (this->_rand() * (target_neighs.size()));
 			p = target_neighs[pi];
 			while (p == pt) {
 				if (this->_restrict_to_type >= 0) {
 					while(p->type != this->_restrict_to_type) {
-						pi = (int) (drand48() * (target_neighs.size()));
+						pi = (int) (this->_rand() * (target_neighs.size()));
 						p = target_neighs[pi];
 					}
 				}
 				else {
-					pi = (int) (drand48() * (target_neighs.size()));
+					pi = (int) (this->_rand() * (target_neighs.size()));
 					p = target_neighs[pi];
 				}
 				//printf ("trying %d...\n", pi);
@@ -576,24 +577,24 @@ void AVBDepletion<number>::apply (llint curr_step) {
 			number dpx = -1., dpy = -1., dpz = -1.;
 			number cntrl = -1;
 			do {
-				dpx = (2. * (drand48() - 0.5)) * _rmax;
-				dpy = (2. * (drand48() - 0.5)) * _rmax;
+				dpx = (2. * (this->_rand() - 0.5)) * _rmax;
+				dpy = (2. * (this->_rand() - 0.5)) * _rmax;
 				cntrl = dpx * dpx + dpy * dpy;
 			} while (!(_rmin * _rmin < cntrl && cntrl < _rmax * _rmax));
 
-			dpz = 2. * (drand48() - 0.5) * _delta_z;
+			dpz = 2. * (this->_rand() - 0.5) * _delta_z;
 
 			p->pos = pt->pos + dpx * pt->orientation.v1 + dpy * pt->orientation.v2 + dpz * pt->orientation.v3;
 
 			LR_matrix<number> R;
 			number angle;
-			if (drand48() < 0.5) angle = acos(cos(_delta_rot) + (1.-cos(_delta_rot))*drand48()); // a [0, delta_rot] --> cos(a) [cos(delta_rot), 1]
+			if (this->_rand() < 0.5) angle = acos(cos(_delta_rot) + (1.-cos(_delta_rot))*this->_rand()); // a [0, delta_rot] --> cos(a) [cos(delta_rot), 1]
 			//else angle = acos((-1. + cos(_delta_rot)) * drand48());
-			else angle = M_PI - acos(cos(_delta_rot) + (1. - cos(_delta_rot))*drand48());
+			else angle = M_PI - acos(cos(_delta_rot) + (1. - cos(_delta_rot))*this->_rand());
 			//R = Utils::get_random_rotation_matrix_from_angle(angle);
 
 			{
-				number phi = drand48() * 2. * M_PI;
+				number phi = this->_rand() * 2. * M_PI;
 				LR_vector<number> axis = cos(phi) * pt->orientation.v1 + sin(phi) * pt->orientation.v2;
 				axis.normalize();
 				number t = angle;
@@ -624,10 +625,10 @@ void AVBDepletion<number>::apply (llint curr_step) {
 			// we move p out of the neighbourhood of target
 			do {
 				LR_vector<number> box_sides = this->_Info->box->box_sides();
-				p->pos.x = drand48() * box_sides.x;
-				p->pos.y = drand48() * box_sides.y;
-				p->pos.z = drand48() * box_sides.z;
-				p->orientation = Utils::get_random_rotation_matrix_from_angle<number> (acos(2.*(drand48()-0.5)));
+				p->pos.x = this->_rand() * box_sides.x;
+				p->pos.y = this->_rand() * box_sides.y;
+				p->pos.z = this->_rand() * box_sides.z;
+				p->orientation = Utils::get_random_rotation_matrix_from_angle<number> (acos(2.*(this->_rand()-0.5)));
 				p->orientationT = p->orientation.get_transpose();
 				p->set_positions();
 			} while (are_close(pt, p, false) == true);
@@ -692,12 +693,12 @@ void AVBDepletion<number>::apply (llint curr_step) {
 		// free volume before the move;
 		int ntry = 0, nfv = 0;
 		while (ntry < _ntries) {
-			number dx = 2.*drand48() - 1.; // between -1 and 1
-			number dy = 2.*drand48() - 1.; // between -1 and 1
-			number dz = drand48() - 0.5;   // between -0.5 and 0.5;
+			number dx = 2.*this->_rand() - 1.; // between -1 and 1
+			number dy = 2.*this->_rand() - 1.; // between -1 and 1
+			number dz = this->_rand() - 0.5;   // between -0.5 and 0.5;
 			while (dx*dx + dy*dy >= 1.) {
-				dx = 2.*drand48() - 1.;
-				dy = 2.*drand48() - 1.;
+				dx = 2.*this->_rand() - 1.;
+				dy = 2.*this->_rand() - 1.;
 			}
 			dx = dx * (0.5 + _sigma_dep);
 			dy = dy * (0.5 + _sigma_dep);
@@ -734,12 +735,12 @@ void AVBDepletion<number>::apply (llint curr_step) {
 		ntry = 0;
 		nfv = 0;
 		while (ntry < _ntries) {
-			number dx = 2.*drand48() - 1.; // between -1 and 1
-			number dy = 2.*drand48() - 1.; // between -1 and 1
-			number dz = drand48() - 0.5;   // between -0.5 and 0.5;
+			number dx = 2.*this->_rand() - 1.; // between -1 and 1
+			number dy = 2.*this->_rand() - 1.; // between -1 and 1
+			number dz = this->_rand() - 0.5;   // between -0.5 and 0.5;
 			while (dx*dx + dy*dy >= 1.) {
-				dx = 2.*drand48() - 1.;
-				dy = 2.*drand48() - 1.;
+				dx = 2.*this->_rand() - 1.;
+				dy = 2.*this->_rand() - 1.;
 			}
 			dx = dx * (0.5 + _sigma_dep);
 			dy = dy * (0.5 + _sigma_dep);
@@ -810,7 +811,7 @@ void AVBDepletion<number>::apply (llint curr_step) {
 	//if (this->_Info->interaction->get_is_infinite() == false && depletion_bias > 1.) printf ("%8.6e %8.6e %8.6e %d %d\n", delta_E, avb_bias, depletion_bias, move_in, true);
 
 	if (this->_Info->interaction->get_is_infinite() == false &&
-		exp(-(delta_E + delta_E_ext) / this->_T) * avb_bias * depletion_bias > drand48() ) {
+		exp(-(delta_E + delta_E_ext) / this->_T) * avb_bias * depletion_bias > this->_rand() ) {
 		// move accepted
         this->_accepted ++;
 
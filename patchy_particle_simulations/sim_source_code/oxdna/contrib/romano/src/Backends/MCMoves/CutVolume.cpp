@@ -11,6 +11,7 @@
 /// traslation
 template<typename number>
 CutVolume<number>::CutVolume () {
+	this->_step_sizes.push_back(&_delta);
 	_verlet_skin = -1.f;
 	_P = 0.f;
 }
@@ -59,7 +60,7 @@ void CutVolume<number>::apply (llint curr_step) {
 
 	// chose position
 	LR_vector<number> box_sides_old = this->_Info->box->box_sides();
-	number cut_at = drand48() * box_sides_old[affected_axis];
+	number cut_at = this->_rand() * box_sides_old[affected_axis];
 	number oldV = (box_sides_old[0] * box_sides_old[1] * box_sides_old[2]);
 
 	number oldE;
@@ -68,7 +69,7 @@ void CutVolume<number>::apply (llint curr_step) {
 	if (this->_Info->interaction->get_is_infinite()) printf ("WHAAT\n");
 
 	bool expand = true;
-	if (drand48() < 0.5) {
+	if (this->_rand() < 0.5) {
 		expand = false;
 	}
 
@@ -124,7 +125,7 @@ void CutVolume<number>::apply (llint curr_step) {
 	number V = box_sides.x * box_sides.y * box_sides.z;
 	number dV = V - oldV;
 
-	if (reject == false && this->_Info->interaction->get_is_infinite() == false && exp(-(dE + _P*dV - (N + 1)*this->_T*log(V/oldV)) / this->_T) > drand48()) {
+	if (reject == false && this->_Info->interaction->get_is_infinite() == false && exp(-(dE + _P*dV - (N + 1)*this->_T*log(V/oldV)) / this->_T) > this->_rand()) {
 		this->_accepted ++;
 		if (curr_step < this->_equilibration_steps && this->_adjust_moves) _delta *= this->_acc_fact;
 		//number xE  = this->_Info->interaction->get_system_energy(this->_Info->particles, *this->_Info->N, this->_Info->lists);
@@ -10,6 +10,9 @@
 
 template<typename number>
 Depletion<number>::Depletion (){
+	this->_step_sizes.push_back(&_delta_trs);
+	this->_step_sizes.push_back(&_delta_rot);
+	this->_step_sizes.push_back(&_delta_swm);
 	_delta_trs = (number) -1.f;
 	_delta_rot = (number) -1.f;
 	_delta_swm = (number) -1.f;
@@ -111,11 +114,11 @@ void Depletion<number>::apply (llint curr_step) {
 	this->_attempted += 1;
 
 	// we select the particle to translate
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * p = this->_Info->particles[pi];
 	if (this->_restrict_to_type >= 0) {
 		while(p->type != this->_restrict_to_type) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 			p = this->_Info->particles[pi];
 		}
 	}
@@ -140,19 +143,19 @@ void Depletion<number>::apply (llint curr_step) {
 	LR_matrix<number> orientation_old = p->orientation;
 	LR_matrix<number> orientationT_old = p->orientationT;
 	if (move_type == DEPLETION_TRANSLATION) {
-		number dx = (number) 2.f * _delta_trs * (drand48() - 0.5);
-		number dy = (number) 2.f * _delta_trs * (drand48() - 0.5);
+		number dx = (number) 2.f * _delta_trs * (this->_rand() - 0.5);
+		number dy = (number) 2.f * _delta_trs * (this->_rand() - 0.5);
 		p->pos += p->orientation.v1 * dx + p->orientation.v2 * dy;
 		//p->pos.z += (number) 2.f * _delta_trs * (drand48() - 0.5); // better to have separate on-axis and off-axis moves (SWIM)
 	}
 	if (move_type == DEPLETION_ROTATION) {
-		LR_matrix<number> R = Utils::get_random_rotation_matrix_from_angle<number> (_delta_rot * drand48());
+		LR_matrix<number> R = Utils::get_random_rotation_matrix_from_angle<number> (_delta_rot * this->_rand());
 		p->orientation = R * p->orientation;
 		p->orientationT = p->orientation.get_transpose();
 		p->set_positions();
 	}
 	if (move_type == DEPLETION_SWIM) {
-		p->pos += ((number) 2.f * _delta_swm * (number)(drand48() - 0.5)) * p->orientation.v3;
+		p->pos += ((number) 2.f * _delta_swm * (number)(this->_rand() - 0.5)) * p->orientation.v3;
 	}
 
 	this->_Info->lists->single_update(p);
@@ -200,12 +203,12 @@ void Depletion<number>::apply (llint curr_step) {
 
 //#####pragma
 		while (ntry < _ntries) {
-			number dx = 2.*drand48() - 1.; // between -1 and 1
-			number dy = 2.*drand48() - 1.; // between -1 and 1
-			number dz = drand48() - 0.5;   // between -0.5 and 0.5;
+			number dx = 2.*this->_rand() - 1.; // between -1 and 1
+			number dy = 2.*this->_rand() - 1.; // between -1 and 1
+			number dz = this->_rand() - 0.5;   // between -0.5 and 0.5;
 			while (dx*dx + dy*dy >= 1.) {
-				dx = 2.*drand48() - 1.;
-				dy = 2.*drand48() - 1.;
+				dx = 2.*this->_rand() - 1.;
+				dy = 2.*this->_rand() - 1.;
 			}
 			dx = dx * (0.5 + _sigma_dep);
 			dy = dy * (0.5 + _sigma_dep);
@@ -247,12 +250,12 @@ void Depletion<number>::apply (llint curr_step) {
 		ntry = 0;
 		nfv = 0;
 		while (ntry < _ntries) {
-			number dx = 2.*drand48() - 1.; // between -1 and 1
-			number dy = 2.*drand48() - 1.; // between -1 and 1
-			number dz = drand48() - 0.5;   // between -0.5 and 0.5;
+			number dx = 2.*this->_rand() - 1.; // between -1 and 1
+			number dy = 2.*this->_rand() - 1.; // between -1 and 1
+			number dz = this->_rand() - 0.5;   // between -0.5 and 0.5;
 			while (dx*dx + dy*dy >= 1.) {
-				dx = 2.*drand48() - 1.;
-				dy = 2.*drand48() - 1.;
+				dx = 2.*this->_rand() - 1.;
+				dy = 2.*this->_rand() - 1.;
 			}
 			dx = dx * (0.5 + _sigma_dep);
 			dy = dy * (0.5 + _sigma_dep);
@@ -306,7 +309,7 @@ void Depletion<number>::apply (llint curr_step) {
 
 		f = 1./f;
 
-		if (f >= (number) 1.f || f > drand48()) depletion_accept = true;
+		if (f >= (number) 1.f || f > this->_rand()) depletion_accept = true;
 		else depletion_accept = false;
 
 		//if (dn >= 0) printf ("dn, f: %5d %8.6lf (new=%d, old=%d, ntries=%d, part_log=%g, pow=%g)\n", dn, (double) f, n_new, n_old, _ntries, 1.0 / part_log(n_old + dn, n_old), _z * _tryvolume);
@@ -336,7 +339,7 @@ void Depletion<number>::apply (llint curr_step) {
 	// accept or reject?
 	if (this->_Info->interaction->get_is_infinite() == false &&
 		depletion_accept == true &&
-		((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48()) ) {
+		((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand()) ) {
 		// move accepted
         this->_accepted ++;
 
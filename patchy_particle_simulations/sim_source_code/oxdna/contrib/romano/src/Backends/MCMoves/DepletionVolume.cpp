@@ -10,6 +10,7 @@
 
 template<typename number>
 DepletionVolume<number>::DepletionVolume (){
+	this->_step_sizes.push_back(&_delta);
 	_delta = (number) -1.f;
 	_delta_max = (number) -1.f;
 	_ntries = -1;
@@ -100,7 +101,7 @@ void DepletionVolume<number>::apply (llint curr_step) {
 
 	number oldV = this->_Info->box->V();
 
-	number dL = _delta * (drand48() - 0.5);
+	number dL = _delta * (this->_rand() - 0.5);
 	box_sides.z += dL;
 
 	number f = sqrt(old_box_sides.z / box_sides.z);
@@ -165,9 +166,9 @@ void DepletionVolume<number>::apply (llint curr_step) {
 		cells->change_box();
 		if(!this->_Info->lists->is_updated()) this->_Info->lists->global_update();
 		for (int d = 0; d < ndep; d++) {
-			p->pos.x = drand48() * old_box_sides.x;
-			p->pos.y = drand48() * old_box_sides.y;
-			p->pos.z = drand48() * old_box_sides.z;
+			p->pos.x = this->_rand() * old_box_sides.x;
+			p->pos.y = this->_rand() * old_box_sides.y;
+			p->pos.z = this->_rand() * old_box_sides.z;
 			bool overlap = false;
 			int k = cells->get_cell_index(p->pos);
 			typename std::vector<BaseParticle<number> *>::iterator it;
@@ -193,9 +194,9 @@ void DepletionVolume<number>::apply (llint curr_step) {
 		cells->change_box();
 		if(!this->_Info->lists->is_updated()) this->_Info->lists->global_update();
 		for (int d = 0; d < ndep; d++) {
-			p->pos.x = drand48() * box_sides.x;
-			p->pos.y = drand48() * box_sides.y;
-			p->pos.z = drand48() * box_sides.z;
+			p->pos.x = this->_rand() * box_sides.x;
+			p->pos.y = this->_rand() * box_sides.y;
+			p->pos.z = this->_rand() * box_sides.z;
 			int k = cells->get_cell_index(p->pos);
 			bool overlap = false;
 			typename std::vector<BaseParticle<number> *>::iterator it;
@@ -225,7 +226,7 @@ void DepletionVolume<number>::apply (llint curr_step) {
 	// for the ideal gas, beta * P = rho = z
 	//exp(-(dE + _P*dV - (N + 1)*this->_T*log(V/oldV))/this->_T
 	if (this->_Info->interaction->get_is_infinite() == false &&
-		exp(-(dE + dExt) / this->_T -_z*dV +(N+1)*log(V/oldV)) > drand48() ) {
+		exp(-(dE + dExt) / this->_T -_z*dV +(N+1)*log(V/oldV)) > this->_rand() ) {
 		//exp(-(dE + dExt) / this->_T -_z*dV +(N+1)*log(V/oldV)) > drand48() ) {
 		// move accepted
         this->_accepted ++;
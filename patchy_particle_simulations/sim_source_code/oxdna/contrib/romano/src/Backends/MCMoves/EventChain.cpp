@@ -0,0 +1,412 @@
+/**
+ * @file    EventChain.cpp
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#include "EventChain.h"
+
+#include <limits>
+#include <algorithm>
+
+// maximum number of iterations of the ray cast. Since the ray parameter only grows, stopping early gives a collision
+// distance that is shorter than the exact one, and hence it never leads to overlaps
+#define EC_MAX_ITERATIONS 64
+// relative tolerance of the ray cast
+#define EC_SQR_TOLERANCE 1e-20
+// relative distance from the contact at which the particles are stopped
+#define EC_CONTACT_MARGIN 1e-9
+// maximum number of zero-length events in a row before a chain is given up
+#define EC_MAX_ZERO_EVENTS 1000
+
+/**
+ * Finds the point of the convex hull of the n points y (1 <= n <= 4) that is closest to the origin, by looking at the
+ * affine hull of each subset of the points (Johnson's algorithm). The smallest subset whose convex hull contains the
+ * closest point is stored, as a bit mask, in best_subset.
+ */
+static LR_vector<double> _closest_to_origin(const LR_vector<double> *y, int n, int &best_subset) {
+	double best_dist = -1.;
+	LR_vector<double> best(0., 0., 0.);
+	best_subset = 0;
+
+	for(int subset = 1; subset < (1 << n); subset++) {
+		LR_vector<double> s[4];
+		int k = 0;
+		for(int i = 0; i < n; i++) {
+			if(subset & (1 << i)) s[k++] = y[i];
+		}
+
+		// minimise |s0 + sum_j mu_j (s_j - s0)|^2 by solving the normal equations G mu = -b
+		double G[3][3], b[3], mu[3] = {0., 0., 0.};
+		LR_vector<double> d[3];
+		for(int j = 1; j < k; j++) d[j - 1] = s[j] - s[0];
+		for(int j = 0; j < k - 1; j++) {
+			for(int l = 0; l < k - 1; l++) G[j][l] = d[j] * d[l];
+			b[j] = -(d[j] * s[0]);
+		}
+
+		bool valid = true;
+		if(k == 2) {
+			if(G[0][0] <= 0.) valid = false;
+			else mu[0] = b[0] / G[0][0];
+		}
+		else if(k == 3) {
+			double det = G[0][0] * G[1][1] - G[0][1] * G[1][0];
+			if(fabs(det) <= 1e-14 * G[0][0] * G[1][1]) valid = false;
+			else {
+				mu[0] = (b[0] * G[1][1] - G[0][1] * b[1]) / det;
+				mu[1] = (G[0][0] * b[1] - b[0] * G[1][0]) / det;
+			}
+		}
+		else if(k == 4) {
+			double det = G[0][0] * (G[1][1] * G[2][2] - G[1][2] * G[2][1]) - G[0][1] * (G[1][0] * G[2][2] - G[1][2] * G[2][0]) + G[0][2] * (G[1][0] * G[2][1] - G[1][1] * G[2][0]);
+			if(fabs(det) <= 1e-14 * G[0][0] * G[1][1] * G[2][2]) valid = false;
+			else {
+				for(int c = 0; c < 3; c++) {
+					double M[3][3];
+					for(int r = 0; r < 3; r++) {
+						for(int cc = 0; cc < 3; cc++) M[r][cc] = (cc == c) ? b[r] : G[r][cc];
+					}
+					mu[c] = (M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1]) - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0]) + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0])) / det;
+				}
+			}
+		}
+		if(!valid) continue;
+
+		// the closest point has to be strictly inside the subset
+		double mu0 = 1.;
+		for(int j = 0; j < k - 1; j++) {
+			if(mu[j] <= 0.) valid = false;
+			mu0 -= mu[j];
+		}
+		if(!valid || mu0 <= 0.) continue;
+
+		LR_vector<double> point = s[0];
+		for(int j = 0; j < k - 1; j++) point += d[j] * mu[j];
+		double dist = point.norm();
+		if(best_dist < 0. || dist < best_dist) {
+			best_dist = dist;
+			best = point;
+			best_subset = subset;
+		}
+	}
+
+	return best;
+}
+
+template<typename number>
+EventChain<number>::EventChain() {
+	_chain_length = (number) 0.f;
+	_N_vertexes = 12;
+	_soft_resolution = (number) 0.f;
+	_circumradius = (number) 0.f;
+	_cells = NULL;
+	_cell_layers = 1;
+	_N_events = 0;
+	_N_stuck_chains = 0;
+}
+
+template<typename number>
+EventChain<number>::~EventChain() {
+
+}
+
+template<typename number>
+void EventChain<number>::get_settings(input_file &inp, input_file &sim_inp) {
+	BaseMove<number>::get_settings(inp, sim_inp);
+
+	getInputNumber(&inp, "chain_length", &_chain_length, 1);
+	getInputInt(&inp, "N_vertexes", &_N_vertexes, 0);
+	getInputNumber(&inp, "soft_resolution", &_soft_resolution, 0);
+
+	if(_chain_length <= (number) 0.f) throw oxDNAException("(EventChain.cpp) chain_length should be larger than 0");
+	if(_N_vertexes < 4) throw oxDNAException("(EventChain.cpp) N_vertexes should be at least 4");
+	if(_soft_resolution < (number) 0.f) throw oxDNAException("(EventChain.cpp) soft_resolution cannot be negative");
+
+	std::string inter_type("");
+	getInputString(&sim_inp, "interaction_type", inter_type, 0);
+	if(inter_type == "PatchyShapeInteraction") {
+		// the chain moves particles without updating the patch locks, which would then be left in a wrong state
+		bool no_multipatch = true;
+		getInputBool(&sim_inp, "no_multipatch", &no_multipatch, 0);
+		if(no_multipatch) throw oxDNAException("(EventChain.cpp) EventChain cannot be used with PatchyShapeInteraction and no_multipatch = true");
+	}
+	// with soft_resolution = 0 the energy of the pairs is ignored, which is correct only if the interaction is purely hard
+	if(_soft_resolution == (number) 0.f && inter_type != "HardIcoInteraction") throw oxDNAException("(EventChain.cpp) soft_resolution = 0 is only supported with hard interactions (HardIcoInteraction): set soft_resolution to a value larger than 0 to take the pair energies of interaction_type = %s into account", inter_type.c_str());
+
+	OX_LOG(Logger::LOG_INFO, "(EventChain.cpp) EventChain initiated with chain_length %g, N_vertexes %d, soft_resolution %g, prob %g", _chain_length, _N_vertexes, _soft_resolution, this->prob);
+}
+
+template<typename number>
+void EventChain<number>::init() {
+	BaseMove<number>::init();
+
+	_cells = dynamic_cast<Cells<number> *>(this->_Info->lists);
+	if(_cells == NULL) throw oxDNAException("(EventChain.cpp) EventChain requires list_type = cells");
+
+	_circumradius = (number) 0.f;
+	for(int i = 0; i < *this->_Info->N; i++) {
+		BaseParticle<number> *p = this->_Info->particles[i];
+		if(p->N_int_centers < _N_vertexes) throw oxDNAException("(EventChain.cpp) Particle %d has %d interaction centres, but N_vertexes = %d", i, p->N_int_centers, _N_vertexes);
+		if(p->N_ext_forces > 0) throw oxDNAException("(EventChain.cpp) EventChain does not support external forces");
+		for(int k = p->N_int_centers - _N_vertexes; k < p->N_int_centers; k++) {
+			number r = p->int_centers[k].module();
+			if(r > _circumradius) _circumradius = r;
+		}
+	}
+
+	_vertexes_p.resize(_N_vertexes);
+	_vertexes_q.resize(_N_vertexes);
+
+	number max_step = _max_step();
+	if(max_step <= (number) 0.f) throw oxDNAException("(EventChain.cpp) The box is too small to be used by EventChain: particles cannot be moved without leaving their neighbourhood");
+	OX_LOG(Logger::LOG_INFO, "(EventChain.cpp) Circumradius of the polyhedra: %g, neighbours looked for in %d layer(s) of cells, maximum displacement between neighbour updates: %g", _circumradius, _cell_layers, max_step);
+	if(max_step < _chain_length) OX_LOG(Logger::LOG_WARNING, "(EventChain.cpp) The box is too small to move particles by chain_length (%g) at once: each chain will be split in up to %d displacements", _chain_length, (int) ceil(_chain_length / max_step));
+}
+
+template<typename number>
+number EventChain<number>::_max_step() {
+	LR_vector<number> box_sides = this->_Info->box->box_sides();
+	number cell_width = box_sides[0] / _cells->get_N_cells_side(0);
+	for(int d = 1; d < 3; d++) {
+		number width = box_sides[d] / _cells->get_N_cells_side(d);
+		if(width < cell_width) cell_width = width;
+	}
+
+	number range = 2. * _circumradius;
+	if(_soft_resolution > (number) 0.f && this->_Info->interaction->get_rcut() > range) range = this->_Info->interaction->get_rcut();
+
+	// the layers should cover the whole chain, but they cannot wrap around the box, since distances are computed with the
+	// minimum image convention
+	int max_layers = (std::min(_cells->get_N_cells_side(0), std::min(_cells->get_N_cells_side(1), _cells->get_N_cells_side(2))) - 1) / 2;
+	_cell_layers = (int) ceil((_chain_length + range) / cell_width);
+	if(_cell_layers > max_layers) _cell_layers = max_layers;
+	if(_cell_layers < 1) _cell_layers = 1;
+
+	return _cell_layers * cell_width - range;
+}
+
+// support point, along d, of the set of the vectors that go from a point of the first polyhedron to a point of the second one
+template<typename number>
+LR_vector<double> EventChain<number>::_support(const LR_vector<double> &r, const LR_vector<double> &d) {
+	int best_p = 0, best_q = 0;
+	double min_p = _vertexes_p[0] * d;
+	double max_q = _vertexes_q[0] * d;
+	for(int k = 1; k < _N_vertexes; k++) {
+		double dp = _vertexes_p[k] * d;
+		if(dp < min_p) {
+			min_p = dp;
+			best_p = k;
+		}
+		double dq = _vertexes_q[k] * d;
+		if(dq > max_q) {
+			max_q = dq;
+			best_q = k;
+		}
+	}
+	return r + _vertexes_q[best_q] - _vertexes_p[best_p];
+}
+
+template<typename number>
+number EventChain<number>::_collision_distance(BaseParticle<number> *p, BaseParticle<number> *q, const LR_vector<number> &e, number max_dist) {
+	LR_vector<number> nr = this->_Info->box->min_image(p, q);
+	LR_vector<double> r(nr.x, nr.y, nr.z);
+	LR_vector<double> dir(e.x, e.y, e.z);
+
+	// the circumscribed spheres give a lower bound to the collision distance
+	double sigma = 2. * _circumradius;
+	double b = r * dir;
+	double disc = b * b - (r.norm() - sigma * sigma);
+	if(disc < 0.) return max_dist;
+	double sqrt_disc = sqrt(disc);
+	if(b + sqrt_disc < 0.) return max_dist;
+	double lambda = b - sqrt_disc;
+	if(lambda > max_dist) return max_dist;
+	if(lambda < 0.) lambda = 0.;
+
+	int p_first = p->N_int_centers - _N_vertexes;
+	int q_first = q->N_int_centers - _N_vertexes;
+	for(int k = 0; k < _N_vertexes; k++) {
+		LR_vector<number> &vp = p->int_centers[p_first + k];
+		LR_vector<number> &vq = q->int_centers[q_first + k];
+		_vertexes_p[k] = LR_vector<double>(vp.x, vp.y, vp.z);
+		_vertexes_q[k] = LR_vector<double>(vq.x, vq.y, vq.z);
+	}
+
+	// ray cast of the half-line lambda*dir against the Minkowski difference. x is always outside of it, and the
+	// simplex y approximates the part of it that is closest to x
+	LR_vector<double> x = dir * lambda;
+	LR_vector<double> y[4];
+	int n = 0;
+	LR_vector<double> v = x - _support(r, dir);
+	double scale = 4. * sigma * sigma;
+	bool advanced = false;
+	for(int iter = 0; iter < EC_MAX_ITERATIONS && v.norm() > EC_SQR_TOLERANCE * scale; iter++) {
+		LR_vector<double> w = _support(r, v);
+		double vw = v * (x - w);
+		if(vw > 0.) {
+			// the plane orthogonal to v passing through w separates x from the Minkowski difference
+			double vdir = v * dir;
+			if(vdir >= 0.) return max_dist;
+			lambda -= vw / vdir;
+			if(lambda >= max_dist) return max_dist;
+			x = dir * lambda;
+			advanced = true;
+		}
+
+		// the new support point replaces any existing copy of itself
+		bool duplicate = false;
+		for(int i = 0; i < n; i++) {
+			if((y[i] - w).norm() <= EC_SQR_TOLERANCE * scale) duplicate = true;
+		}
+		if(duplicate && vw <= 0.) break;
+		if(!duplicate) y[n++] = w;
+
+		LR_vector<double> xy[4];
+		for(int i = 0; i < n; i++) xy[i] = x - y[i];
+		int subset;
+		v = _closest_to_origin(xy, n, subset);
+		int k = 0;
+		for(int i = 0; i < n; i++) {
+			if(subset & (1 << i)) y[k++] = y[i];
+		}
+		n = k;
+		// x is contained in a full simplex: up to rounding errors, it lies on the surface of the Minkowski difference
+		if(n == 4) break;
+	}
+
+	// if the two particles are touching at the beginning, they collide only if p moves towards q
+	if(!advanced && v * dir >= 0.) return max_dist;
+
+	// we stop a bit before the contact, so that rounding errors cannot make the two particles overlap
+	LR_vector<number> box_sides = this->_Info->box->box_sides();
+	double max_side = std::max(box_sides.x, std::max(box_sides.y, box_sides.z));
+	lambda -= EC_CONTACT_MARGIN * sigma + 16. * std::numeric_limits<number>::epsilon() * max_side;
+	if(lambda < 0.) lambda = 0.;
+
+	return (number) lambda;
+}
+
+template<typename number>
+number EventChain<number>::_pair_energy_at(BaseParticle<number> *p, BaseParticle<number> *q, const LR_vector<number> &pos) {
+	LR_vector<number> old_pos = p->pos;
+	p->pos = pos;
+	number energy = this->_Info->interaction->pair_interaction_nonbonded(p, q);
+	p->pos = old_pos;
+	if(this->_Info->interaction->get_is_infinite()) {
+		this->_Info->interaction->set_is_infinite(false);
+		energy = (number) 1.e12;
+	}
+	return energy;
+}
+
+template<typename number>
+number EventChain<number>::_soft_event_distance(BaseParticle<number> *p, BaseParticle<number> *q, const LR_vector<number> &e, number max_dist) {
+	// the pair energy is zero if the particles never get closer than the cutoff
+	number rcut = this->_Info->interaction->get_rcut();
+	LR_vector<number> r = this->_Info->box->min_image(p, q);
+	number b = r * e;
+	number disc = b * b - (r.norm() - rcut * rcut);
+	if(disc < (number) 0.f || b + sqrt(disc) < (number) 0.f) return max_dist;
+
+	// the increase of the pair energy that makes the filter reject the move
+	number threshold = -log(this->_rand()) * this->_T;
+	number increase = (number) 0.f;
+	number E_prev = _pair_energy_at(p, q, p->pos);
+
+	int N_steps = (int) ceil(max_dist / _soft_resolution);
+	number s_prev = (number) 0.f;
+	for(int k = 1; k <= N_steps; k++) {
+		number s = (k == N_steps) ? max_dist : k * _soft_resolution;
+		number E = _pair_energy_at(p, q, p->pos + e * s);
+		number dE = E - E_prev;
+		if(dE > (number) 0.f && increase + dE >= threshold) {
+			// the threshold is crossed in (s_prev, s]: we find where by bisection, assuming the energy grows in between
+			number target = E_prev + threshold - increase;
+			number lo = s_prev, hi = s;
+			for(int i = 0; i < 30; i++) {
+				number mid = (number) 0.5f * (lo + hi);
+				if(_pair_energy_at(p, q, p->pos + e * mid) < target) lo = mid;
+				else hi = mid;
+			}
+			return lo;
+		}
+		if(dE > (number) 0.f) increase += dE;
+		E_prev = E;
+		s_prev = s;
+	}
+
+	return max_dist;
+}
+
+template<typename number>
+void EventChain<number>::apply(llint curr_step) {
+	this->_attempted += 1;
+
+	LR_vector<number> e((number) 0.f, (number) 0.f, (number) 0.f);
+	e[(int) (this->_rand() * 3)] = (number) 1.f;
+
+	BaseParticle<number> *p = this->_Info->particles[(int) (this->_rand() * (*this->_Info->N))];
+	number max_step = _max_step();
+	number remaining = _chain_length;
+	int N_zero_events = 0;
+	// the particle that has passed the chain on to p. Since both move along e, p cannot hit it, and skipping it avoids
+	// endless zero-length events between pairs that already overlap (e.g. because of moves that use approximate overlap
+	// checks)
+	BaseParticle<number> *prev = NULL;
+	while(remaining > (number) 0.f) {
+		number step = (remaining < max_step) ? remaining : max_step;
+		BaseParticle<number> *next = NULL;
+
+		_cells->fill_cell_neighbours(p, this->_neighs, _cell_layers);
+		for(unsigned int n = 0; n < this->_neighs.size(); n++) {
+			BaseParticle<number> *q = this->_neighs[n];
+			if(q != prev) {
+				number dist = _collision_distance(p, q, e, step);
+				if(dist < step) {
+					step = dist;
+					next = q;
+				}
+			}
+			if(_soft_resolution > (number) 0.f) {
+				number dist = _soft_event_distance(p, q, e, step);
+				if(dist < step) {
+					step = dist;
+					next = q;
+				}
+			}
+		}
+
+		p->pos += e * step;
+		this->_Info->lists->single_update(p);
+		remaining -= step;
+
+		if(next != NULL) {
+			_N_events++;
+			if(step > (number) 0.f) N_zero_events = 0;
+			else if(++N_zero_events > EC_MAX_ZERO_EVENTS) {
+				_N_stuck_chains++;
+				break;
+			}
+			prev = p;
+			p = next;
+		}
+	}
+
+	this->_accepted += 1;
+}
+
+template<typename number>
+void EventChain<number>::log_parameters() {
+	BaseMove<number>::log_parameters();
+	OX_LOG(Logger::LOG_INFO, "\tchain_length = %g", _chain_length);
+	OX_LOG(Logger::LOG_INFO, "\tN_vertexes = %d", _N_vertexes);
+	OX_LOG(Logger::LOG_INFO, "\tsoft_resolution = %g", _soft_resolution);
+	if(this->_attempted > 0) OX_LOG(Logger::LOG_INFO, "\tevents per chain = %g", _N_events / (double) this->_attempted);
+	if(_N_stuck_chains > 0) OX_LOG(Logger::LOG_WARNING, "\t%lld chains have been stopped early because they got stuck", _N_stuck_chains);
+}
+
+template class EventChain<float>;
+template class EventChain<double>;
@@ -0,0 +1,91 @@
+/**
+ * @file    EventChain.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef EVENTCHAIN_H_
+#define EVENTCHAIN_H_
+#define MCMOVE_CUSTOM
+
+#include "../../../../../src/Backends/MCMoves/BaseMove.h"
+
+/**
+ * @brief Straight event-chain Monte Carlo (Bernard, Krauth and Wilson, PRE 80, 056704 (2009)) for hard convex polyhedra.
+ *
+ * Each application of the move picks a random particle and one of the three positive directions of the box, and
+ * translates the particle along it until it hits another particle, which is then moved along the same direction, and so
+ * on until the total displacement equals chain_length. The collision distances are computed exactly by casting a ray
+ * against the Minkowski difference of the two polyhedra (G. van den Bergen, "Ray casting against general convex objects
+ * with application to continuous collision detection", 2004). The polyhedra are the convex hulls of the last N_vertexes
+ * interaction centres of each particle, which are the vertexes of both Icosahedron (HardIco) and PatchyShapeParticle
+ * (PatchyShapeInteraction with shape = icosahedron) particles.
+ *
+ * The move only translates particles, and hence it has to be combined with moves that rotate them. If soft_resolution
+ * is larger than zero, the non-bonded pair energies are taken into account with the factorised Metropolis filter
+ * (Michel, Kapfer and Krauth, JCP 140, 054116 (2014)): the increase of each pair energy along the chain is integrated
+ * numerically with the given resolution, and the chain is passed on to a particle when the increase exceeds a random
+ * threshold. Since the energy is only evaluated every soft_resolution along the chain, the sampling is accurate to
+ * O(soft_resolution): barriers narrower than that can be missed. The factorised filter requires pair energies that do not
+ * depend on the rest of the system, and the chain does not update the patch locks, so the move cannot be used with
+ * PatchyShapeInteraction and no_multipatch = true. soft_resolution = 0 (hard polyhedra) is only allowed with
+ * HardIcoInteraction, and an exception is thrown in both cases. External forces are not supported.
+ *
+ * The particles that can be hit are looked for in the cells of the simulation list (list_type = cells is required). Since
+ * these are only slightly larger than the particles, the move looks as many layers of cells around the moving particle
+ * as are needed to cover the whole chain_length plus the diameter of the circumscribed sphere (or the interaction
+ * cutoff, if soft_resolution > 0 and it is larger), up to half of the box. If the box is too small for that, the chain
+ * is split in shorter displacements, each followed by a new search of the neighbours, and a warning is printed.
+ *
+ * @verbatim
+type = EventChain
+chain_length = <float> (total displacement of each chain)
+[N_vertexes = <int> (number of vertexes of each polyhedron, defaults to 12)]
+[soft_resolution = <float> (resolution used to integrate the pair energies along the chain, defaults to 0, i.e. hard polyhedra, which is only allowed with HardIcoInteraction)]
+@endverbatim
+ */
+template<typename number>
+class EventChain : public BaseMove<number> {
+	protected:
+		number _chain_length;
+		int _N_vertexes;
+		number _soft_resolution;
+
+		/// radius of the sphere circumscribed to the polyhedra
+		number _circumradius;
+		Cells<number> *_cells;
+		/// number of layers of cells around the moving particle in which its neighbours are looked for
+		int _cell_layers;
+
+		llint _N_events;
+		llint _N_stuck_chains;
+
+		/// vertexes of the two polyhedra whose collision distance is being computed, in the reference frame of the first one
+		std::vector<LR_vector<double> > _vertexes_p, _vertexes_q;
+
+		/// sets _cell_layers and returns the largest displacement that can be done without updating the neighbours of the moving particle
+		number _max_step();
+		LR_vector<double> _support(const LR_vector<double> &r, const LR_vector<double> &d);
+		/// returns the distance p can travel along e before hitting q, or max_dist if it is larger than max_dist
+		number _collision_distance(BaseParticle<number> *p, BaseParticle<number> *q, const LR_vector<number> &e, number max_dist);
+		number _pair_energy_at(BaseParticle<number> *p, BaseParticle<number> *q, const LR_vector<number> &pos);
+		/// returns the distance p can travel along e before the factorised Metropolis filter of the pair (p, q) rejects the move, or max_dist
+		number _soft_event_distance(BaseParticle<number> *p, BaseParticle<number> *q, const LR_vector<number> &e, number max_dist);
+
+	public:
+		EventChain();
+		virtual ~EventChain();
+
+		void apply (llint curr_step);
+		virtual void get_settings(input_file &inp, input_file &sim_inp);
+		virtual void init();
+		virtual void log_parameters();
+};
+
+
+extern "C" BaseMove<float> * make_EventChain_float()   { return new EventChain<float> () ; }
+extern "C" BaseMove<double> * make_EventChain_double() {return new EventChain<double> () ; }
+
+#endif // EventChain.h
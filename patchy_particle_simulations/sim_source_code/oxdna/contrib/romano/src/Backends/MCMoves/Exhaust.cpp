@@ -9,6 +9,7 @@
 /// traslation
 template<typename number>
 Exhaust<number>::Exhaust (){
+	this->_step_sizes.push_back(&_delta);
 	_delta = (number) -1.f;
 	_poss_old = std::vector<LR_vector<number> > ();
 	_clust = std::vector<BaseParticle<number> *> ();
@@ -49,11 +50,11 @@ void Exhaust<number>::apply (llint curr_step) {
 	this->_attempted += 1;
 
 	// we select the particle to translate
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * p = this->_Info->particles[pi];
 	if (this->_restrict_to_type >= 0) {
 		while(p->type != this->_restrict_to_type) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 			p = this->_Info->particles[pi];
 		}
 	}
@@ -167,7 +168,7 @@ void Exhaust<number>::apply (llint curr_step) {
 	// accept or reject?
 	if (outright_reject == false &&
 		this->_Info->interaction->get_is_infinite() == false &&
-		((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48()) ) {
+		((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand()) ) {
 		// move accepted
         this->_accepted ++;
 
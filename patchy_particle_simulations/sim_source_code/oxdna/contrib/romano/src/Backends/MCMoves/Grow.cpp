@@ -66,10 +66,10 @@ void Grow<number>::apply (llint curr_step) {
 	if (pit == _particles_to_grow.end()) throw oxDNAException("merda");
 	int pi = *pit;
 	/*
-	int pi = (int) (drand48() * (_particles_to_grow.size()));
+	int pi = (int) (this->_rand() * (_particles_to_grow.size()));
 	if (this->_restrict_to_type >= 0) {
 		while(this->_Info->particles[pi]->type != this->_restrict_to_type || _grown[pi] == true) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 		}
 	}
 	*/
@@ -124,7 +124,7 @@ void Grow<number>::apply (llint curr_step) {
 	delta_E_ext += p->ext_potential;
 
 	// accept or reject?
-	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48() )) {
+	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand() )) {
 		// move accepted
         this->_accepted ++;
 		if (s->length >= _target_sigma) _particles_to_grow.erase(pi);
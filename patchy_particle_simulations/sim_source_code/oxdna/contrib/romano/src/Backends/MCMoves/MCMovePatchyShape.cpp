@@ -7,12 +7,17 @@
  */
 #include "MCMovePatchyShape.h"
 
+#include <algorithm>
+
 /// traslation
 template<typename number>
 MCMovePatchyShape<number>::MCMovePatchyShape (){
+	this->_step_sizes.push_back(&_delta);
 	pos_old = LR_vector<number> (0., 0., 0.);
 
 	_verlet_skin = -1.f;
+	_check_locks_every = 0;
+	_check_locks_N = 10;
 }
 
 template<typename number>
@@ -35,6 +40,8 @@ void MCMovePatchyShape<number>::get_settings (input_file &inp, input_file &sim_i
 
 	getInputNumber (&inp, "delta_translation", &_delta, 1);
 	getInputNumber (&inp, "delta_rotation", &_delta_rotation, 1);
+	getInputLLInt(&inp, "check_locks_every", &_check_locks_every, 0);
+	getInputInt(&inp, "check_locks_N", &_check_locks_N, 0);
 
 	OX_LOG(Logger::LOG_INFO, "(MCMovePatchyShape.cpp) MCMoveShapeParticle initiated with T %g, delta_translation %g, delta_rotation %g, prob: %g", this->_T, _delta,_delta_rotation, this->prob);
 	
@@ -47,21 +54,6 @@ void MCMovePatchyShape<number>::get_settings (input_file &inp, input_file &sim_i
 }
 
 
-struct lock
-{
-	int pid;
-	int ppatchid;
-	int qid;
-	int qpatchid;
-
-	lock(int _pid, int _qid, int plockid, int qlockid) : pid(_pid),  ppatchid(plockid), qid(_qid), qpatchid(qlockid) {}
-
-	bool operator == (lock &b)
-	{
-		return bool( (pid == b.pid && ppatchid == b.ppatchid && qid == b.qid && qpatchid == b.qpatchid ) || (qid == b.pid && qpatchid == b.ppatchid && pid == b.qid && ppatchid == b.qpatchid ) );
-	}
-};
-
 template<typename number>
 void MCMovePatchyShape<number>::apply (llint curr_step) {
 
@@ -69,7 +61,7 @@ void MCMovePatchyShape<number>::apply (llint curr_step) {
 	this->_attempted += 1;
 
 	// we select the particle to translate
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = this->_random_particle();
 
 	//cout << "GGB " << this->_Info->particles << endl;;
 
@@ -82,23 +74,36 @@ void MCMovePatchyShape<number>::apply (llint curr_step) {
 	_orientationT_old = p->orientationT;
 
 	// compute the energy before the move
-	number delta_E = -this->particle_energy(p);
+	number delta_E;
+	if(this->_energy_cache != NULL) {
+		delta_E = -this->_cached_particle_energy(p, _old_terms);
+		// the energy of p stays valid unless the move is accepted
+		if(!this->_energy_cache->is_valid(p->index)) this->_energy_cache->set(p->index, _old_terms);
+	}
+	else delta_E = -this->particle_energy(p);
 	p->set_ext_potential (curr_step, this->_Info->box);
 	number delta_E_ext = -p->ext_potential;
 
 	//printf("Before suggesting move: delta_E = %f, pos = %g %g %g \n",delta_E,p->pos.x,p->pos.y,p->pos.z);
 	//printf("Using delta_trans: %g  delta_rot %g" ,_delta,_delta_rotation);
 	// perform the move
-	if(drand48() < 0.5) // translation
+	if(this->_rand() < 0.5) // translation
 	{
-	 p->pos.x += 2. * (drand48() - (number)0.5f) * _delta;
-	 p->pos.y += 2. * (drand48() - (number)0.5f) * _delta;
-	 p->pos.z += 2. * (drand48() - (number)0.5f) * _delta;
+	 p->pos.x += 2. * (this->_rand() - (number)0.5f) * _delta;
+	 p->pos.y += 2. * (this->_rand() - (number)0.5f) * _delta;
+	 p->pos.z += 2. * (this->_rand() - (number)0.5f) * _delta;
+
+	 // during checkerboard sweeps particles cannot leave their domain
+	 if(!this->_in_domain(p)) {
+		 p->pos = pos_old;
+		 if (this->_adjust_now(curr_step)) _delta /= this->_rej_fact;
+		 return;
+	 }
 	}
 	else { //rotation
 
-		number t = drand48() * _delta_rotation;
-		LR_vector<number> axis = Utils::get_random_vector<number>();
+		number t = this->_rand() * _delta_rotation;
+		LR_vector<number> axis = this->_random_vector();
 
 		number sintheta = sin(t);
 		number costheta = cos(t);
@@ -124,80 +129,63 @@ void MCMovePatchyShape<number>::apply (llint curr_step) {
 	this->_Info->lists->single_update(p);
 	if(!this->_Info->lists->is_updated()) {
 		this->_Info->lists->global_update();
+		// the neighbours may now be visited in a different order, which would change the energies in the last digits
+		if(this->_energy_cache != NULL) this->_energy_cache->invalidate_all();
 	}
 
-	//vector< Patch<number>  > broken_locks;
-	vector<lock> locks_to_restore; //this is a list of locks that will be rejected
-    vector<lock> locks_to_break;
 	PatchyShapeInteraction<number> *interaction = static_cast<PatchyShapeInteraction<number> *  >(this->_Info->interaction);
+	PatchyBondGraph &bonds = interaction->get_bond_graph();
+	// from now on, all the changes to the locks are undone if the move gets rejected
+	bonds.begin();
+	_broken_locks.clear();
 
-	//printf("After suggesting mov and fucking: , delta_E = %f, pos = %g %g %g \n",delta_E,p->pos.x,p->pos.y,p->pos.z);
 	for(int i = 0; i < p->N_patches; i++) {
-		if(p->patches[i].is_locked()) {
+		if(bonds.is_locked(p->index, i)) {
 			int qid=-1, qpatch=-1;
-			p->patches[i].get_lock(qid,qpatch);
-			assert(qid >= 0);  assert(qpatch >= 0 && qpatch < 6);
+			bonds.get_lock(p->index,i,qid,qpatch);
 			PatchyShapeParticle<number> *q = static_cast< PatchyShapeParticle<number> *>(this->_Info->particles[qid]);
 			LR_vector<number> r = this->_Info->box->min_image(p,q);
 			number new_ene = interaction->just_two_patch_interaction(p,q,i,qpatch,&r);
 			//printf("I am particle %d, patch %d, locked to %d %d (new energy %g), cutoff %f\n",p->index,i,qid,qpatch, new_ene,interaction->get_patch_cutoff_energy() );
-			//if ( new_ene < -0.1 ) throw oxDNAException("it actually happens");
 			if ( ! (new_ene < interaction->get_patch_cutoff_energy()) ) //we break the lock
 			{
-
 				//printf("I am particle %d breaking lock %d with %d (%d) \n",p->index,i,qid,qpatch);
-				// broken_locks.push_back(p->patches[i]);
-				p->patches[i].unlock();
-				q->patches[qpatch].unlock();
-				locks_to_restore.push_back(  lock(p->index,q->index,i,qpatch));
-				//throw oxDNAException("here...");
+				bonds.unlock(p->index, i);
+				_broken_locks.push_back(PatchyBond(p->index, i, qid, qpatch));
 			}
 		}
 	}
 
 	// energy after the move
-	delta_E += this->particle_energy(p);
+	if(this->_energy_cache != NULL) delta_E += this->_particle_energy_terms(p, _new_terms);
+	else delta_E += this->particle_energy(p);
 	p->set_ext_potential(curr_step, this->_Info->box);
 	delta_E_ext += p->ext_potential;
 
 	number delta_E_newlocks = 0.f;
 
-	for(vector<lock>::iterator i = locks_to_restore.begin(); i != locks_to_restore.end(); ++i)
+	// the patches of the particles that p was bound to are now free, and may bind to someone else
+	for(std::vector<PatchyBond>::iterator i = _broken_locks.begin(); i != _broken_locks.end(); ++i)
 	{
-		//i->locked_to(qid,qpatch);
-		// we use the locks_to_restore array just to get the indexes 
-		// of the particles (and patches) to check
-		int qid = i->qid;
-		int qpatch = i->qpatchid;
+		int qid = i->q;
+		int qpatch = i->q_patch;
 
 		PatchyShapeParticle<number> *q = static_cast< PatchyShapeParticle<number> *>(this->_Info->particles[qid]);
-		std::vector<BaseParticle<number> *> neighs = this->_Info->lists->get_neigh_list(q);
+		std::vector<BaseParticle<number> *> &neighs = this->_neighs;
+		this->_Info->lists->fill_neigh_list(q, neighs);
 		for(unsigned int n = 0; n < neighs.size(); n++) {
 			PatchyShapeParticle<number> *qq =   static_cast< PatchyShapeParticle<number> *>(neighs[n]);
 			LR_vector<number> r = this->_Info->box->min_image(q,qq);
 			for(int qqpatch = 0; qqpatch < qq->N_patches; qqpatch++)
 			{
+				// this lock has been set while looking at the neighbours of qq, and hence it has already been counted
+				if(bonds.locked_to(qid,qpatch,qq->index,qqpatch)) continue;
+
 				number new_ene = interaction->just_two_patch_interaction(q,qq,qpatch,qqpatch,&r);
 				if(new_ene < interaction->get_patch_cutoff_energy())
 				{
-					q->patches[qpatch].set_lock(qq->index,qqpatch);
-					qq->patches[qqpatch].set_lock(qid,qpatch);
-					//make sure the lock is not counted before
-					lock newlock =  lock(q->index,qq->index,qpatch,qqpatch);
-					bool known = false;
-					for(vector<lock>::iterator it = locks_to_break.begin(); it != locks_to_break.end(); it++)
-					{
-						if(*it == newlock)
-						{
-							known = true;
-							break;
-						}
-					}
-					if (! known)
-					{
-					  delta_E_newlocks += new_ene;
-					  locks_to_break.push_back(newlock);
-					}
+					bonds.lock(qid,qpatch,qq->index,qqpatch);
+					delta_E_newlocks += new_ene;
 				}
 			}
 		}
@@ -205,12 +193,13 @@ void MCMovePatchyShape<number>::apply (llint curr_step) {
 
 	//printf("After suggesting move: delta_E_newlocks: %f , delta_E = %f, pos = %g %g %g \n",delta_E_newlocks,delta_E,p->pos.x,p->pos.y,p->pos.z);
 	// accept or reject?
-	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext + delta_E_newlocks) < 0 || exp(-(delta_E + delta_E_ext+delta_E_newlocks) / this->_T) > drand48() )) {
+	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext + delta_E_newlocks) < 0 || exp(-(delta_E + delta_E_ext+delta_E_newlocks) / this->_T) > this->_rand() )) {
 		// move accepted
         //printf("Move accepted\n");
 		this->_accepted ++;
 		//We need to make new locks for p
-		std::vector<BaseParticle<number> *> neighs = this->_Info->lists->get_neigh_list(p);
+		std::vector<BaseParticle<number> *> &neighs = this->_neighs;
+		this->_Info->lists->fill_neigh_list(p, neighs);
 		for(unsigned int n = 0; n < neighs.size(); n++) {
 			PatchyShapeParticle<number> *qq = static_cast< PatchyShapeParticle<number> *>(neighs[n]);
 			LR_vector<number> r = this->_Info->box->min_image(p,qq);
@@ -221,16 +210,17 @@ void MCMovePatchyShape<number>::apply (llint curr_step) {
 					number new_ene = interaction->just_two_patch_interaction(p,qq,ppatch,qqpatch,&r);
 					if(new_ene < interaction->get_patch_cutoff_energy())
 					{
-						p->patches[ppatch].set_lock(qq->index,qqpatch);
-						qq->patches[qqpatch].set_lock(p->index,ppatch);
+						bonds.lock(p->index,ppatch,qq->index,qqpatch);
 						// printf("setting lock %d (%d) %d (%d) \n",p->index,ppatch,qq->index,qqpatch);
 
 					}
 				}
 			}
 		}
+		if(this->_energy_cache != NULL) _update_energies(p, bonds);
+		bonds.commit();
 
-		if (curr_step < this->_equilibration_steps && this->_adjust_moves) {
+		if (this->_adjust_now(curr_step)) {
 			_delta *= this->_acc_fact;
 			if (_verlet_skin > 0. && _delta > _verlet_skin * 0.8660254037844386 / 2.) {
 				_delta = _verlet_skin *_verlet_skin * 0.8660254037844386 / 2.; //  0.8660254 .. ==sqrt(3.) / 2.
@@ -240,22 +230,7 @@ void MCMovePatchyShape<number>::apply (llint curr_step) {
 	else {
 		//printf("Move rejected\n");
 		//rejected; We need to fix locks that were broken or created
-		for (vector<lock>::iterator i = locks_to_break.begin(); i != locks_to_break.end(); ++i)
-		{
-			PatchyShapeParticle<number> *pp = static_cast< PatchyShapeParticle<number> *>(this->_Info->particles[i->pid]);
-			PatchyShapeParticle<number> *qq = static_cast< PatchyShapeParticle<number> *>(this->_Info->particles[i->qid]);
-			pp->patches[i->ppatchid].unlock();
-			qq->patches[i->qpatchid].unlock();
-			//printf("unsetting lock %d %d %d %d \n",pp->index,i->ppatchid,qq->index,i->qpatchid);
-		}
-		for (vector<lock>::iterator i = locks_to_restore.begin(); i != locks_to_restore.end(); ++i)
-		{
-			PatchyShapeParticle<number> *pp = static_cast< PatchyShapeParticle<number> *>(this->_Info->particles[i->pid]);
-			PatchyShapeParticle<number> *qq = static_cast< PatchyShapeParticle<number> *>(this->_Info->particles[i->qid]);
-			pp->patches[i->ppatchid].set_lock(i->qid,i->qpatchid);
-			qq->patches[i->qpatchid].set_lock(i->pid,i->ppatchid);
-			//printf("restoring lock %d %d %d %d \n",pp->index,i->ppatchid,qq->index,i->qpatchid);
-		}
+		bonds.rollback();
 
 		this->_Info->particles[pi]->pos = pos_old;
 		p->orientation = _orientation_old;
@@ -265,17 +240,42 @@ void MCMovePatchyShape<number>::apply (llint curr_step) {
 		this->_Info->lists->single_update(p);
 		this->_Info->interaction->set_is_infinite(false);
 
-		if (curr_step < this->_equilibration_steps && this->_adjust_moves) _delta /= this->_rej_fact;
+		if (this->_adjust_now(curr_step)) _delta /= this->_rej_fact;
 	}
 
-	//perform check
-	if(3>4 && curr_step % 10000  == 0)
+	//perform check. Other threads may be changing the locks during checkerboard sweeps
+	if(_check_locks_every > 0 && (this->_attempted % _check_locks_every) == 0)
 	{
-		interaction->check_patchy_locks();
-		//printf("all good\n");
+#ifdef HAVE_OPENMP
+		if(!omp_in_parallel())
+#endif
+		interaction->check_patchy_locks(this->_Info, _check_locks_N);
 	}
 	return;
 }
 
+template<typename number>
+void MCMovePatchyShape<number>::adjust(llint curr_step, llint accepted, llint rejected) {
+	BaseMove<number>::adjust(curr_step, accepted, rejected);
+	if (_verlet_skin > 0. && _delta > _verlet_skin * 0.8660254037844386 / 2.) {
+		_delta = _verlet_skin *_verlet_skin * 0.8660254037844386 / 2.; //  0.8660254 .. ==sqrt(3.) / 2.
+	}
+}
+
+template<typename number>
+void MCMovePatchyShape<number>::_update_energies(PatchyShapeParticle<number> *p, PatchyBondGraph &bonds) {
+	// the contributions of p to the energies of the particles it interacted with before the move and of the ones it interacts with now
+	for(unsigned int i = 0; i < _old_terms.size(); i++) this->_energy_cache->update(_old_terms[i].first, p->index, (number) 0.f);
+	for(unsigned int i = 0; i < _new_terms.size(); i++) this->_energy_cache->update(_new_terms[i].first, p->index, _new_terms[i].second);
+	this->_energy_cache->set(p->index, _new_terms);
+
+	// a patch that has been locked or unlocked changes the interactions of its particle with all the neighbours
+	_changed.clear();
+	bonds.get_changed_particles(_changed);
+	std::sort(_changed.begin(), _changed.end());
+	_changed.erase(std::unique(_changed.begin(), _changed.end()), _changed.end());
+	for(unsigned int i = 0; i < _changed.size(); i++) this->_invalidate_energy(this->_Info->particles[_changed[i]]);
+}
+
 template class MCMovePatchyShape<float>;
 template class MCMovePatchyShape<double>;
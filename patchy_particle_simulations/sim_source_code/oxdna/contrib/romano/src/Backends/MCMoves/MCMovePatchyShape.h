@@ -14,6 +14,16 @@
 #include "../../Interactions/PatchyShapeInteraction.h"
 #include "../../Particles/PatchyShapeParticle.h"
 
+/**
+ * @brief Roto-translation of a single PatchyShapeParticle that keeps the patch locks up to date.
+ *
+ * @verbatim
+delta_translation = <float> (maximum displacement)
+delta_rotation = <float> (maximum rotation angle)
+[check_locks_every = <int> (if larger than 0, the locks are checked every this many attempted moves, see PatchyShapeInteraction::check_patchy_locks. Checks are skipped during checkerboard sweeps. Defaults to 0)]
+[check_locks_N = <int> (number of particles, picked at random, whose locks are checked. If negative all the locks are checked, which takes O(N) time. Defaults to 10)]
+@endverbatim
+ */
 template<typename number>
 class MCMovePatchyShape : public BaseMove<number> {
 	protected:
@@ -24,6 +34,18 @@ class MCMovePatchyShape : public BaseMove<number> {
 		LR_vector<number> pos_old;
 
 		number _verlet_skin;
+
+		llint _check_locks_every;
+		int _check_locks_N;
+
+		/// locks broken by the current move, whose patches may bind to someone else
+		std::vector<PatchyBond> _broken_locks;
+		/// contributions to the energy of the moved particle before and after the move, and particles whose locks have been changed by the move. They are used to keep the energy cache up to date
+		typename EnergyTerms<number>::type _old_terms, _new_terms;
+		std::vector<int> _changed;
+
+		/// updates the cached energies after an accepted move. It must be called before the locks are committed
+		void _update_energies(PatchyShapeParticle<number> *p, PatchyBondGraph &bonds);
 	
 	public:
 		MCMovePatchyShape();
@@ -32,6 +54,15 @@ class MCMovePatchyShape : public BaseMove<number> {
 		void apply (llint curr_step);
 		virtual void get_settings(input_file &inp, input_file &sim_inp);
 		virtual void init(void);
+		/// on top of the adaptation done by BaseMove, the translation step is capped as it is after each accepted move
+		virtual void adjust(llint curr_step, llint accepted, llint rejected);
+
+		/// the move acts on a single particle and changes only the locks of its neighbours and of their neighbours
+		virtual bool is_local() { return true; }
+		/// the cached energies of the neighbours of the particles whose locks have been changed are invalidated, and hence the cache extends the range by one cell
+		virtual int cell_range() { return (this->_energy_cache != NULL) ? 3 : 2; }
+		/// the energy of the moved particle is taken from the cache, and the locks changed by the move tell which cached energies have to be invalidated
+		virtual bool supports_energy_cache() { return true; }
 
 };
 
@@ -85,11 +85,11 @@ void NDepletion<number>::apply (llint curr_step) {
 	this->_attempted += 1;
 
 	// we select the target particle
-	int pti = (int) (drand48() * (*this->_Info->N));
+	int pti = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * pt = this->_Info->particles[pti];
 	if (this->_restrict_to_type >= 0) {
 		while(pt->type != this->_restrict_to_type) {
-			pti = (int) (drand48() * (*this->_Info->N));
+			pti = (int) (this->_rand() * (*this->_Info->N));
 			pt = this->_Info->particles[pti];
 		}
 	}
@@ -103,7 +103,7 @@ void NDepletion<number>::apply (llint curr_step) {
 	//}
 
 	// we select the particle to move
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * p = this->_Info->particles[pi];
 
 	if (target_neighs.size() == 0) {
@@ -116,17 +116,17 @@ void NDepletion<number>::apply (llint curr_step) {
 		pi = p->index;
 	}
 	else {
-		pi = (int) (drand48() * (target_neighs.size()));
+		pi = (int) (this->_rand() * (target_neighs.size()));
 		p = target_neighs[pi];
 		while (p == pt) {
 			if (this->_restrict_to_type >= 0) {
 				while(p->type != this->_restrict_to_type) {
-					pi = (int) (drand48() * (target_neighs.size()));
+					pi = (int) (this->_rand() * (target_neighs.size()));
 					p = target_neighs[pi];
 				}
 			}
 			else {
-				pi = (int) (drand48() * (target_neighs.size()));
+				pi = (int) (this->_rand() * (target_neighs.size()));
 				p = target_neighs[pi];
 			}
 		}
@@ -218,12 +218,12 @@ void NDepletion<number>::apply (llint curr_step) {
 		// free volume before the move;
 		int ntry = 0, nfv = 0;
 		while (ntry < _ntries) {
-			number dx = 2.*drand48() - 1.; // between -1 and 1
-			number dy = 2.*drand48() - 1.; // between -1 and 1
-			number dz = drand48() - 0.5;   // between -0.5 and 0.5;
+			number dx = 2.*this->_rand() - 1.; // between -1 and 1
+			number dy = 2.*this->_rand() - 1.; // between -1 and 1
+			number dz = this->_rand() - 0.5;   // between -0.5 and 0.5;
 			while (dx*dx + dy*dy >= 1.) {
-				dx = 2.*drand48() - 1.;
-				dy = 2.*drand48() - 1.;
+				dx = 2.*this->_rand() - 1.;
+				dy = 2.*this->_rand() - 1.;
 			}
 			dx = dx * (0.5 + _sigma_dep);
 			dy = dy * (0.5 + _sigma_dep);
@@ -262,12 +262,12 @@ void NDepletion<number>::apply (llint curr_step) {
 		ntry = 0;
 		nfv = 0;
 		while (ntry < _ntries) {
-			number dx = 2.*drand48() - 1.; // between -1 and 1
-			number dy = 2.*drand48() - 1.; // between -1 and 1
-			number dz = drand48() - 0.5;   // between -0.5 and 0.5;
+			number dx = 2.*this->_rand() - 1.; // between -1 and 1
+			number dy = 2.*this->_rand() - 1.; // between -1 and 1
+			number dz = this->_rand() - 0.5;   // between -0.5 and 0.5;
 			while (dx*dx + dy*dy >= 1.) {
-				dx = 2.*drand48() - 1.;
-				dy = 2.*drand48() - 1.;
+				dx = 2.*this->_rand() - 1.;
+				dy = 2.*this->_rand() - 1.;
 			}
 			dx = dx * (0.5 + _sigma_dep);
 			dy = dy * (0.5 + _sigma_dep);
@@ -311,7 +311,7 @@ void NDepletion<number>::apply (llint curr_step) {
 
 		f = 1./f;
 
-		if (f >= (number) 1.f || f > drand48()) depletion_accept = true;
+		if (f >= (number) 1.f || f > this->_rand()) depletion_accept = true;
 		else depletion_accept = false;
 	}
 
@@ -321,7 +321,7 @@ void NDepletion<number>::apply (llint curr_step) {
 	// accept or reject?
 	if (this->_Info->interaction->get_is_infinite() == false &&
 		depletion_accept == true &&
-		((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48()) ) {
+		((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand()) ) {
 		// move accepted
         this->_accepted ++;
 
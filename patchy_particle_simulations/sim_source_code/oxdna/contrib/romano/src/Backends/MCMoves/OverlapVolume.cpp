@@ -78,11 +78,11 @@ void OverlapVolume<number>::apply (llint curr_step) {
 	_orientation_old = p->orientation;
 	_orientationT_old = p->orientationT;
 
-	p->pos.x = 2. * (drand48() - 0.5) * _rmax;
-	p->pos.y = 2. * (drand48() - 0.5) * _rmax;
-	p->pos.z = 2. * (drand48() - 0.5) * _rmax;
+	p->pos.x = 2. * (this->_rand() - 0.5) * _rmax;
+	p->pos.y = 2. * (this->_rand() - 0.5) * _rmax;
+	p->pos.z = 2. * (this->_rand() - 0.5) * _rmax;
 
-	number t = drand48() * M_PI;
+	number t = this->_rand() * M_PI;
 	LR_vector<number> axis = Utils::get_random_vector<number>();
 
 	number sintheta = sin(t);
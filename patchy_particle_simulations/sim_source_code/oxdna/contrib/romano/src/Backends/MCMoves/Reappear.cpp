@@ -36,11 +36,11 @@ void Reappear<number>::apply (llint curr_step) {
 	this->_attempted += 1;
 
 	// we select the particle to translate
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * p = this->_Info->particles[pi];
 	if (this->_restrict_to_type >= 0) {
 		while(p->type != this->_restrict_to_type) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 			p = this->_Info->particles[pi];
 		}
 	}
@@ -56,9 +56,9 @@ void Reappear<number>::apply (llint curr_step) {
 
 	// perform the move
 	LR_vector<number> sides = this->_Info->box->box_sides();
-	p->pos.x = drand48() * sides[0];
-	p->pos.y = drand48() * sides[1];
-	p->pos.z = drand48() * sides[2];
+	p->pos.x = this->_rand() * sides[0];
+	p->pos.y = this->_rand() * sides[1];
+	p->pos.z = this->_rand() * sides[2];
 
 	// update lists
 	this->_Info->lists->single_update(p);
@@ -72,7 +72,7 @@ void Reappear<number>::apply (llint curr_step) {
 	delta_E_ext += p->ext_potential;
 
 	// accept or reject?
-	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48() )) {
+	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand() )) {
 		// move accepted
         this->_accepted ++;
 
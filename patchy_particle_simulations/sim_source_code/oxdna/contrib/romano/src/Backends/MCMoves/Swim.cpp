@@ -9,6 +9,7 @@
 /// traslation
 template<typename number>
 Swim<number>::Swim (){
+	this->_step_sizes.push_back(&_delta);
 	pos_old = LR_vector<number> (0., 0., 0.);
 	_delta = (number) -1.f;
 	_axis_i = -1;
@@ -51,11 +52,11 @@ void Swim<number>::apply (llint curr_step) {
 	this->_attempted += 1;
 
 	// we select the particle to translate
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> * p = this->_Info->particles[pi];
 	if (this->_restrict_to_type >= 0) {
 		while(p->type != this->_restrict_to_type) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 			p = this->_Info->particles[pi];
 		}
 	}
@@ -70,7 +71,7 @@ void Swim<number>::apply (llint curr_step) {
 	number delta_E_ext = -p->ext_potential;
 
 	// perform the move
-	p->pos += (number)((drand48() - (number)0.5f) * _delta) * (*_get_axis(p));
+	p->pos += (number)((this->_rand() - (number)0.5f) * _delta) * (*_get_axis(p));
 
 	// update lists
 	this->_Info->lists->single_update(p);
@@ -84,7 +85,7 @@ void Swim<number>::apply (llint curr_step) {
 	delta_E_ext += p->ext_potential;
 
 	// accept or reject?
-	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48() )) {
+	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand() )) {
 		// move accepted
         this->_accepted ++;
 
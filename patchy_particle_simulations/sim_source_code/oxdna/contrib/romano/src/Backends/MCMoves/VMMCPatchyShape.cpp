@@ -0,0 +1,206 @@
+/**
+ * @file    VMMCPatchyShape.cpp
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#include "VMMCPatchyShape.h"
+
+// same values as in VMMC.cpp
+#define VMMC_ROTATION (1)
+#define VMMC_TRANSLATION (2)
+
+template<typename number>
+VMMCPatchyShape<number>::VMMCPatchyShape() {
+	_interaction = NULL;
+}
+
+template<typename number>
+VMMCPatchyShape<number>::~VMMCPatchyShape() {
+
+}
+
+template<typename number>
+void VMMCPatchyShape<number>::init() {
+	VMMC<number>::init();
+
+	_interaction = dynamic_cast<PatchyShapeInteraction<number> *>(this->_Info->interaction);
+	if(_interaction == NULL) throw oxDNAException("(VMMCPatchyShape.cpp) VMMCPatchyShape can only be used with interaction_type = PatchyShapeInteraction");
+	_interaction->_init_patchy_locks();
+}
+
+template<typename number>
+void VMMCPatchyShape<number>::_restore_cluster(llint curr_step) {
+	for(unsigned int l = 0; l < this->_clust.size(); l++) {
+		BaseParticle<number> *p = this->_Info->particles[this->_clust[l]];
+		BaseParticle<number> *old = this->_particles_old[p->index];
+		p->pos = old->pos;
+		p->orientation = old->orientation;
+		p->orientationT = old->orientationT;
+		p->set_positions();
+		this->_Info->lists->single_update(p);
+		p->set_ext_potential(curr_step, this->_Info->box);
+	}
+}
+
+// tries to lock a patch that has just been freed to any free patch close enough, and returns the energy of the new lock
+template<typename number>
+number VMMCPatchyShape<number>::_lock_free_patch(int pid, int ppatch) {
+	PatchyBondGraph &bonds = _interaction->get_bond_graph();
+	if(bonds.is_locked(pid, ppatch)) return (number) 0.f;
+
+	PatchyShapeParticle<number> *p = static_cast<PatchyShapeParticle<number> *>(this->_Info->particles[pid]);
+	this->_Info->lists->fill_neigh_list(p, this->_neighs);
+	for(unsigned int n = 0; n < this->_neighs.size(); n++) {
+		PatchyShapeParticle<number> *q = static_cast<PatchyShapeParticle<number> *>(this->_neighs[n]);
+		LR_vector<number> r = this->_Info->box->min_image(p, q);
+		for(int qpatch = 0; qpatch < q->N_patches; qpatch++) {
+			number new_ene = _interaction->just_two_patch_interaction(p, q, ppatch, qpatch, &r);
+			if(new_ene < _interaction->get_patch_cutoff_energy()) {
+				bonds.lock(pid, ppatch, q->index, qpatch);
+				return new_ene;
+			}
+		}
+	}
+
+	return (number) 0.f;
+}
+
+// breaks the locks between particles of the cluster and particles outside it that have been stretched beyond the lock
+// cutoff, and returns the energy of the locks formed by the patches freed this way
+template<typename number>
+number VMMCPatchyShape<number>::_break_boundary_locks() {
+	PatchyBondGraph &bonds = _interaction->get_bond_graph();
+	_broken_locks.clear();
+
+	for(unsigned int l = 0; l < this->_clust.size(); l++) {
+		PatchyShapeParticle<number> *p = static_cast<PatchyShapeParticle<number> *>(this->_Info->particles[this->_clust[l]]);
+		for(int i = 0; i < p->N_patches; i++) {
+			if(!bonds.is_locked(p->index, i)) continue;
+			int qid = -1, qpatch = -1;
+			bonds.get_lock(p->index, i, qid, qpatch);
+			PatchyShapeParticle<number> *q = static_cast<PatchyShapeParticle<number> *>(this->_Info->particles[qid]);
+			// the cluster moves rigidly, so its internal locks are not affected
+			if(q->inclust) continue;
+
+			LR_vector<number> r = this->_Info->box->min_image(p, q);
+			number new_ene = _interaction->just_two_patch_interaction(p, q, i, qpatch, &r);
+			if(!(new_ene < _interaction->get_patch_cutoff_energy())) {
+				bonds.unlock(p->index, i);
+				_broken_locks.push_back(PatchyBond(p->index, i, qid, qpatch));
+			}
+		}
+	}
+
+	number delta_E_newlocks = (number) 0.f;
+	for(std::vector<PatchyBond>::iterator it = _broken_locks.begin(); it != _broken_locks.end(); ++it) {
+		delta_E_newlocks += _lock_free_patch(it->p, it->p_patch);
+		delta_E_newlocks += _lock_free_patch(it->q, it->q_patch);
+	}
+
+	return delta_E_newlocks;
+}
+
+// locks the patches of the particles of the cluster to the free patches they now interact with
+template<typename number>
+void VMMCPatchyShape<number>::_lock_cluster() {
+	PatchyBondGraph &bonds = _interaction->get_bond_graph();
+
+	for(unsigned int l = 0; l < this->_clust.size(); l++) {
+		PatchyShapeParticle<number> *p = static_cast<PatchyShapeParticle<number> *>(this->_Info->particles[this->_clust[l]]);
+		this->_Info->lists->fill_neigh_list(p, this->_neighs);
+		for(unsigned int n = 0; n < this->_neighs.size(); n++) {
+			PatchyShapeParticle<number> *q = static_cast<PatchyShapeParticle<number> *>(this->_neighs[n]);
+			LR_vector<number> r = this->_Info->box->min_image(p, q);
+			for(int ppatch = 0; ppatch < p->N_patches; ppatch++) {
+				for(int qpatch = 0; qpatch < q->N_patches; qpatch++) {
+					number new_ene = _interaction->just_two_patch_interaction(p, q, ppatch, qpatch, &r);
+					if(new_ene < _interaction->get_patch_cutoff_energy()) bonds.lock(p->index, ppatch, q->index, qpatch);
+				}
+			}
+		}
+	}
+}
+
+template<typename number>
+void VMMCPatchyShape<number>::apply(llint curr_step) {
+	this->_attempted += 1;
+
+	// clear the cluster
+	if(this->_clust.size() > 0) this->_clust.clear();
+
+	// generate the move
+	int pi = (int) (this->_rand() * (*this->_Info->N));
+	BaseParticle<number> *p = this->_Info->particles[pi];
+	movestr<number> move;
+	move.seed = pi;
+	move.seed_strand_id = p->strand_id;
+	move.type = VMMC_TRANSLATION;
+	if(this->_rand() > 0.5) move.type = VMMC_ROTATION;
+	if(move.type == VMMC_TRANSLATION) {
+		move.t = LR_vector<number>(Utils::gaussian<number>(), Utils::gaussian<number>(), Utils::gaussian<number>()) * this->_delta_tras;
+	}
+	else {
+		// the rotation is performed around the centre of the seed particle
+		move.R = Utils::get_random_rotation_matrix_from_angle<number>(this->_delta_rot * Utils::gaussian<number>());
+		move.Rt = (move.R).get_transpose();
+		move.t = p->pos;
+	}
+
+	// build the cluster; the links are computed with the locks in place before the move
+	number pprime = this->build_cluster(&move, this->_max_cluster_size);
+	int nclust = this->_clust.size();
+
+	PatchyBondGraph &bonds = _interaction->get_bond_graph();
+	// from now on, all the changes to the locks are undone if the move gets rejected
+	bonds.begin();
+
+	if(_interaction->get_is_infinite() == false && pprime > 0.) {
+		number delta_E_newlocks = _break_boundary_locks();
+
+		number delta_E_ext = 0.;
+		for(int l = 0; l < nclust; l++) {
+			p = this->_Info->particles[this->_clust[l]];
+			delta_E_ext += -p->ext_potential;
+			p->set_ext_potential(curr_step, this->_Info->box);
+			delta_E_ext += p->ext_potential;
+		}
+		pprime *= exp(-(1. / this->_T) * (delta_E_ext + delta_E_newlocks));
+	}
+
+	if(_interaction->get_is_infinite() == false && pprime > this->_rand()) {
+		// move accepted
+		this->_accepted += 1;
+		_lock_cluster();
+		bonds.commit();
+
+		if(curr_step < this->_equilibration_steps && this->_adjust_moves) {
+			if(move.type == VMMC_TRANSLATION) {
+				this->_delta_tras *= this->_acc_fact;
+				if(this->_delta_tras > this->_max_move_size / 2.) this->_delta_tras = this->_max_move_size / 2.;
+			}
+			else {
+				this->_delta_rot *= this->_acc_fact;
+				if(this->_delta_rot > M_PI) this->_delta_rot = M_PI;
+			}
+		}
+	}
+	else {
+		// move rejected
+		bonds.rollback();
+		_restore_cluster(curr_step);
+		_interaction->set_is_infinite(false);
+
+		if(curr_step < this->_equilibration_steps && this->_adjust_moves) {
+			if(move.type == VMMC_TRANSLATION) this->_delta_tras /= this->_rej_fact;
+			else this->_delta_rot /= this->_rej_fact;
+		}
+	}
+
+	for(int l = 0; l < nclust; l++) this->_Info->particles[this->_clust[l]]->inclust = false;
+}
+
+template class VMMCPatchyShape<float>;
+template class VMMCPatchyShape<double>;
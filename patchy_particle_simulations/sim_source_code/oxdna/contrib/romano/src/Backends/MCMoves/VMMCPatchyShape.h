@@ -0,0 +1,61 @@
+/**
+ * @file    VMMCPatchyShape.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef VMMCPATCHYSHAPE_H_
+#define VMMCPATCHYSHAPE_H_
+#define MCMOVE_CUSTOM
+
+#include "../../../../../src/Backends/MCMoves/VMMC.h"
+#include "../../Interactions/PatchyShapeInteraction.h"
+#include "../../Particles/PatchyShapeParticle.h"
+
+/**
+ * @brief Virtual move Monte Carlo (Whitelam and Geissler) cluster move for PatchyShapeInteraction.
+ *
+ * Clusters are built exactly as in VMMC, using the patch locks in place before the move. When no_multipatch is set, the
+ * locks are then updated in the same way as in MCMovePatchyShape: locks between a particle of the cluster and a particle
+ * outside it are broken if their energy goes above the lock cutoff, and the patches freed this way may lock to other
+ * patches. The energy of these new locks, which is not accounted for by the links, enters the acceptance probability.
+ * If the move is accepted the patches of the cluster lock to their new partners, otherwise all the locks are restored.
+ *
+ * @verbatim
+type = VMMCPatchyShape
+delta_tras = <float> (standard deviation of the translations)
+delta_rot = <float> (standard deviation of the rotation angles)
+[max_cluster_size = <int> (maximum number of particles that can be moved together, defaults to N)]
+[max_move_size = <float> (maximum displacement of a particle, defaults to 1)]
+@endverbatim
+ *
+ * As with VMMC, it requires list_type = cells.
+ */
+template<typename number>
+class VMMCPatchyShape : public VMMC<number> {
+	protected:
+		/// locks between the cluster and the rest of the system broken by the current move
+		std::vector<PatchyBond> _broken_locks;
+
+		PatchyShapeInteraction<number> *_interaction;
+
+		void _restore_cluster(llint curr_step);
+		number _break_boundary_locks();
+		number _lock_free_patch(int pid, int ppatch);
+		void _lock_cluster();
+
+	public:
+		VMMCPatchyShape();
+		virtual ~VMMCPatchyShape();
+
+		void apply (llint curr_step);
+		virtual void init();
+};
+
+
+extern "C" BaseMove<float> * make_VMMCPatchyShape_float()   { return new VMMCPatchyShape<float> () ; }
+extern "C" BaseMove<double> * make_VMMCPatchyShape_double() {return new VMMCPatchyShape<double> () ; }
+
+#endif // VMMCPatchyShape.h
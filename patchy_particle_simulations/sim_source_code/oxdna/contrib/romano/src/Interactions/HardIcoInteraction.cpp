@@ -12,6 +12,7 @@ HardIcoInteraction<number>::HardIcoInteraction() : BaseInteraction<number, HardI
 	this->_int_map[HardIco] = &HardIcoInteraction<number>::_hi_pot;
 	_close_vertexes = new int[12 * 5]; // 5 close vertexes for each vertex
 	_tworinscribed = (number) (2.*sqrt((1./12.) + (1./(6.*sqrt(5.))))); // twice the radius of inscribed sphere
+	_overlap_tests = TimingManager::instance()->get_counter("Overlap tests");
 }
 
 template<typename number>
@@ -11,6 +11,7 @@
 #include "Interactions/BaseInteraction.h"
 #include "Interactions/InteractionUtils.h"
 #include "../Particles/Icosahedron.h"
+#include "../../../../src/Utilities/Timings.h"
 
 /**
  * @brief Interaction class to simulate Hard Icosahedra.
@@ -28,6 +29,7 @@ protected:
 	number _delta;
 	number _tworinscribed;
 	int * _close_vertexes;
+	Counter *_overlap_tests;
 	
 public:
 	enum {
@@ -74,6 +76,7 @@ inline number HardIcoInteraction<number>::_hi_pot (BaseParticle<number> *ap, Bas
 	if (rnorm > this->_sqr_rcut) return (number) 0.f;
 	
 	if (rnorm > (number) 1.0f) return (number) 0.f; // todo: modify for patches
+	_overlap_tests->add();
 	
 	// radius of inscribed sphere: sqrt((1./12.) + (1./(6.*sqrt(5.)))) 
 	if (rnorm < _tworinscribed * _tworinscribed) {
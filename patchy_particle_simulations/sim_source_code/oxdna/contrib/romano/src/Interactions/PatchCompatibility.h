@@ -0,0 +1,255 @@
+/*
+ * PatchCompatibility.h
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#ifndef PATCHCOMPATIBILITY_H_
+#define PATCHCOMPATIBILITY_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "../../../../src/Utilities/oxDNAException.h"
+
+/// marks the free slots of the hash table of the compatible pairs of types
+#define PATCH_COMPATIBILITY_EMPTY_SLOT (~0ULL)
+
+/**
+ * @brief Stores which patches can bind to which in a sparse way, so that designs with many species and colours do not
+ * need tables whose size grows quadratically with the number of types.
+ *
+ * Each patch is labelled by an integer key (e.g. its colour, or its id when the compatibilities are read from an
+ * interaction tensor). The keys are mapped onto contiguous classes, and the list of the classes each class is compatible
+ * with is stored in compressed sparse row format. Then, for each particle type, the patches are grouped by class, and
+ * each group is stored as a 64-bit mask, so that the patches of a particle that are compatible with a given patch of
+ * another particle are obtained with a handful of bit operations. The memory required is linear in the number of
+ * compatible pairs of keys and in the total number of patches of the particle types.
+ *
+ * Once all the particle types have been added, the masks of the pairs of particle types that have at least a pair of
+ * compatible patches are computed and stored contiguously, and the position of each block is stored in an open-addressing
+ * hash table keyed on the pair of types. Both mask() and types_compatible() are thus constant-time lookups, and the
+ * memory required grows with the number of compatible pairs of types rather than with the square of the number of types.
+ */
+class PatchCompatibility {
+protected:
+	/// sorted keys. The class of a key is its position in this vector
+	std::vector<int> _keys;
+	/// the classes compatible with class c are _partners[_partner_offsets[c]] ... _partners[_partner_offsets[c + 1] - 1], sorted
+	std::vector<int> _partner_offsets, _partners;
+
+	int _N_types;
+	int _max_patches;
+	/// class of each patch of each particle type, or -1 if the patch is inactive. Patches of type t start at _type_offsets[t]
+	std::vector<int> _type_offsets, _patch_class;
+	/// for each particle type, the sorted classes of its patches and the masks of the patches belonging to each class
+	std::vector<int> _type_class_offsets, _type_classes;
+	std::vector<unsigned long long> _type_class_masks;
+	/// bit j of _pair_masks[o + i] is set if patch i of type ti is compatible with patch j of type tj, where o is the offset stored in the hash table for the pair (ti, tj)
+	std::vector<unsigned long long> _pair_masks;
+	/// open-addressing hash table of the compatible pairs of types: keys are ti*_N_types + tj (PATCH_COMPATIBILITY_EMPTY_SLOT if the slot is free), values are offsets in _pair_masks
+	std::vector<unsigned long long> _slot_keys;
+	std::vector<int> _slot_offsets;
+	int _hash_shift;
+	int _N_type_pairs;
+
+	unsigned long long _slot(unsigned long long key) const {
+		return (key * 0x9E3779B97F4A7C15ULL) >> _hash_shift;
+	}
+
+	/// returns the offset in _pair_masks of the masks of the pair of types, or -1 if no patches of the two types are compatible
+	int _pair_offset(int p_type, int q_type) const {
+		if(_slot_keys.empty()) return -1;
+		unsigned long long key = (unsigned long long) p_type * _N_types + q_type;
+		unsigned long long size_mask = _slot_keys.size() - 1;
+		for(unsigned long long s = _slot(key); true; s = (s + 1) & size_mask) {
+			if(_slot_keys[s] == key) return _slot_offsets[s];
+			if(_slot_keys[s] == PATCH_COMPATIBILITY_EMPTY_SLOT) return -1;
+		}
+	}
+
+	void _insert_pair(int p_type, int q_type, int offset) {
+		unsigned long long key = (unsigned long long) p_type * _N_types + q_type;
+		unsigned long long size_mask = _slot_keys.size() - 1;
+		unsigned long long s = _slot(key);
+		while(_slot_keys[s] != PATCH_COMPATIBILITY_EMPTY_SLOT) s = (s + 1) & size_mask;
+		_slot_keys[s] = key;
+		_slot_offsets[s] = offset;
+	}
+
+	int _class(int key) const {
+		std::vector<int>::const_iterator it = std::lower_bound(_keys.begin(), _keys.end(), key);
+		if(it == _keys.end() || *it != key) return -1;
+		return it - _keys.begin();
+	}
+
+	unsigned long long _class_mask(int type, int c) const {
+		std::vector<int>::const_iterator begin = _type_classes.begin() + _type_class_offsets[type];
+		std::vector<int>::const_iterator end = _type_classes.begin() + _type_class_offsets[type + 1];
+		std::vector<int>::const_iterator it = std::lower_bound(begin, end, c);
+		if(it == end || *it != c) return 0ULL;
+		return _type_class_masks[it - _type_classes.begin()];
+	}
+
+	unsigned long long _compute_mask(int p_type, int pi, int q_type) const {
+		int c = _patch_class[_type_offsets[p_type] + pi];
+		if(c < 0) return 0ULL;
+		unsigned long long mask = 0ULL;
+		for(int k = _partner_offsets[c]; k < _partner_offsets[c + 1]; k++) mask |= _class_mask(q_type, _partners[k]);
+		return mask;
+	}
+
+public:
+	PatchCompatibility() : _N_types(0), _max_patches(0), _hash_shift(63), _N_type_pairs(0) {
+		_partner_offsets.push_back(0);
+		_type_offsets.push_back(0);
+		_type_class_offsets.push_back(0);
+	}
+
+	/**
+	 * @brief Sets up the compatibilities between keys. The relation is symmetric, so that each pair need be given once.
+	 *
+	 * @param pairs pairs of compatible keys
+	 */
+	void init(const std::vector<std::pair<int, int> > &pairs) {
+		_keys.clear();
+		for(unsigned int i = 0; i < pairs.size(); i++) {
+			_keys.push_back(pairs[i].first);
+			_keys.push_back(pairs[i].second);
+		}
+		std::sort(_keys.begin(), _keys.end());
+		_keys.erase(std::unique(_keys.begin(), _keys.end()), _keys.end());
+
+		std::vector<std::pair<int, int> > edges;
+		edges.reserve(2 * pairs.size());
+		for(unsigned int i = 0; i < pairs.size(); i++) {
+			int c1 = _class(pairs[i].first);
+			int c2 = _class(pairs[i].second);
+			edges.push_back(std::make_pair(c1, c2));
+			edges.push_back(std::make_pair(c2, c1));
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		_partner_offsets.assign(_keys.size() + 1, 0);
+		_partners.resize(edges.size());
+		for(unsigned int i = 0; i < edges.size(); i++) {
+			_partner_offsets[edges[i].first + 1]++;
+			_partners[i] = edges[i].second;
+		}
+		for(unsigned int c = 0; c < _keys.size(); c++) _partner_offsets[c + 1] += _partner_offsets[c];
+	}
+
+	/**
+	 * @brief Adds a particle type. Types are numbered in the order in which they are added.
+	 *
+	 * @param keys keys of the patches of the particle type
+	 * @param active whether each patch is active. Inactive patches are not compatible with anything
+	 */
+	void add_particle_type(const std::vector<int> &keys, const std::vector<bool> &active) {
+		int N_patches = keys.size();
+		if(N_patches > 64) throw oxDNAException("PatchCompatibility: particle type %d has %d patches, but at most 64 are supported", _N_types, N_patches);
+
+		std::vector<std::pair<int, int> > classes;
+		for(int i = 0; i < N_patches; i++) {
+			int c = (active[i]) ? _class(keys[i]) : -1;
+			_patch_class.push_back(c);
+			if(c >= 0) classes.push_back(std::make_pair(c, i));
+		}
+		std::sort(classes.begin(), classes.end());
+		for(unsigned int i = 0; i < classes.size(); i++) {
+			if(i == 0 || classes[i].first != classes[i - 1].first) {
+				_type_classes.push_back(classes[i].first);
+				_type_class_masks.push_back(0ULL);
+			}
+			_type_class_masks.back() |= 1ULL << classes[i].second;
+		}
+
+		_type_offsets.push_back(_patch_class.size());
+		_type_class_offsets.push_back(_type_classes.size());
+		_max_patches = std::max(_max_patches, N_patches);
+		_N_types++;
+		_pair_masks.clear();
+		_slot_keys.clear();
+		_slot_offsets.clear();
+		_N_type_pairs = 0;
+	}
+
+	/// Computes the masks of the compatible pairs of types and builds their hash table. It should be called after the last particle type has been added
+	void finalise() {
+		// types that have at least a patch of each class
+		int N_classes = _keys.size();
+		std::vector<int> class_type_offsets(N_classes + 1, 0), class_types(_type_classes.size());
+		for(unsigned int k = 0; k < _type_classes.size(); k++) class_type_offsets[_type_classes[k] + 1]++;
+		for(int c = 0; c < N_classes; c++) class_type_offsets[c + 1] += class_type_offsets[c];
+		std::vector<int> fill(class_type_offsets.begin(), class_type_offsets.end() - 1);
+		for(int t = 0; t < _N_types; t++) {
+			for(int k = _type_class_offsets[t]; k < _type_class_offsets[t + 1]; k++) class_types[fill[_type_classes[k]]++] = t;
+		}
+
+		// for each type, the types that have at least a patch compatible with one of its patches
+		std::vector<std::pair<int, int> > type_pairs;
+		for(int ti = 0; ti < _N_types; ti++) {
+			std::vector<int> partners;
+			for(int k = _type_class_offsets[ti]; k < _type_class_offsets[ti + 1]; k++) {
+				int c = _type_classes[k];
+				for(int l = _partner_offsets[c]; l < _partner_offsets[c + 1]; l++) {
+					int pc = _partners[l];
+					partners.insert(partners.end(), class_types.begin() + class_type_offsets[pc], class_types.begin() + class_type_offsets[pc + 1]);
+				}
+			}
+			std::sort(partners.begin(), partners.end());
+			partners.erase(std::unique(partners.begin(), partners.end()), partners.end());
+			for(unsigned int j = 0; j < partners.size(); j++) type_pairs.push_back(std::make_pair(ti, partners[j]));
+		}
+		_N_type_pairs = type_pairs.size();
+
+		// the table is kept at most half full
+		unsigned long long N_slots = 2;
+		_hash_shift = 63;
+		while(N_slots < 2 * type_pairs.size()) {
+			N_slots <<= 1;
+			_hash_shift--;
+		}
+		_slot_keys.assign(N_slots, PATCH_COMPATIBILITY_EMPTY_SLOT);
+		_slot_offsets.assign(N_slots, -1);
+		_pair_masks.clear();
+		for(unsigned int k = 0; k < type_pairs.size(); k++) {
+			int ti = type_pairs[k].first;
+			int tj = type_pairs[k].second;
+			_insert_pair(ti, tj, _pair_masks.size());
+			int N_patches = _type_offsets[ti + 1] - _type_offsets[ti];
+			for(int i = 0; i < N_patches; i++) _pair_masks.push_back(_compute_mask(ti, i, tj));
+		}
+	}
+
+	int N_keys() const { return (int) _keys.size(); }
+	/// number of compatible (ordered) pairs of keys
+	int N_pairs() const { return (int) _partners.size(); }
+	/// number of (ordered) pairs of particle types that have at least a pair of compatible patches
+	int N_type_pairs() const { return _N_type_pairs; }
+
+	/// returns true if patches labelled with the two keys can bind
+	bool compatible(int key1, int key2) const {
+		int c1 = _class(key1);
+		int c2 = _class(key2);
+		if(c1 < 0 || c2 < 0) return false;
+		return std::binary_search(_partners.begin() + _partner_offsets[c1], _partners.begin() + _partner_offsets[c1 + 1], c2);
+	}
+
+	/// returns the mask of the patches of type q_type that are compatible with patch pi of type p_type
+	unsigned long long mask(int p_type, int pi, int q_type) const {
+		int offset = _pair_offset(p_type, q_type);
+		if(offset < 0) return 0ULL;
+		return _pair_masks[offset + pi];
+	}
+
+	/// returns true if at least one patch of type p_type is compatible with at least one patch of type q_type
+	bool types_compatible(int p_type, int q_type) const {
+		return _pair_offset(p_type, q_type) >= 0;
+	}
+};
+
+#endif /* PATCHCOMPATIBILITY_H_ */
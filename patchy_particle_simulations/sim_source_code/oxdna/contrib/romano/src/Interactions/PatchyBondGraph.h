@@ -0,0 +1,375 @@
+/*
+ * PatchyBondGraph.h
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#ifndef PATCHYBONDGRAPH_H_
+#define PATCHYBONDGRAPH_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+
+#include "../../../../src/Utilities/oxDNAException.h"
+#include "../../../../src/Utilities/Timings.h"
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+/// A bond between patch p_patch of particle p and patch q_patch of particle q
+struct PatchyBond {
+	int p, p_patch;
+	int q, q_patch;
+
+	PatchyBond(int _p, int _p_patch, int _q, int _q_patch) : p(_p), p_patch(_p_patch), q(_q), q_patch(_q_patch) {}
+};
+
+/**
+ * @brief Disjoint-set forest over the particles, with union by size and path halving. Two particles belong to the same
+ * set if they are connected by a chain of bonds.
+ */
+class ParticleClusters {
+protected:
+	std::vector<int> _parent;
+	std::vector<int> _size;
+
+public:
+	/// puts each of the N particles in a set of its own
+	void reset(int N) {
+		_parent.resize(N);
+		_size.assign(N, 1);
+		for(int i = 0; i < N; i++) _parent[i] = i;
+	}
+
+	int N_particles() const { return (int) _parent.size(); }
+
+	/// returns the representative of the set particle i belongs to
+	int find(int i) {
+		while(_parent[i] != i) {
+			_parent[i] = _parent[_parent[i]];
+			i = _parent[i];
+		}
+		return i;
+	}
+
+	/// merges the sets particles i and j belong to
+	void join(int i, int j) {
+		i = find(i);
+		j = find(j);
+		if(i == j) return;
+		if(_size[i] < _size[j]) std::swap(i, j);
+		_parent[j] = i;
+		_size[i] += _size[j];
+	}
+
+	/// returns the number of particles in the set particle i belongs to
+	int size(int i) {
+		return _size[find(i)];
+	}
+};
+
+/**
+ * @brief Keeps track of which patch is bound to which when PatchyShapeInteraction is used with no_multipatch = true.
+ *
+ * Each patch of each particle is a node of the graph, and each node has at most one edge (its lock). Locks are always set
+ * and removed symmetrically. All the changes done between a call to begin() and a call to commit() are recorded, so that
+ * rollback() can bring the graph back to the state it was in when begin() was called. Both recording and undoing a change
+ * take constant time.
+ *
+ * When compiled with OpenMP, each thread records its changes in its own journal, so that threads working on patches
+ * that are far apart from each other can open, commit and roll back their transactions at the same time.
+ *
+ * The graph also keeps track of the clusters of particles connected by locks. New locks are merged into the clusters as
+ * soon as they are made, while breaking a lock that may split a cluster marks the clusters as stale, and they are then
+ * rebuilt from the locks, in linear time, the next time they are needed. Locks made by parallel transactions, as well
+ * as rollbacks, also mark the clusters as stale.
+ */
+class PatchyBondGraph {
+protected:
+	/// _offsets[i] is the index of the first patch of particle i, _offsets[N] is the total number of patches
+	std::vector<int> _offsets;
+	/// particle and patch each node belongs to
+	std::vector<int> _owner, _owner_patch;
+	/// node each node is bound to, or -1
+	std::vector<int> _partner;
+	int _N_bonds;
+
+	struct Journal {
+		/// (node, old partner) pairs, in the order in which they have been changed since begin()
+		std::vector<std::pair<int, int> > changes;
+		bool in_transaction;
+		/// change in the number of bonds since begin()
+		int delta_N_bonds;
+		/// keeps the journals of different threads on different cache lines
+		char padding[64];
+
+		Journal() : in_transaction(false), delta_N_bonds(0) {
+			memset(padding, 0, sizeof(padding));
+		}
+
+		void clear() {
+			changes.clear();
+			in_transaction = false;
+			delta_N_bonds = 0;
+		}
+	};
+	/// one journal per thread
+	std::vector<Journal> _journals;
+
+	ParticleClusters _clusters;
+	/// false if the clusters have to be rebuilt from the locks
+	bool _clusters_valid;
+
+	/// telemetry counters. Locks created or broken within a transaction that is later rolled back are counted as well
+	Counter *_lock_creations;
+	Counter *_lock_breaks;
+
+	int _node(int particle, int patch) const {
+		return _offsets[particle] + patch;
+	}
+
+	Journal &_journal() {
+#ifdef HAVE_OPENMP
+		if(omp_in_parallel()) return _journals[omp_get_thread_num()];
+#endif
+		return _journals[0];
+	}
+
+	void _invalidate_clusters() {
+#ifdef HAVE_OPENMP
+#pragma omp atomic write
+#endif
+		_clusters_valid = false;
+	}
+
+	void _set_partner(Journal &journal, int node, int partner) {
+		if(journal.in_transaction) journal.changes.push_back(std::make_pair(node, _partner[node]));
+		_partner[node] = partner;
+	}
+
+	void _change_N_bonds(Journal &journal, int delta) {
+		if(journal.in_transaction) journal.delta_N_bonds += delta;
+#ifdef HAVE_OPENMP
+#pragma omp atomic
+#endif
+		_N_bonds += delta;
+	}
+
+	void _unlock_node(Journal &journal, int node) {
+		int other = _partner[node];
+		if(other < 0) return;
+		if(_lock_breaks != NULL) _lock_breaks->add();
+		_set_partner(journal, node, -1);
+		_set_partner(journal, other, -1);
+		_change_N_bonds(journal, -1);
+		// the cluster cannot split if the two particles are still bound through another pair of patches
+		if(!locked_to_particle(_owner[node], _owner[other])) _invalidate_clusters();
+	}
+
+	void _clear_journals() {
+		int N_journals = 1;
+#ifdef HAVE_OPENMP
+		N_journals = omp_get_max_threads();
+#endif
+		_journals.assign(N_journals, Journal());
+	}
+
+public:
+	PatchyBondGraph() : _N_bonds(0), _clusters_valid(false), _lock_creations(NULL), _lock_breaks(NULL) {
+		_offsets.push_back(0);
+		_clear_journals();
+	}
+
+	/**
+	 * @brief Sets up the graph for N particles. All the patches start unlocked.
+	 *
+	 * @param N number of particles
+	 * @param N_patches number of patches of each particle
+	 */
+	void init(int N, const int *N_patches) {
+		_offsets.assign(N + 1, 0);
+		for(int i = 0; i < N; i++) _offsets[i + 1] = _offsets[i] + N_patches[i];
+
+		int N_nodes = _offsets[N];
+		_owner.resize(N_nodes);
+		_owner_patch.resize(N_nodes);
+		for(int i = 0; i < N; i++) {
+			for(int c = 0; c < N_patches[i]; c++) {
+				_owner[_offsets[i] + c] = i;
+				_owner_patch[_offsets[i] + c] = c;
+			}
+		}
+		_partner.assign(N_nodes, -1);
+		_N_bonds = 0;
+		_clear_journals();
+		_clusters_valid = false;
+
+		_lock_creations = TimingManager::instance()->get_counter("Lock creations");
+		_lock_breaks = TimingManager::instance()->get_counter("Lock breaks");
+	}
+
+	/// Removes all the locks. It cannot be undone.
+	void clear() {
+		_partner.assign(_partner.size(), -1);
+		_N_bonds = 0;
+		_clear_journals();
+		_clusters_valid = false;
+	}
+
+	int N_particles() const { return (int) _offsets.size() - 1; }
+	int N_bonds() const { return _N_bonds; }
+
+	bool is_locked(int particle, int patch) const {
+		return _partner[_node(particle, patch)] >= 0;
+	}
+
+	bool locked_to(int particle, int patch, int other, int other_patch) const {
+		return _partner[_node(particle, patch)] == _node(other, other_patch);
+	}
+
+	/// Returns true if any patch of particle is locked to any patch of other
+	bool locked_to_particle(int particle, int other) const {
+		for(int n = _offsets[particle]; n < _offsets[particle + 1]; n++) {
+			if(_partner[n] >= 0 && _owner[_partner[n]] == other) return true;
+		}
+		return false;
+	}
+
+	/// Stores in other and other_patch the patch the given patch is locked to, or -1 and -1 if it is not locked
+	void get_lock(int particle, int patch, int &other, int &other_patch) const {
+		int partner = _partner[_node(particle, patch)];
+		if(partner < 0) other = other_patch = -1;
+		else {
+			other = _owner[partner];
+			other_patch = _owner_patch[partner];
+		}
+	}
+
+	/// Locks two patches to each other, breaking their previous locks, if any
+	void lock(int particle, int patch, int other, int other_patch) {
+		int p_node = _node(particle, patch);
+		int q_node = _node(other, other_patch);
+		if(_partner[p_node] == q_node) return;
+
+		Journal &journal = _journal();
+		_unlock_node(journal, p_node);
+		_unlock_node(journal, q_node);
+		_set_partner(journal, p_node, q_node);
+		_set_partner(journal, q_node, p_node);
+		_change_N_bonds(journal, 1);
+		if(_lock_creations != NULL) _lock_creations->add();
+
+#ifdef HAVE_OPENMP
+		if(omp_in_parallel()) {
+			_invalidate_clusters();
+			return;
+		}
+#endif
+		if(_clusters_valid) _clusters.join(particle, other);
+	}
+
+	/// Breaks the lock of the given patch, if any. The patch it was locked to is unlocked as well
+	void unlock(int particle, int patch) {
+		_unlock_node(_journal(), _node(particle, patch));
+	}
+
+	void unlock_particle(int particle) {
+		Journal &journal = _journal();
+		for(int n = _offsets[particle]; n < _offsets[particle + 1]; n++) _unlock_node(journal, n);
+	}
+
+	/// Starts recording the changes so that they can be undone by rollback()
+	void begin() {
+#ifdef HAVE_OPENMP
+		if(omp_get_thread_num() >= (int) _journals.size()) throw oxDNAException("PatchyBondGraph: begin() called by thread %d, but the graph has been set up for %d threads only", omp_get_thread_num(), (int) _journals.size());
+#endif
+		Journal &journal = _journal();
+		if(journal.in_transaction) throw oxDNAException("PatchyBondGraph: begin() called while a transaction is already open");
+		journal.clear();
+		journal.in_transaction = true;
+	}
+
+	/// Keeps all the changes done since the last call to begin()
+	void commit() {
+		_journal().clear();
+	}
+
+	/// Appends to particles the particles some of whose patches have been locked or unlocked since the last call to begin(). A particle may be appended more than once
+	void get_changed_particles(std::vector<int> &particles) {
+		Journal &journal = _journal();
+		for(unsigned int i = 0; i < journal.changes.size(); i++) particles.push_back(_owner[journal.changes[i].first]);
+	}
+
+	/// Undoes all the changes done since the last call to begin()
+	void rollback() {
+		Journal &journal = _journal();
+		if(journal.changes.size() > 0) _invalidate_clusters();
+		for(int i = (int) journal.changes.size() - 1; i >= 0; i--) _partner[journal.changes[i].first] = journal.changes[i].second;
+#ifdef HAVE_OPENMP
+#pragma omp atomic
+#endif
+		_N_bonds -= journal.delta_N_bonds;
+		journal.clear();
+	}
+
+	/// Throws an exception if a lock is not symmetric or if the number of bonds is not consistent with the locks
+	void check_consistency() const {
+		int N_bonds = 0;
+		for(int n = 0; n < (int) _partner.size(); n++) {
+			int partner = _partner[n];
+			if(partner < 0) continue;
+			if(_partner[partner] != n) throw oxDNAException("Asymmetric lock detected: patch %d of particle %d is locked to patch %d of particle %d, but not vice versa", _owner_patch[n], _owner[n], _owner_patch[partner], _owner[partner]);
+			if(partner > n) N_bonds++;
+		}
+		if(N_bonds != _N_bonds) throw oxDNAException("PatchyBondGraph: found %d bonds, expected %d", N_bonds, _N_bonds);
+	}
+
+	/// Fills bonds with the current bonds. Each bond is stored once, with p < q or p == q and p_patch < q_patch
+	void get_bonds(std::vector<PatchyBond> &bonds) const {
+		bonds.clear();
+		for(int n = 0; n < (int) _partner.size(); n++) {
+			int partner = _partner[n];
+			if(partner > n) bonds.push_back(PatchyBond(_owner[n], _owner_patch[n], _owner[partner], _owner_patch[partner]));
+		}
+	}
+
+	/**
+	 * @brief Returns the clusters of particles connected by locks, rebuilding them if needed. It must not be called
+	 * while other threads may be changing the locks.
+	 */
+	ParticleClusters &get_clusters() {
+		if(!_clusters_valid) {
+			_clusters.reset(N_particles());
+			for(int n = 0; n < (int) _partner.size(); n++) {
+				if(_partner[n] > n) _clusters.join(_owner[n], _owner[_partner[n]]);
+			}
+			_clusters_valid = true;
+		}
+		return _clusters;
+	}
+
+	/// the state is stored as one int per patch, containing the index of the patch it is locked to (or -1)
+	size_t get_state_size() const {
+		return _partner.size() * sizeof(int);
+	}
+
+	void write_state(char *buffer) const {
+		if(_partner.size() > 0) memcpy(buffer, &_partner[0], get_state_size());
+	}
+
+	void read_state(const char *buffer) {
+		if(_partner.size() > 0) memcpy(&_partner[0], buffer, get_state_size());
+		_N_bonds = 0;
+		for(int n = 0; n < (int) _partner.size(); n++) {
+			if(_partner[n] > n) _N_bonds++;
+		}
+		_clear_journals();
+		_clusters_valid = false;
+	}
+};
+
+#endif /* PATCHYBONDGRAPH_H_ */
@@ -2,8 +2,12 @@
 #include "../Particles/PatchyShapeParticle.h"
 #include "../../../../src/Utilities/Utils.h"
 #include "Interactions/InteractionUtils.h"
+#include "../../../../src/Utilities/RandomManager.h"
 #include <sstream>
 
+// id of the RandomManager stream used by check_patchy_locks
+#define PATCHY_LOCK_CHECK_STREAM 0
+
 template <typename number> LR_vector<number> getVector(input_file *obs_input,const char *key)
 {
 	 double tmpf[3];
@@ -24,23 +28,7 @@ template <typename number> LR_vector<number> getVector(input_file *obs_input,con
 // implementation of inline functions:
 template<typename number>
 bool PatchyShapeInteraction<number>::_patches_compatible(PatchyShapeParticle<number>  *p, PatchyShapeParticle<number>  *q, int pi, int pj ) {
- if(abs(p->patches[pi].color)  < 10 &&  abs(q->patches[pj].color ) < 10  )  //we are in the self-complementary regime
- {
-	if(p->patches[pi].color == q->patches[pj].color ) { //patches are the same, hence complementary
-        return true;
-	}
-	else {
-		return false;
-	}
- }
- else if (p->patches[pi].color + q->patches[pj].color == 0) { //the case where only complementary patches (like -10 and +10) can bind
-	 return true;
-
- }
-
- //if we got here, no compatibility
- return false;
-
+	return this->_compatibility.compatible(_compatibility_key(p->patches[pi]), _compatibility_key(q->patches[pj]));
 }
 
 
@@ -61,18 +49,12 @@ inline bool PatchyShapeInteraction<number>::_bonding_allowed(PatchyShapeParticle
 
 		if(this->_no_multipatch) //one patch binds only one other patch
 		{
-			if ( p->patches[pi].locked_to(q->index,pj) )
+			// locks are symmetric by construction, so we don't need to check both sides
+			if ( this->_bonds.locked_to(p->index,pi,q->index,pj) )
 			{
-				if (  q->patches[pj].locked_to(p->index,pi)  )
-				{
-					return true;
-				}
-				else
-				{
-					throw oxDNAException("Assymetric lock detected for particles %d %d",p->index,q->index);
-				}
+				return true;
 			}
-			else if (  ! p->patches[pi].is_locked() && !q->patches[pj].is_locked())
+			else if (  ! this->_bonds.is_locked(p->index,pi) && ! this->_bonds.is_locked(q->index,pj))
 			{
 				return true;
 			}
@@ -293,6 +275,8 @@ number PatchyShapeInteraction<number>::_exc_vol_hard_icosahedron(BaseParticle<nu
 	if (rnorm > (number) 1.)
 		return (number) 0.f;
 
+	_overlap_tests->add();
+
 	// radius of inscribed sphere: sqrt((1./12.) + (1./(6.*sqrt(5.))))
 	if (rnorm < _tworinscribed * _tworinscribed) {
 		this->set_is_infinite(true);
@@ -310,9 +294,12 @@ number PatchyShapeInteraction<number>::_exc_vol_hard_icosahedron(BaseParticle<nu
 	int v1 = -1, v11 = -1, v21 = -1;
 	int v2 = -1, v12 = -1, v22 = -1;
 	
-	// finds the three closest vertexes.
+	// finds the three closest vertexes. Vertexes come in opposite pairs, so that each projection is computed once
+	// for both vertexes of a pair. The vertexes of PatchyShapeParticle are not sorted so that opposite vertexes are 6
+	// places apart (as they are in Icosahedron): we use the pairs found by _init_icosahedron
 	int OFF = p->N_patches;
-	for (int k = 0; k < 6; k ++) {
+	for (int h = 0; h < 6; h ++) {
+		int k = _half_vertexes[h];
 		number a =  (p->int_centers[OFF + k] * (my_r));
 		number b = -(q->int_centers[OFF + k] * (my_r));
 		if (a > max1) {
@@ -335,7 +322,7 @@ number PatchyShapeInteraction<number>::_exc_vol_hard_icosahedron(BaseParticle<nu
 			max22 = b;
 			v22 = k;
 		}
-		int kk = k + 6;
+		int kk = _antipodal_vertexes[k];
 		a = -a;
 		b = -b;
 		if (a > max1) {
@@ -395,6 +382,10 @@ number PatchyShapeInteraction<number>::_exc_vol_hard_icosahedron(BaseParticle<nu
 	if (ppf > (number) 0.015) would_exit = true;
 	if (would_exit) return (number) 0.;
 
+	// the edge-face walk below is expensive and, for particles in contact, it almost always finds no
+	// intersection: we first look for a separating axis among face normals and edge-edge cross products
+	if (_icosahedra_separated(p, q, my_r)) return (number) 0.;
+
 	// check edges from p with faces from q
 	LR_vector<number> s1, s2;
 	s1 = p->int_centers[v1+OFF] - my_r;
@@ -435,6 +426,72 @@ number PatchyShapeInteraction<number>::_exc_vol_hard_icosahedron(BaseParticle<nu
 }
 
 
+// half the extent of the projection of a (centrally symmetric) icosahedron on the given axis
+template<typename number>
+inline number PatchyShapeInteraction<number>::_ico_half_extent(const LR_vector<number> *vertexes, const LR_vector<number> &axis) {
+	number res = (number) 0.;
+	for (int k = 0; k < 6; k++) {
+		number proj = fabs(vertexes[_half_vertexes[k]] * axis);
+		if (proj > res) res = proj;
+	}
+	return res;
+}
+
+template<typename number>
+inline bool PatchyShapeInteraction<number>::_ico_separated_along(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, const LR_vector<number> &my_r, const LR_vector<number> &axis) {
+	int OFF = p->N_patches;
+	number extent = _ico_half_extent(p->int_centers + OFF, axis) + _ico_half_extent(q->int_centers + OFF, axis);
+	// the tolerance makes sure that we never call separated two particles that the edge-face walk would find overlapping
+	return fabs(my_r * axis) > extent * ((number) 1. + (number) 1.e-5);
+}
+
+// Separating Axis Theorem applied to the face normals of both particles and to the cross products between the edges that
+// meet at the vertexes of p and q closest to each other. The axes are built from the actual positions of the vertexes, so
+// that if a separating axis is found the two particles do not overlap, even if the rotation matrixes are not orthonormal.
+// If no axis is found the result is inconclusive
+template<typename number>
+bool PatchyShapeInteraction<number>::_icosahedra_separated(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, const LR_vector<number> &my_r) {
+	int OFF = p->N_patches;
+	const LR_vector<number> *pv = p->int_centers + OFF;
+	const LR_vector<number> *qv = q->int_centers + OFF;
+
+	for (int f = 0; f < 10; f++) {
+		const int *face = _half_faces + 3 * f;
+		if (_ico_separated_along(p, q, my_r, pv[face[0]] + pv[face[1]] + pv[face[2]])) return true;
+		if (_ico_separated_along(p, q, my_r, qv[face[0]] + qv[face[1]] + qv[face[2]])) return true;
+	}
+
+	// the vertex of p that points the most towards q, and vice versa
+	int vp = 0, vq = 0;
+	number max_p = (number) -1., max_q = (number) -1.;
+	for (int k = 0; k < 6; k++) {
+		int v = _half_vertexes[k];
+		number a = pv[v] * my_r;
+		number b = -(qv[v] * my_r);
+		if (fabs(a) > max_p) {
+			max_p = fabs(a);
+			vp = (a > (number) 0.) ? v : _antipodal_vertexes[v];
+		}
+		if (fabs(b) > max_q) {
+			max_q = fabs(b);
+			vq = (b > (number) 0.) ? v : _antipodal_vertexes[v];
+		}
+	}
+
+	for (int i = 0; i < 5; i++) {
+		LR_vector<number> p_edge = pv[_close_vertexes[5 * vp + i]] - pv[vp];
+		for (int j = 0; j < 5; j++) {
+			LR_vector<number> axis = p_edge.cross(qv[_close_vertexes[5 * vq + j]] - qv[vq]);
+			// parallel edges do not define an axis
+			if (axis.norm() < (number) 1.e-6) continue;
+			if (_ico_separated_along(p, q, my_r, axis)) return true;
+		}
+	}
+
+	return false;
+}
+
+
 template<typename number>
 number PatchyShapeInteraction<number>::_exc_vol_interaction(BaseParticle<number> *p, BaseParticle<number> *q, LR_vector<number> *r, bool update_forces) {
 
@@ -472,31 +529,60 @@ number PatchyShapeInteraction<number>::_patchy_interaction_notorsion(BaseParticl
 	PatchyShapeParticle<number> *pp = static_cast<PatchyShapeParticle<number> *>(p);
 	PatchyShapeParticle<number> *qq = static_cast<PatchyShapeParticle<number> *>(q);
 
+	// same as in _bonding_allowed, the same_type_bonding option is ignored when no_multipatch is set
+	if(!this->_same_type_bonding && !this->_no_multipatch && p->type == q->type) return energy;
+
 	int c = 0;
-	LR_vector<number> tmptorquep(0, 0, 0);
-	LR_vector<number> tmptorqueq(0, 0, 0);
-	for(int pi = 0; pi < pp->N_patches; pi++) {
+	int Np = pp->N_patches;
+	int Nq = qq->N_patches;
+	if(Np == 0 || Nq == 0) return energy;
+
+	const number sqr_patchy_cutoff = SQR(PATCHY_CUTOFF);
+	number dists[PLPATCHY_MAX_PATCHES];
+
+	// patch data are read from the store, where the patches of each particle are contiguous
+	const int p_offset = _store.offsets[p->index];
+	const int q_offset = _store.offsets[q->index];
+	const number *qx = &_store.x[q_offset];
+	const number *qy = &_store.y[q_offset];
+	const number *qz = &_store.z[q_offset];
+	const number *p_strength = &_store.strength[p_offset];
+	for(int pi = 0; pi < Np; pi++) {
+		unsigned long long candidates = this->_compatibility.mask(p->type, pi, q->type);
+		if(candidates == 0ULL) continue;
+
 		LR_vector<number> ppatch = p->int_centers[pi];
 
-		for(int pj = 0; pj < qq->N_patches; pj++) {
+		// squared distances between patch pi and all the patches of q: there are no branches here, so that
+		// the compiler can vectorise the loop. Only the compatible pairs that are close enough survive
+		for(int pj = 0; pj < Nq; pj++) {
+			number dx = r->x + qx[pj] - ppatch.x;
+			number dy = r->y + qy[pj] - ppatch.y;
+			number dz = r->z + qz[pj] - ppatch.z;
+			dists[pj] = dx*dx + dy*dy + dz*dz;
+		}
+		unsigned long long close = 0ULL;
+		for(int pj = 0; pj < Nq; pj++) close |= ((unsigned long long) (dists[pj] < sqr_patchy_cutoff)) << pj;
+		candidates &= close;
+
+		for(int pj = 0; candidates != 0ULL; pj++, candidates >>= 1) {
   		     //printf("Patches %d and %d , colors %d %d \n",pi,pj,pp->patches[pi].color,qq->patches[pj].color);
 
-			//if(pp->patches[pi].color == qq->patches[pj].color && pp->patches[pi].active && qq->patches[pj].active) //patches are complementary
-			if(this->_bonding_allowed(pp,qq,pi,pj)  )
+			if((candidates & 1ULL) && this->_locks_allow(p->index,pi,q->index,pj))
 			{
 
-				number K = pp->patches[pi].strength;
+				number K = p_strength[pi];
 			    LR_vector<number> qpatch = q->int_centers[pj];
 
 			    LR_vector<number> patch_dist = *r + qpatch - ppatch;
-			    number dist = patch_dist.norm();
+			    number dist = dists[pj];
 			    //LR_vector<number> patch_dist_dir = patch_dist / sqrt(dist);
 			    //number rdist = sqrt(rnorm);
 			    //LR_vector<number> r_dist_dir = *r / rdist;
 
                 //printf("Patches %d and %d distance %f  cutoff is: %f,\n",pp->patches[pi].id,qq->patches[pj].id,dist,SQR(PATCHY_CUTOFF));
 
-			    if(dist < SQR(PATCHY_CUTOFF)) {
+			    { // dist < SQR(PATCHY_CUTOFF) is guaranteed by the candidates mask
 			    	//printf("CRITICAL CALCULATING FORCE BETWEEN %d %d",q->index,p->index);
 				    c++;
                     number energy_ij = 0;
@@ -538,14 +624,11 @@ number PatchyShapeInteraction<number>::_patchy_interaction_notorsion(BaseParticl
                     {
                      if (energy_ij < this->_lock_cutoff )
                      {
-                    	qq->patches[pj].set_lock(p->index,pi,energy_ij);
-                        pp->patches[pi].set_lock(q->index,pj,energy_ij);
+                    	this->_bonds.lock(p->index,pi,q->index,pj);
                      }
                      else
                      {
-                    	qq->patches[pj].unlock();
-                    	pp->patches[pi].unlock();
-
+                    	this->_bonds.unlock(p->index,pi);
                      }
 
                     }
@@ -612,6 +695,9 @@ template <typename number>
 PatchyShapeInteraction<number>::PatchyShapeInteraction() : BaseInteraction<number, PatchyShapeInteraction<number> >()  {
 	//this->_int_map[PATCHY] = &PatchyShapeInteraction<number>::_patchy_interaction;
     _close_vertexes = NULL;
+    _locks_restored = false;
+    _lock_check_rng_ready = false;
+    _overlap_tests = TimingManager::instance()->get_counter("Overlap tests");
 
     _no_multipatch = 0;
 
@@ -645,9 +731,6 @@ PatchyShapeInteraction<number>::PatchyShapeInteraction() : BaseInteraction<numbe
 
 	_interaction_tensor = false;
 
-	_interaction_patch_types = 0; //a 2d matrix of patches (each patch has a unique id) that checks if patches can interact; is only used if interaction tensor is true
-	_interaction_table_types = 0;
-
 }
 
 template <typename number>
@@ -655,8 +738,6 @@ PatchyShapeInteraction<number>::~PatchyShapeInteraction() {
 
 	delete [] _patch_types;
 	delete [] _particle_types;
-	delete [] _interaction_table_types;
-	delete [] _interaction_patch_types;
 	delete [] _close_vertexes;
 }
 
@@ -800,7 +881,7 @@ PatchyShapeInteraction<number>::_load_patchy_particle_files(std::string& patchy_
 }
 
 template<typename number>
-void PatchyShapeInteraction<number>::_load_interaction_tensor(std::string &tensor_file)
+void PatchyShapeInteraction<number>::_load_interaction_tensor(std::string &tensor_file, std::vector<std::pair<int, int> > &pairs)
 {
    int p1, p2, patch1, patch2;
    std::ifstream inf(tensor_file.c_str());
@@ -815,14 +896,14 @@ void PatchyShapeInteraction<number>::_load_interaction_tensor(std::string &tenso
 	   if(s.str().size() >= 4)
 	   {
 		   s >> p1 >> p2 >> patch1 >> patch2;
-		   if(p1 >= this->_N_particle_types || p2 >=  this->_N_particle_types || patch1 >= this->_particle_types[p1].N_patches || patch2 >= this->_particle_types[p2].N_patches  )
+		   if(p1 < 0 || p2 < 0 || p1 >= this->_N_particle_types || p2 >=  this->_N_particle_types || patch1 < 0 || patch2 < 0 || patch1 >= this->_particle_types[p1].N_patches || patch2 >= this->_particle_types[p2].N_patches  )
 			   throw oxDNAException("Invalid index found in  %s, line: %s",tensor_file.c_str(),line);
 
 		   int i1 = this->_particle_types[p1].patches[patch1].id;
 		   int i2 = this->_particle_types[p2].patches[patch2].id;
 		   c++;
-		   this->_interaction_patch_types[i1*_N_patch_types + i2] = this->_interaction_patch_types[i2*_N_patch_types +  i1] = 1;
-		   printf("DBG: Loaded %d %d %d %d, which is id: %d %d\n",p1,p2,patch1,patch2,i1,i2);
+		   pairs.push_back(std::make_pair(i1, i2));
+		   OX_DEBUG("Loaded %d %d %d %d, which is id: %d %d",p1,p2,patch1,patch2,i1,i2);
 	   }
 
 	   if(s.fail())
@@ -932,8 +1013,6 @@ void PatchyShapeInteraction<number>::get_settings(input_file &inp) {
 	_load_patchy_particle_files(patchy_file,particle_file);
 
     int interaction_tensor = 0;
-	this->_interaction_patch_types = new int [_N_patch_types * _N_patch_types]();
-
     if( getInputBoolAsInt(&inp,"interaction_tensor",&interaction_tensor,0) == KEY_FOUND)
     {
     		this->_interaction_tensor = (bool)interaction_tensor;
@@ -942,69 +1021,9 @@ void PatchyShapeInteraction<number>::get_settings(input_file &inp) {
     {
     	std::string interaction_tensor_file; //this file contains information about types of patches
     	getInputString(&inp, "interaction_tensor_file", interaction_tensor_file, 1);
-
-    	this->_load_interaction_tensor(interaction_tensor_file);
-    }
-    else  //no external file provided; we assign allowed interactions based on colors of patches!
-    {
-       for(int i = 0; i < _N_particle_types; i++)
-       {
-    	   PatchyShapeParticle<number>  *p = &_particle_types[i];
-
-    	   for(int j = i; j < _N_particle_types; j++)
-    	   {
-    		   PatchyShapeParticle<number>  *q = &_particle_types[j];
-    		   for(int pi = 0; pi < p->N_patches; pi++)
-    		   {
-    			   for(int qj = 0; qj < q->N_patches; qj++)
-    			   {
-    				    int pid = p->patches[pi].id;
-    				    int qid = q->patches[qj].id;
-                        if(p->patches[pi].color == q->patches[qj].color)
-                        {
-                        	this->_interaction_patch_types[pid * _N_patch_types + qid] = this->_interaction_patch_types[qid * _N_patch_types + pid] = 1;
-                        }
-
-                        if(i == j && !this->_same_type_bonding)
-                        {
-                        	this->_interaction_patch_types[pid * _N_patch_types + qid] = this->_interaction_patch_types[qid * _N_patch_types + pid] = 0;
-                        }
-    			   }
-    		   }
-
-    	   }
-       }
+    	_init_compatibility(&interaction_tensor_file);
     }
-
-    _interaction_table_types =  new int [_N_particle_types * _N_particle_types]();
-    for(int i = 0; i < _N_particle_types; i++)
-    {
-        	for(int j = i; j < _N_particle_types; j++)
-        	{
-        		bool possible_bond = false;
-        		PatchyShapeParticle<number>  *p = &_particle_types[i];
-        		PatchyShapeParticle<number>  *q = &_particle_types[j];
-        		for(int pi = 0; pi < p->N_patches; pi++)
-        		{
-        			for(int qi = 0; qi < q->N_patches; qi++)
-        			{
-                       if(_bonding_allowed(p,q,pi,qi))
-                       {
-                    	   possible_bond = true;
-                    	   break;
-                       }
-
-        			}
-        			if(possible_bond)
-        				break;
-        		}
-        		if(possible_bond)
-        		{
-        		  _interaction_table_types[i*_N_particle_types + j]  = _interaction_table_types[j*_N_particle_types + i] = 1;
-        		 // printf("Particle types %d and %d can interact!\n",i,j);
-        		}
-        	}
-     }
+    else _init_compatibility(NULL); //no external file provided; we assign allowed interactions based on colors of patches!
 
     //now actually check it for the particles themselves:
 
@@ -1111,6 +1130,42 @@ void PatchyShapeInteraction<number>::init() {
 	}
 }
 
+template<typename number>
+void PatchyShapeInteraction<number>::_init_compatibility(std::string *tensor_file) {
+	std::vector<std::pair<int, int> > pairs;
+	if(tensor_file != NULL) _load_interaction_tensor(*tensor_file, pairs);
+	else {
+		// patches whose colours are smaller than 10 in absolute value are self-complementary, the others bind to the opposite colour
+		std::vector<int> colours;
+		for(int i = 0; i < _N_particle_types; i++) {
+			for(int pi = 0; pi < _particle_types[i].N_patches; pi++) colours.push_back(_particle_types[i].patches[pi].color);
+		}
+		std::sort(colours.begin(), colours.end());
+		colours.erase(std::unique(colours.begin(), colours.end()), colours.end());
+		for(unsigned int i = 0; i < colours.size(); i++) {
+			int c = colours[i];
+			int partner = (abs(c) < 10) ? c : -c;
+			if(c <= partner && std::binary_search(colours.begin(), colours.end(), partner)) pairs.push_back(std::make_pair(c, partner));
+		}
+	}
+	_compatibility.init(pairs);
+
+	for(int i = 0; i < _N_particle_types; i++) {
+		PatchyShapeParticle<number> *p = &_particle_types[i];
+		if(p->N_patches > PLPATCHY_MAX_PATCHES) throw oxDNAException("Particle type %d has %d patches, but at most %d are supported", i, p->N_patches, PLPATCHY_MAX_PATCHES);
+		std::vector<int> keys;
+		std::vector<bool> active;
+		for(int pi = 0; pi < p->N_patches; pi++) {
+			keys.push_back(_compatibility_key(p->patches[pi]));
+			active.push_back(p->patches[pi].active);
+		}
+		_compatibility.add_particle_type(keys, active);
+	}
+	_compatibility.finalise();
+
+	OX_LOG(Logger::LOG_INFO, "Patch compatibility: %d keys, %d compatible pairs, %d compatible pairs of particle types", _compatibility.N_keys(), _compatibility.N_pairs(), _compatibility.N_type_pairs());
+}
+
 template<typename number>
 void PatchyShapeInteraction<number>::allocate_particles(BaseParticle<number> **particles, int N) {
 	for(int i = 0; i < N; i++) {
@@ -1264,6 +1319,18 @@ void PatchyShapeInteraction<number>::read_topology(int N, int *N_strands, BasePa
 
     this->N_patches = patch_index;
     delete [] line;
+
+    int *patches_per_particle = new int[N];
+    int *centers_per_particle = new int[N];
+    for(int i = 0; i < N; i++) {
+    	patches_per_particle[i] = static_cast<PatchyShapeParticle<number> *>(particles[i])->N_patches;
+    	centers_per_particle[i] = particles[i]->N_int_centers;
+    }
+    this->_bonds.init(N, patches_per_particle);
+    this->_store.init(N, patches_per_particle, centers_per_particle);
+    for(int i = 0; i < N; i++) static_cast<PatchyShapeParticle<number> *>(particles[i])->attach_to_store(&this->_store);
+    delete [] patches_per_particle;
+    delete [] centers_per_particle;
 }
 
 
@@ -1276,7 +1343,24 @@ void PatchyShapeInteraction<number>::check_input_sanity(BaseParticle<number> **p
 
 
 template<typename number>
-number PatchyShapeInteraction<number>::just_two_patch_interaction(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, int pi,int  qi,LR_vector<number> *r)
+size_t PatchyShapeInteraction<number>::get_state_size(int N) {
+	return this->_bonds.get_state_size();
+}
+
+template<typename number>
+void PatchyShapeInteraction<number>::write_state(BaseParticle<number> **particles, int N, char *buffer) {
+	this->_bonds.write_state(buffer);
+}
+
+template<typename number>
+void PatchyShapeInteraction<number>::read_state(BaseParticle<number> **particles, int N, const char *buffer) {
+	this->_bonds.read_state(buffer);
+	_locks_restored = true;
+}
+
+
+template<typename number>
+number PatchyShapeInteraction<number>::just_two_patch_interaction(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, int pi,int  qi,LR_vector<number> *r, bool check_locks)
 {
 	number rnorm = r->norm();
 	if(rnorm > this->_sqr_rcut) return (number) 0.f;
@@ -1287,7 +1371,9 @@ number PatchyShapeInteraction<number>::just_two_patch_interaction(PatchyShapePar
 	PatchyShapeParticle<number> *qq = static_cast<PatchyShapeParticle<number> *>(q);
 
     LR_vector<number> ppatch = p->int_centers[pi];
-	if(this->_bonding_allowed(pp,qq,pi,qi) )
+	bool allowed = (this->_compatibility.mask(p->type, pi, q->type) >> qi) & 1ULL;
+	allowed = allowed && (this->_same_type_bonding || this->_no_multipatch || p->type != q->type);
+	if(allowed && (!check_locks || this->_locks_allow(pp->index,pi,qq->index,qi)))
 	{
 				number K = pp->patches[pi].strength;
 			    LR_vector<number> qpatch = q->int_centers[qi];
@@ -1392,135 +1478,182 @@ void PatchyShapeInteraction<number>::_init_icosahedron(void)
 			}
 		}
 	}
+
+	// data used by the separating axis test: vertexes come in opposite pairs, and so do faces
+	int N_half = 0;
+	for (int i = 0; i < 12; i ++) {
+		_antipodal_vertexes[i] = -1;
+		for (int j = 0; j < 12; j ++) {
+			if ((tmp.int_centers[i] + tmp.int_centers[j]).norm() < (number) 1.e-6) _antipodal_vertexes[i] = j;
+		}
+		if (_antipodal_vertexes[i] < 0) throw oxDNAException("something wrong while initializing hardico interaction: vertex %d has no opposite vertex", i);
+		if (_antipodal_vertexes[i] > i) {
+			_half_vertexes[N_half] = i;
+			N_half ++;
+		}
+	}
+
+	// faces are made of a vertex and two consecutive close vertexes
+	int N_faces = 0;
+	for (int i = 0; i < 12; i ++) {
+		for (int j = 0; j < 5; j ++) {
+			int a = _close_vertexes[5*i + j];
+			int b = _close_vertexes[5*i + (j + 1) % 5];
+			// each face is found three times, once for each of its vertexes
+			if (i > a || i > b) continue;
+			// and we keep it only if we haven't found the opposite face yet
+			bool opposite_found = false;
+			for (int f = 0; f < N_faces && !opposite_found; f ++) {
+				int n_opposite = 0;
+				for (int k = 0; k < 3; k ++) {
+					int v = _half_faces[3*f + k];
+					if (v == _antipodal_vertexes[i] || v == _antipodal_vertexes[a] || v == _antipodal_vertexes[b]) n_opposite ++;
+				}
+				if (n_opposite == 3) opposite_found = true;
+			}
+			if (opposite_found) continue;
+			if (N_faces == 10) throw oxDNAException("something wrong while initializing hardico interaction: too many faces");
+			_half_faces[3*N_faces + 0] = i;
+			_half_faces[3*N_faces + 1] = a;
+			_half_faces[3*N_faces + 2] = b;
+			N_faces ++;
+		}
+	}
+	if (N_faces != 10) throw oxDNAException("something wrong while initializing hardico interaction: found %d pairs of faces instead of 10", N_faces);
 }
 
 
 template<typename number>
 void PatchyShapeInteraction<number>::_init_patchy_locks(ConfigInfo<number>  *Info)
 {
+	// the locks of a restarted simulation must be the ones it was stopped with
+	if(_locks_restored) return;
+
 	if (Info == NULL)
 	{
 		Info = &ConfigInfo<number>::ref_instance();
 	}
 
-	//printf("!!INITPATCHY: Starting locking, we have %d particles\n",*Info->N);
 	Info->lists->global_update();
-	for(int pid = 0; pid < *Info->N; pid++)
-	{
-		PatchyShapeParticle<number> *p = static_cast< PatchyShapeParticle<number> *>(Info->particles[pid]);
-		//printf("XXXXXXXXXXXXXXXXXXxParticle has %d partches\n",p->N_patches);
-		//fflush(stdout);
-		//p->_set_vertexes();
-		p->unlock_patches();
-	}
+	this->_bonds.clear();
 
+	// a lock replaces the previous locks of its patches, hence the neighbours are visited in order of increasing index
+	std::vector<int> neighs;
 	for(int pid = 0; pid < *Info->N; pid++)
 	{
-
 		PatchyShapeParticle<number> *p = static_cast< PatchyShapeParticle<number> *>(Info->particles[pid]);
-		//printf("Pidf is %d, p->index is %d\n",pid,p->index);
 
-		//std::vector<BaseParticle<number> *> neighs = Info->lists->get_neigh_list(p);;
-		for(int n = pid+1; n < *Info->N; n++) {
-			PatchyShapeParticle<number> *qq =   static_cast< PatchyShapeParticle<number> *>(Info->particles[n]);
-			//printf("qid is %d, qq->index is %d\n",n,qq->index);
+		Info->lists->fill_neigh_list(p, this->_lock_neighs);
+		neighs.clear();
+		for(unsigned int j = 0; j < this->_lock_neighs.size(); j++) {
+			if(this->_lock_neighs[j]->index > pid) neighs.push_back(this->_lock_neighs[j]->index);
+		}
+		std::sort(neighs.begin(), neighs.end());
+
+		for(unsigned int j = 0; j < neighs.size(); j++) {
+			PatchyShapeParticle<number> *qq = static_cast< PatchyShapeParticle<number> *>(Info->particles[neighs[j]]);
 
 			LR_vector<number> r = Info->box->min_image(p,qq);
 			for(int ppatch = 0; ppatch < p->N_patches; ppatch++)
 			{
 				for(int qqpatch = 0; qqpatch < qq->N_patches; qqpatch++)
 				{
-
 					number new_ene = this->just_two_patch_interaction(p,qq,ppatch,qqpatch,&r);
-
-					if(new_ene < this->get_patch_cutoff_energy())
-					{
-						//throw oxDNAException("Locking ");
-						p->patches[ppatch].set_lock(qq->index,qqpatch);
-						qq->patches[qqpatch].set_lock(p->index,ppatch);
-						//printf("!!INITPATCHY: Locking %d (%d) to %d (%d) \n",p->index,ppatch,qq->index,qqpatch);
-					}
+					if(new_ene < this->get_patch_cutoff_energy()) this->_bonds.lock(p->index,ppatch,qq->index,qqpatch);
 				}
 			}
 		}
 	}
+}
 
-	/*
-	for(int pid = 0; pid < *Info->N; pid++)
-	{
-		PatchyShapeParticle<number> *p = dynamic_cast< PatchyShapeParticle<number> *>(Info->particles[pid]);
-		//p->unlock_patches();
 
-		printf("Afterwards Particle %d: , patches: ",pid);
-		for(int kk = 0; kk < p->N_patches; kk++)
-		{
-			printf(" %d-(%d %d) ",kk,p->patches[kk].locked_to_particle,p->patches[kk].locked_to_patch);
+template<typename number>
+ParticleClusters &PatchyShapeInteraction<number>::get_clusters(ConfigInfo<number> *Info) {
+	if(this->_no_multipatch) return this->_bonds.get_clusters();
+
+	if(Info == NULL) Info = &ConfigInfo<number>::ref_instance();
+
+	_energy_clusters.reset(*Info->N);
+	for(int i = 0; i < *Info->N; i++) {
+		BaseParticle<number> *p = Info->particles[i];
+		Info->lists->fill_neigh_list(p, _cluster_neighs);
+		for(unsigned int j = 0; j < _cluster_neighs.size(); j++) {
+			BaseParticle<number> *q = _cluster_neighs[j];
+			if(p->index < q->index && this->pair_interaction_term(PATCHY, p, q) < 0) _energy_clusters.join(p->index, q->index);
 		}
-		printf("\n");
-
 	}
-*/
-	//throw oxDNAException("Finished init");
-}
 
+	return _energy_clusters;
+}
 
 template<typename number>
-void PatchyShapeInteraction<number>::check_patchy_locks(ConfigInfo<number>  *Info)
+void PatchyShapeInteraction<number>::_check_particle_locks(PatchyShapeParticle<number> *p, ConfigInfo<number> *Info, bool lower_only)
 {
-	if (Info == NULL) {
-		Info = &ConfigInfo<number>::ref_instance();
+	int pid = p->index;
+
+	// the locks p has should be symmetric and between patches that are close enough
+	for(int ppatch = 0; ppatch < p->N_patches; ppatch++) {
+		int qid, qqpatch;
+		this->_bonds.get_lock(pid, ppatch, qid, qqpatch);
+		if(qid < 0) continue;
+		if(!this->_bonds.locked_to(qid, qqpatch, pid, ppatch)) throw oxDNAException("Found an asymmetric lock: %d (%d) is locked to %d (%d), but not vice versa", pid, ppatch, qid, qqpatch);
+
+		PatchyShapeParticle<number> *qq = static_cast< PatchyShapeParticle<number> *>(Info->particles[qid]);
+		LR_vector<number> r = Info->box->min_image(p,qq);
+		// the energy of a pair of patches has to be computed regardless of the locks they already have
+		number new_ene = this->just_two_patch_interaction(p,qq,ppatch,qqpatch,&r,false);
+		if(new_ene >= this->get_patch_cutoff_energy()) throw oxDNAException("Found a wrong lock, they should be not locked: %d (%d) - %d (%d), %f",pid,ppatch,qid,qqpatch,new_ene);
 	}
 
-	//Info->lists->global_update();
-	for(int pid = 0; pid < *Info->N; pid++)
-	{
-		PatchyShapeParticle<number> *p = static_cast< PatchyShapeParticle<number> *>(Info->particles[pid]);
-		//std::vector<BaseParticle<number> *> neighs = Info->lists->get_neigh_list(p);
-		for(int qid = 0; qid < pid; qid++) {
-			PatchyShapeParticle<number> *qq =   static_cast< PatchyShapeParticle<number> *>(Info->particles[qid]);
+	// and the patches that are close enough should be locked, either to each other or to someone else
+	Info->lists->fill_neigh_list(p, this->_lock_neighs);
+	for(unsigned int j = 0; j < this->_lock_neighs.size(); j++) {
+		PatchyShapeParticle<number> *qq = static_cast< PatchyShapeParticle<number> *>(this->_lock_neighs[j]);
+		int qid = qq->index;
+		if(lower_only && qid > pid) continue;
 
-			LR_vector<number> r = Info->box->min_image(p,qq);
-			for(int ppatch = 0; ppatch < p->N_patches; ppatch++)
+		LR_vector<number> r = Info->box->min_image(p,qq);
+		for(int ppatch = 0; ppatch < p->N_patches; ppatch++)
+		{
+			for(int qqpatch = 0; qqpatch < qq->N_patches; qqpatch++)
 			{
-				for(int qqpatch = 0; qqpatch < qq->N_patches; qqpatch++)
+				number new_ene = this->just_two_patch_interaction(p,qq,ppatch,qqpatch,&r,false);
+				if(new_ene < this->get_patch_cutoff_energy())
 				{
-
-					this->_no_multipatch = false;
-					number new_ene = this->just_two_patch_interaction(p,qq,ppatch,qqpatch,&r);
-					this->_no_multipatch = true;
-
-					if(new_ene < this->get_patch_cutoff_energy())
-					{
-						// either the particles are locked to each other
-						bool mutual_lock = p->patches[ppatch].locked_to(qid,qqpatch) && qq->patches[qqpatch].locked_to(pid,ppatch);
-						// or either of them is locked to somone else
-						bool external_lock = p->patches[ppatch].is_locked() || qq->patches[qqpatch].is_locked(); 
-
-						//This can be either already locked:
-						if (mutual_lock == false and external_lock == false) {
-							printf("particles %d (patch %d) and %d (patch %d) have energy %g\n", pid, ppatch, qid, qqpatch, new_ene);
-							int tmpi, tmpj;
-							p->patches[ppatch].get_lock(tmpi, tmpj);
-							printf("%d(%d) locked to %d(%d)\n", pid, ppatch, tmpi, tmpj);
-							qq->patches[qqpatch].get_lock(tmpi, tmpj);
-							printf("%d(%d) locked to %d(%d)\n", qid, qqpatch, tmpi, tmpj);
-							throw oxDNAException("Found a case where lock is missing: %d (%d) - %d (%d), %f ",pid,ppatch,qid,qqpatch, new_ene);
-						}
-					}
-					else //they should not be locked to each other!
-					{
-						if(p->patches[ppatch].locked_to(qid,qqpatch) || qq->patches[qqpatch].locked_to(pid,ppatch))
-						{
-							throw oxDNAException("Found a wrong lock, they should be not locked: %d (%d) - %d (%d), %f",pid,ppatch,qid,qqpatch,new_ene);
-						}
-
-					}
+					bool mutual_lock = this->_bonds.locked_to(pid,ppatch,qid,qqpatch);
+					bool external_lock = this->_bonds.is_locked(pid,ppatch) || this->_bonds.is_locked(qid,qqpatch);
+					if (mutual_lock == false and external_lock == false) throw oxDNAException("Found a case where lock is missing: %d (%d) - %d (%d), %f ",pid,ppatch,qid,qqpatch, new_ene);
 				}
 			}
 		}
 	}
 }
 
+template<typename number>
+void PatchyShapeInteraction<number>::check_patchy_locks(ConfigInfo<number>  *Info, int N_particles)
+{
+	if(!this->_no_multipatch) return;
+	if (Info == NULL) {
+		Info = &ConfigInfo<number>::ref_instance();
+	}
+
+	int N = *Info->N;
+	if(N_particles < 0 || N_particles >= N) {
+		this->_bonds.check_consistency();
+		for(int pid = 0; pid < N; pid++) _check_particle_locks(static_cast< PatchyShapeParticle<number> *>(Info->particles[pid]), Info, true);
+	}
+	else {
+		if(!_lock_check_rng_ready) {
+			_lock_check_rng = RandomManager::instance()->make_stream(PATCHY_LOCK_CHECK_STREAM);
+			_lock_check_rng_ready = true;
+		}
+		for(int i = 0; i < N_particles; i++) {
+			int pid = (int) (_lock_check_rng.uniform() * N);
+			_check_particle_locks(static_cast< PatchyShapeParticle<number> *>(Info->particles[pid]), Info, false);
+		}
+	}
+}
+
 
 template class PatchyShapeInteraction<float>;
 template class PatchyShapeInteraction<double>;
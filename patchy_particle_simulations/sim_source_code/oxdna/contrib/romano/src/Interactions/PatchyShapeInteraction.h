@@ -38,8 +38,14 @@
 //there are two types of modulation
 #define PLEXCL_NARROW_N 2
 
+//maximum number of patches per particle, set by the size of the masks of compatible patches
+#define PLPATCHY_MAX_PATCHES 64
+
 #include "../../../../src/Interactions/BaseInteraction.h"
 #include "../Particles/PatchyShapeParticle.h"
+#include "PatchyBondGraph.h"
+#include "PatchCompatibility.h"
+#include "../../../../src/Utilities/RandomStream.h"
 #include "../../../../src/Observables/BaseObservable.h"
 /**
  * @brief Manages the interaction between simple patchy particles, each can have multiple patches of different colors and rigid body of different shapes (
@@ -56,7 +62,7 @@ particle_file = <string> (name of the file with particle types)
 use_torsion = <bool> (use or not use torsion constraints for binding, default to 1)
 same_type_bonding = <bool> (two particles of the same type can bind, default to 1)
 narrow_type = <int> (for lj48 like interaction, sets the type of narrowness of the bonds)
-interaction_tensor = <bool> (false by default; if true, possible interactions are loaded from a file specified by the option below)
+interaction_tensor = <bool> (false by default; if true, possible interactions are loaded from a file specified by the option below, and the colours of the patches are ignored)
 interaction_tensor_file = <string> (filename of the interaction tensor file; interactions specified in a following way described below)
 same_type_bonding = <bool> (particles of the same type can bond)
 no_multipatch = <bool> (if set to 1, the code does not allow 1 patch binding to more than 1 other patch, and uses the lock patch; only works if used with MC2 and special move MCPatchyShapeMove
@@ -117,14 +123,38 @@ protected:
 
     bool _interaction_tensor;
 
-    int *_interaction_table_types; //a 2d matrix of _N_particle_types * _N_particle_types that checks if 2 particles can interact (filled with 0 and 1)
-    //int *_interaction_table_types;
-    int *_interaction_patch_types; //a 2d matrix of patches (each patch has a unique id) that checks if patches can interact; is only used if interaction tensor is true
+    /// which patches can bind to which, built either from the colours of the patches or from the interaction tensor
+    PatchCompatibility _compatibility;
 
     bool _no_multipatch;
 
     number _lock_cutoff;
 
+    /// patch locks used when _no_multipatch is true
+    PatchyBondGraph _bonds;
+    /// true if the locks have been restored with read_state, in which case _init_patchy_locks leaves them alone
+    bool _locks_restored;
+    std::vector<BaseParticle<number> *> _lock_neighs;
+    /// stream used to pick the particles checked by check_patchy_locks, so that checking does not change the trajectory. Created on first use
+    RandomStream _lock_check_rng;
+    bool _lock_check_rng_ready;
+
+    /**
+     * @brief Checks the locks of p and the locks it should have with its neighbours, throwing an oxDNAException if they are wrong
+     *
+     * @param p
+     * @param Info
+     * @param lower_only if true only the neighbours with a smaller index are considered, so that each pair is checked once when all the particles are
+     */
+    void _check_particle_locks(PatchyShapeParticle<number> *p, ConfigInfo<number> *Info, bool lower_only);
+
+    /// clusters of particles with a negative patchy energy, used when _no_multipatch is false
+    ParticleClusters _energy_clusters;
+    std::vector<BaseParticle<number> *> _cluster_neighs;
+
+    /// positions, colours and strengths of the patches of all the particles, stored contiguously
+    PatchyShapeStore<number> _store;
+
 	Patch<number> *_patch_types;
 	PatchyShapeParticle<number> *_particle_types;
 
@@ -139,7 +169,11 @@ protected:
 
 	//icosahedron constants
 	int *_close_vertexes; // 5 close vertexes for each vertex
+	Counter *_overlap_tests;
 	number _tworinscribed ; // twice the radius of inscribed sphere
+	int _antipodal_vertexes[12]; // the vertex opposite to each vertex
+	int _half_vertexes[6]; // one vertex for each pair of opposite vertexes
+	int _half_faces[10 * 3]; // one face for each pair of parallel faces
 
 
 public:
@@ -147,6 +181,17 @@ public:
 	bool _patches_compatible(PatchyShapeParticle<number>  *p, PatchyShapeParticle<number>  *q, int pi, int pj );
 
 
+	/// the key used by _compatibility: patches are labelled by their colour or, when the interaction tensor is used, by their id
+	int _compatibility_key(const Patch<number> &patch) {
+		return (this->_interaction_tensor) ? patch.id : patch.color;
+	}
+	void _init_compatibility(std::string *tensor_file);
+	/// returns false if the two patches cannot bind because (at least) one of them is locked to somebody else
+	bool _locks_allow(int p, int pi, int q, int pj) {
+		if(!this->_no_multipatch) return true;
+		return this->_bonds.locked_to(p,pi,q,pj) || (!this->_bonds.is_locked(p,pi) && !this->_bonds.is_locked(q,pj));
+	}
+
 	number _V_mod(int type, number cosr1);
 	number _V_modD(int type, number cosr1);
 	number _V_modDsin(int type, number cosr1);
@@ -157,6 +202,9 @@ public:
 
 	number _exc_LJ_vol_interaction_sphere(BaseParticle<number> *p, BaseParticle<number> *q, LR_vector<number> *r, bool update_forces);
 	number  _exc_vol_hard_icosahedron(BaseParticle<number> *p, BaseParticle<number> *q, LR_vector<number> *r,bool update_forces);
+	number _ico_half_extent(const LR_vector<number> *vertexes, const LR_vector<number> &axis);
+	bool _ico_separated_along(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, const LR_vector<number> &my_r, const LR_vector<number> &axis);
+	bool _icosahedra_separated(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, const LR_vector<number> &my_r);
 	//inline number _exc_quadratic_vol_interaction(BaseParticle<number> *p, BaseParticle<number> *q, LR_vector<number> *r, bool update_forces);
 
 
@@ -165,25 +213,50 @@ public:
 	virtual bool multipatch_allowed(void) {return  ! this->_no_multipatch;}
 
 	//true if particles of of this type can interact
-    bool can_interact(BaseParticle<number> *p, BaseParticle<number> *q) {return (bool) this->_interaction_table_types[p->type*_N_particle_types + q->type]; }
+    bool can_interact(BaseParticle<number> *p, BaseParticle<number> *q) {
+    	if(!this->_same_type_bonding && !this->_no_multipatch && p->type == q->type) return false;
+    	return this->_compatibility.types_compatible(p->type, q->type);
+    }
 
 	//virtual int check_valence(ConfigInfo<number> &conf_info) {return 0;} //scans all interacting particles if one patch is bond to more particles, it breaks all bonds but 1;
-	virtual number just_two_patch_interaction(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, int pi,int  qi,LR_vector<number> *r);
+	/// if check_locks is false the energy is computed as if the two patches were not locked to anything
+	virtual number just_two_patch_interaction(PatchyShapeParticle<number> *p, PatchyShapeParticle<number> *q, int pi,int  qi,LR_vector<number> *r, bool check_locks=true);
 
 	number get_patch_cutoff_energy() {return this->_lock_cutoff;}
 
+	/// the locks between patches, which are the bonds of the system when no_multipatch is true. Moves that change them should do so within a transaction (see PatchyBondGraph::begin)
+	PatchyBondGraph &get_bond_graph() {return this->_bonds;}
+
+	/**
+	 * @brief Returns the clusters of bonded particles. If no_multipatch is true, two particles are bonded if they are locked
+	 * to each other, and the clusters are kept up to date by the bond graph. Otherwise they are bonded if their patchy
+	 * energy is negative, and the clusters are computed from scratch.
+	 */
+	ParticleClusters &get_clusters(ConfigInfo<number> *Info = NULL);
+
+	/// the system-wide patch store, filled in by read_topology and kept up to date by PatchyShapeParticle::set_positions
+	const PatchyShapeStore<number> &get_patch_store() {return this->_store;}
+
 	Patch<number> _process_patch_type(std::string input_string); //this function processes patch type from the input file
 	PatchyShapeParticle<number> _process_particle_type(std::string input_string);
 
     void _load_patchy_particle_files(std::string& patchy_file, std::string& particle_file);
 
-    void _load_interaction_tensor(std::string &tensor_file); //only used if tensor file provided
+    void _load_interaction_tensor(std::string &tensor_file, std::vector<std::pair<int, int> > &pairs); //only used if tensor file provided
 
     void _init_icosahedron(void);
 
     void _init_patchy_locks(ConfigInfo<number> *_Info = NULL);
 
-    void check_patchy_locks(ConfigInfo<number> *_Info = NULL);
+    /**
+     * @brief Checks that the locks are consistent with the patchy energies. Both the locks and the patch pairs that are
+     * close enough to be locked are looked for with the neighbour lists, and hence the lists must be up to date. Does
+     * nothing if no_multipatch is false, since the locks are not used.
+     *
+     * @param _Info
+     * @param N_particles if non-negative and smaller than N, only the locks of N_particles particles picked at random are checked, in O(N_particles) time
+     */
+    void check_patchy_locks(ConfigInfo<number> *_Info = NULL, int N_particles = -1);
 
 public:
 	enum {
@@ -220,6 +293,11 @@ public:
 	virtual void read_topology(int N, int *N_strands, BaseParticle<number> **particles);
 	virtual void check_input_sanity(BaseParticle<number> **particles, int N);
 
+	//the state is made of the patch locks (see PatchyBondGraph::write_state)
+	virtual size_t get_state_size(int N);
+	virtual void write_state(BaseParticle<number> **particles, int N, char *buffer);
+	virtual void read_state(BaseParticle<number> **particles, int N, const char *buffer);
+
 	//virtual void generate_random_configuration(BaseParticle<number> **particles, int N, number box_side);
 };
 
@@ -1,5 +1,5 @@
 /*
- * HBEnergy.h
+ * PLCluster.h
  *
  *  Created on: Feb 14, 2013
  *      Author: petr
@@ -12,11 +12,15 @@
 #include "../../../../src/Observables/BaseObservable.h"
 
 /**
- * @brief Prints out all the interactions between all pairs of nucleotides with non-zero interaction energies (default) or between a pair of nucleotides (if specified)
+ * @brief Prints out the number of clusters of bonded particles, followed by the sorted list of the types (or indexes) of
+ * the particles of each cluster. Isolated particles are not printed.
+ *
+ * The clusters are provided by PatchyShapeInteraction::get_clusters: with no_multipatch = true they are kept up to date
+ * as the patch locks change, and printing them takes linear time.
  *
  * @verbatim
-particle1_id = <int> (particle 1 id)
-particle2_id = <int> (particle 2 id)
+show_types = <bool> (if true print the types of the particles of each cluster, otherwise their indexes)
+[check_locks = <bool> (if true check that the patch locks are consistent with the patchy energies before printing, which takes O(N) time. Defaults to false)]
 @endverbatim
  */
 template<typename number>
@@ -24,6 +28,11 @@ class PLCluster: public BaseObservable<number> {
 protected:
 
     bool _show_types ;
+    bool _check_locks;
+
+    /// _cluster_index[i] is the index of the cluster whose representative is particle i, or -1
+    std::vector<int> _cluster_index;
+    std::vector<std::vector<int> > _members;
 public:
 	PLCluster();
 	virtual ~PLCluster();
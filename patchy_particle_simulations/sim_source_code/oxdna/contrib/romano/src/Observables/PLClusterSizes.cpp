@@ -0,0 +1,60 @@
+/*
+ * PLClusterSizes.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include "PLClusterSizes.h"
+#include "../Interactions/PatchyShapeInteraction.h"
+
+#include <sstream>
+
+template<typename number>
+PLClusterSizes<number>::PLClusterSizes() {
+	_only_largest = false;
+}
+
+template<typename number>
+PLClusterSizes<number>::~PLClusterSizes() {
+
+}
+
+template<typename number>
+void PLClusterSizes<number>::get_settings(input_file &my_inp, input_file &sim_inp) {
+	getInputBool(&my_inp, "only_largest", &_only_largest, 0);
+}
+
+template<typename number>
+std::string PLClusterSizes<number>::get_output_string(llint curr_step) {
+	PatchyShapeInteraction<number> *interaction = dynamic_cast<PatchyShapeInteraction<number> * >(this->_config_info.interaction);
+	if(interaction == NULL) throw oxDNAException("PLClusterSizes can only be used with PatchyShapeInteraction");
+
+	ParticleClusters &clusters = interaction->get_clusters(&this->_config_info);
+	int N = *this->_config_info.N;
+
+	// each cluster is counted once, when its representative is found
+	_histogram.assign(N + 1, 0);
+	int largest = 0;
+	int N_clusters = 0;
+	for(int i = 0; i < N; i++) {
+		if(clusters.find(i) != i) continue;
+		int size = clusters.size(i);
+		_histogram[size]++;
+		N_clusters++;
+		if(size > largest) largest = size;
+	}
+
+	std::stringstream out;
+	if(_only_largest) out << largest << " " << N_clusters;
+	else {
+		for(int s = 1; s <= largest; s++) {
+			if(s > 1) out << " ";
+			out << _histogram[s];
+		}
+	}
+	return out.str();
+}
+
+template class PLClusterSizes<float>;
+template class PLClusterSizes<double>;
@@ -0,0 +1,43 @@
+/*
+ * PLClusterSizes.h
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#ifndef PLCLUSTERSIZES_H_
+#define PLCLUSTERSIZES_H_
+
+#define MCMOVE_CUSTOM
+#include "../../../../src/Observables/BaseObservable.h"
+
+/**
+ * @brief Prints out the cluster-size histogram of the system: the number of clusters made of 1, 2, ..., M bonded
+ * particles, where M is the size of the largest cluster. Isolated particles are counted as clusters of size 1.
+ *
+ * The clusters are the same used by PLCluster. With no_multipatch = true they are kept up to date as the patch locks
+ * change, and computing the histogram takes linear time.
+ *
+ * @verbatim
+[only_largest = <bool> (if true print only the size of the largest cluster and the number of clusters. Defaults to false)]
+@endverbatim
+ */
+template<typename number>
+class PLClusterSizes: public BaseObservable<number> {
+protected:
+	bool _only_largest;
+	std::vector<int> _histogram;
+
+public:
+	PLClusterSizes();
+	virtual ~PLClusterSizes();
+
+	std::string get_output_string(llint curr_step);
+
+	virtual void get_settings(input_file &my_inp, input_file &sim_inp);
+};
+
+extern "C" BaseObservable<float> * make_PLClusterSizes_float() { return new PLClusterSizes<float>(); }
+extern "C" BaseObservable<double> * make_PLClusterSizes_double() { return new PLClusterSizes<double>(); }
+
+#endif /* PLCLUSTERSIZES_H_ */
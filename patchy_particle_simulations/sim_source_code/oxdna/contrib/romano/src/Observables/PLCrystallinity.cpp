@@ -0,0 +1,237 @@
+/*
+ * PLCrystallinity.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include "PLCrystallinity.h"
+#include "../Interactions/PatchyShapeInteraction.h"
+
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cctype>
+
+template<typename number>
+PLCrystallinity<number>::PLCrystallinity() : _N_positions(0), _N_types(0) {
+	// the rotations of sat.py: a particle placed with rotation r puts its patch _rotation[r][s] in slot s
+	const int rotations[N_ROTATIONS][N_SLOTS] = {
+			{0, 1, 2, 3, 4, 5},
+			{1, 2, 0, 4, 5, 3},
+			{2, 0, 1, 5, 3, 4},
+			{3, 5, 4, 0, 2, 1},
+			{5, 4, 3, 2, 1, 0},
+			{4, 3, 5, 1, 0, 2}
+	};
+
+	for(int s = 0; s < N_SLOTS; s++) {
+		for(int k = 0; k < N_SLOTS; k++) _rotation_for[s][k] = -1;
+	}
+	for(int r = 0; r < N_ROTATIONS; r++) {
+		for(int s = 0; s < N_SLOTS; s++) {
+			int k = rotations[r][s];
+			_rotation[r][s] = k;
+			_slot_of[r][k] = s;
+			_rotation_for[s][k] = r;
+		}
+	}
+}
+
+template<typename number>
+PLCrystallinity<number>::~PLCrystallinity() {
+
+}
+
+template<typename number>
+void PLCrystallinity<number>::get_settings(input_file &my_inp, input_file &sim_inp) {
+	getInputString(&my_inp, "target_file", _target_file, 1);
+}
+
+template<typename number>
+void PLCrystallinity<number>::init(ConfigInfo<number> &config_info) {
+	BaseObservable<number>::init(config_info);
+
+	PatchyShapeInteraction<number> *interaction = dynamic_cast<PatchyShapeInteraction<number> * >(this->_config_info.interaction);
+	if(interaction == NULL) throw oxDNAException("PLCrystallinity can only be used with PatchyShapeInteraction");
+	if(interaction->multipatch_allowed()) throw oxDNAException("PLCrystallinity requires no_multipatch = true");
+
+	for(int i = 0; i < *this->_config_info.N; i++) {
+		BaseParticle<number> *p = this->_config_info.particles[i];
+		if(p->N_int_centers != N_SLOTS) throw oxDNAException("PLCrystallinity requires particles with %d patches, but particle %d has %d", N_SLOTS, i, p->N_int_centers);
+		if(p->type >= _N_types) _N_types = p->type + 1;
+	}
+
+	_load_target();
+}
+
+template<typename number>
+void PLCrystallinity<number>::_load_target() {
+	std::ifstream inp(_target_file.c_str());
+	if(!inp.good()) throw oxDNAException("PLCrystallinity: cannot open target_file '%s'", _target_file.c_str());
+
+	std::vector<int> bond_lines;
+	std::vector<int> placements;
+	std::string line;
+	while(std::getline(inp, line)) {
+		if(line.find("binds to") != std::string::npos) {
+			// the four numbers are position, slot, position, slot
+			std::string digits(line);
+			for(unsigned int c = 0; c < digits.size(); c++) {
+				if(!isdigit(digits[c])) digits[c] = ' ';
+			}
+			std::istringstream ss(digits);
+			int values[4];
+			for(int v = 0; v < 4; v++) ss >> values[v];
+			if(ss.fail()) throw oxDNAException("PLCrystallinity: malformed line in '%s': %s", _target_file.c_str(), line.c_str());
+			for(int v = 0; v < 4; v++) bond_lines.push_back(values[v]);
+		}
+		else {
+			int p, a, r;
+			if(sscanf(line.c_str(), " P(%d,%d,%d)", &p, &a, &r) == 3) {
+				placements.push_back(p);
+				placements.push_back(a);
+				placements.push_back(r);
+			}
+		}
+	}
+
+	_N_positions = 0;
+	for(unsigned int b = 0; b < bond_lines.size(); b += 2) {
+		if(bond_lines[b + 1] >= N_SLOTS) throw oxDNAException("PLCrystallinity: invalid slot %d in '%s'", bond_lines[b + 1], _target_file.c_str());
+		if(bond_lines[b] >= _N_positions) _N_positions = bond_lines[b] + 1;
+	}
+	if(_N_positions == 0) throw oxDNAException("PLCrystallinity: no bonds found in '%s'", _target_file.c_str());
+
+	_partner_pos.assign(_N_positions*N_SLOTS, -1);
+	_partner_slot.assign(_N_positions*N_SLOTS, -1);
+	for(unsigned int b = 0; b < bond_lines.size(); b += 4) {
+		int first = bond_lines[b]*N_SLOTS + bond_lines[b + 1];
+		int second = bond_lines[b + 2]*N_SLOTS + bond_lines[b + 3];
+		if(_partner_pos[first] != -1 || _partner_pos[second] != -1 || first == second) throw oxDNAException("PLCrystallinity: slot %d of position %d or slot %d of position %d appears in more than one bond in '%s'", bond_lines[b + 1], bond_lines[b], bond_lines[b + 3], bond_lines[b + 2], _target_file.c_str());
+		_partner_pos[first] = bond_lines[b + 2];
+		_partner_slot[first] = bond_lines[b + 3];
+		_partner_pos[second] = bond_lines[b];
+		_partner_slot[second] = bond_lines[b + 1];
+	}
+	for(int n = 0; n < _N_positions*N_SLOTS; n++) {
+		if(_partner_pos[n] == -1) throw oxDNAException("PLCrystallinity: slot %d of position %d is not bound to anything in '%s'", n % N_SLOTS, n / N_SLOTS, _target_file.c_str());
+	}
+
+	_allowed.clear();
+	if(placements.size() > 0) {
+		_allowed.assign(_N_positions*_N_types*N_ROTATIONS, false);
+		for(unsigned int i = 0; i < placements.size(); i += 3) {
+			int p = placements[i];
+			int a = placements[i + 1];
+			int r = placements[i + 2];
+			if(p < 0 || p >= _N_positions || r < 0 || r >= N_ROTATIONS) throw oxDNAException("PLCrystallinity: invalid placement P(%d,%d,%d) in '%s'", p, a, r, _target_file.c_str());
+			if(a >= 0 && a < _N_types) _allowed[(p*_N_types + a)*N_ROTATIONS + r] = true;
+		}
+	}
+
+	OX_LOG(Logger::LOG_INFO, "(PLCrystallinity) Loaded a target crystal with %d positions and %d bonds per unit cell from '%s' (%d placements)", _N_positions, (int) bond_lines.size() / 4, _target_file.c_str(), (int) placements.size() / 3);
+}
+
+template<typename number>
+bool PLCrystallinity<number>::_is_crystalline(PatchyBondGraph &bonds, int i) {
+	int type = this->_config_info.particles[i]->type;
+
+	// neigh[k] is bound to patch k of i through its patch neigh_patch[k]
+	int neigh[N_SLOTS], neigh_patch[N_SLOTS];
+	for(int k = 0; k < N_SLOTS; k++) {
+		bonds.get_lock(i, k, neigh[k], neigh_patch[k]);
+		if(neigh[k] == -1) return false;
+	}
+
+	// the bonds between neighbours: patch j of neigh[k] is bound to patch m_patch of neigh[m]
+	int N_inner = 0;
+	int inner_k[N_SLOTS*N_SLOTS], inner_j[N_SLOTS*N_SLOTS], inner_m[N_SLOTS*N_SLOTS], inner_m_patch[N_SLOTS*N_SLOTS];
+	for(int k = 0; k < N_SLOTS; k++) {
+		for(int j = 0; j < N_SLOTS; j++) {
+			int other, other_patch;
+			bonds.get_lock(neigh[k], j, other, other_patch);
+			if(other == -1 || other == i) continue;
+			for(int m = 0; m < N_SLOTS; m++) {
+				if(neigh[m] == other) {
+					inner_k[N_inner] = k;
+					inner_j[N_inner] = j;
+					inner_m[N_inner] = m;
+					inner_m_patch[N_inner] = other_patch;
+					N_inner++;
+					break;
+				}
+			}
+		}
+	}
+
+	int neigh_pos[N_SLOTS], neigh_rot[N_SLOTS];
+	for(int p = 0; p < _N_positions; p++) {
+		for(int r = 0; r < N_ROTATIONS; r++) {
+			if(!_allowed_placement(p, type, r)) continue;
+
+			// the placement of i fixes those of its neighbours
+			bool good = true;
+			for(int k = 0; k < N_SLOTS && good; k++) {
+				int s = _slot_of[r][k];
+				int partner = p*N_SLOTS + s;
+				neigh_pos[k] = _partner_pos[partner];
+				neigh_rot[k] = _rotation_for[_partner_slot[partner]][neigh_patch[k]];
+				good = neigh_rot[k] != -1 && _allowed_placement(neigh_pos[k], this->_config_info.particles[neigh[k]]->type, neigh_rot[k]);
+				// a particle bound to i through two patches must be given the same placement twice
+				for(int m = 0; m < k && good; m++) {
+					if(neigh[m] == neigh[k]) good = neigh_pos[m] == neigh_pos[k] && neigh_rot[m] == neigh_rot[k];
+				}
+			}
+
+			for(int b = 0; b < N_inner && good; b++) {
+				int k = inner_k[b];
+				int m = inner_m[b];
+				int partner = neigh_pos[k]*N_SLOTS + _slot_of[neigh_rot[k]][inner_j[b]];
+				good = _partner_pos[partner] == neigh_pos[m] && _rotation[neigh_rot[m]][_partner_slot[partner]] == inner_m_patch[b];
+			}
+
+			if(good) return true;
+		}
+	}
+
+	return false;
+}
+
+template<typename number>
+std::string PLCrystallinity<number>::get_output_string(llint curr_step) {
+	PatchyShapeInteraction<number> *interaction = static_cast<PatchyShapeInteraction<number> * >(this->_config_info.interaction);
+	PatchyBondGraph &bonds = interaction->get_bond_graph();
+	int N = *this->_config_info.N;
+
+	int N_crystalline = 0;
+	_crystalline.assign(N, false);
+	for(int i = 0; i < N; i++) {
+		if(_is_crystalline(bonds, i)) {
+			_crystalline[i] = true;
+			N_crystalline++;
+		}
+	}
+
+	_crystallites.reset(N);
+	for(int i = 0; i < N; i++) {
+		if(!_crystalline[i]) continue;
+		for(int k = 0; k < N_SLOTS; k++) {
+			int q, q_patch;
+			bonds.get_lock(i, k, q, q_patch);
+			if(q > i && _crystalline[q]) _crystallites.join(i, q);
+		}
+	}
+
+	int largest = 0;
+	for(int i = 0; i < N; i++) {
+		if(_crystalline[i] && _crystallites.size(i) > largest) largest = _crystallites.size(i);
+	}
+
+	std::stringstream out;
+	out << N_crystalline << " " << largest;
+	return out.str();
+}
+
+template class PLCrystallinity<float>;
+template class PLCrystallinity<double>;
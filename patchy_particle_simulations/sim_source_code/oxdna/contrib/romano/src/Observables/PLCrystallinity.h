@@ -0,0 +1,83 @@
+/*
+ * PLCrystallinity.h
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#ifndef PLCRYSTALLINITY_H_
+#define PLCRYSTALLINITY_H_
+
+#define MCMOVE_CUSTOM
+#include "../../../../src/Observables/BaseObservable.h"
+#include "../Interactions/PatchyBondGraph.h"
+
+/**
+ * @brief Compares the bonds of each particle with those of a target crystal and prints the number of crystalline
+ * particles and the size of the largest crystallite.
+ *
+ * The target crystal is described by the binding table used by the SAT design scripts (sat_solver_scripts/sat.py): each
+ * line of target_file of the form
+ * @verbatim
+particle: 0 , patch 2 binds to particle 1, patch 5
+@endverbatim
+ * states that slot 2 of position 0 of the unit cell binds to slot 5 of position 1. A particle placed in a position with
+ * rotation r puts its patch rotation(s, r) in slot s, where rotation is the table of the six rotations of sat.py. If the
+ * file also contains lines of the form P(p,a,r), as printed by sat.py for a solution, particles of type a can only be
+ * placed in position p with rotation r; otherwise any particle can be placed anywhere.
+ *
+ * A particle is crystalline if all its patches are locked and it can be placed in the unit cell so that each of its
+ * bonds, and each bond between two of its neighbours, is a bond of the target crystal. Crystallites are clusters of
+ * crystalline particles bonded to each other. The bonds are read from the patch locks, so this observable requires
+ * no_multipatch = true and takes linear time.
+ *
+ * @verbatim
+target_file = <string> (file containing the binding table of the target crystal)
+@endverbatim
+ */
+template<typename number>
+class PLCrystallinity: public BaseObservable<number> {
+protected:
+	enum {
+		N_SLOTS = 6,
+		N_ROTATIONS = 6
+	};
+
+	std::string _target_file;
+	int _N_positions;
+	int _N_types;
+
+	/// the slot (_partner_pos[p*N_SLOTS + s], _partner_slot[p*N_SLOTS + s]) binds to slot s of position p
+	std::vector<int> _partner_pos, _partner_slot;
+	/// _rotation[r][s] is the patch that a particle placed with rotation r puts in slot s
+	int _rotation[N_ROTATIONS][N_SLOTS];
+	/// _slot_of[r][k] is the slot in which a particle placed with rotation r puts its patch k
+	int _slot_of[N_ROTATIONS][N_SLOTS];
+	/// _rotation_for[s][k] is the rotation that puts patch k in slot s
+	int _rotation_for[N_SLOTS][N_SLOTS];
+	/// _allowed[(p*_N_types + a)*N_ROTATIONS + r] is true if particles of type a can be placed in position p with rotation r
+	std::vector<bool> _allowed;
+
+	std::vector<bool> _crystalline;
+	ParticleClusters _crystallites;
+
+	void _load_target();
+	bool _allowed_placement(int p, int type, int r) {
+		return _allowed.empty() || _allowed[(p*_N_types + type)*N_ROTATIONS + r];
+	}
+	bool _is_crystalline(PatchyBondGraph &bonds, int i);
+
+public:
+	PLCrystallinity();
+	virtual ~PLCrystallinity();
+
+	virtual void init(ConfigInfo<number> &config_info);
+	virtual void get_settings(input_file &my_inp, input_file &sim_inp);
+
+	std::string get_output_string(llint curr_step);
+};
+
+extern "C" BaseObservable<float> * make_PLCrystallinity_float() { return new PLCrystallinity<float>(); }
+extern "C" BaseObservable<double> * make_PLCrystallinity_double() { return new PLCrystallinity<double>(); }
+
+#endif /* PLCRYSTALLINITY_H_ */
@@ -13,6 +13,7 @@
 template<typename number>
 PatchyShapeParticle<number>::PatchyShapeParticle(int _N_patches, int _type, int _N_vertexes) :  BaseParticle<number>() {
 	this->type = _type;
+	_store = 0;
 	N_patches =  _N_patches;
 	N_vertexes = _N_vertexes;
 
@@ -35,6 +36,8 @@ PatchyShapeParticle<number>::PatchyShapeParticle(int _N_patches, int _type, int
 
 template<typename number>
 PatchyShapeParticle<number>::~PatchyShapeParticle() {
+	// the interaction centres are owned by the store, so BaseParticle should not free them
+	if(_store != 0) this->int_centers = 0;
 	delete[] patches;
 	delete [] _vertexes;
 }
@@ -48,8 +51,9 @@ void PatchyShapeParticle<number>::copy_from(const BaseParticle<number> &b)
 	  throw oxDNAException("Can't convert particle to PatchyShapeParticle by dynamic cast'. Aborting");
   }
 
-  if( ! (this->int_centers == b.int_centers && this->N_patches == bb->N_patches && this->N_vertexes == bb->N_vertexes)      )
+  if( ! (this->N_int_centers == bb->N_int_centers && this->N_patches == bb->N_patches && this->N_vertexes == bb->N_vertexes)      )
   {
+	if(_store != 0) throw oxDNAException("Can't change the number of patches or vertexes of particle %d, since it is attached to a store. Aborting", this->index);
 	delete [] this->int_centers;
 	delete [] this->patches;
 	delete [] this->_vertexes;
@@ -76,6 +80,39 @@ void PatchyShapeParticle<number>::copy_from(const BaseParticle<number> &b)
        this->_vertexes[i] = bb->_vertexes[i];
   }
 
+  if(_store != 0) _update_store();
+
+}
+
+template<typename number>
+void PatchyShapeParticle<number>::attach_to_store(PatchyShapeStore<number> *store)
+{
+	if(this->index < 0 || this->index >= store->N_particles()) throw oxDNAException("Particle %d does not belong to the patch store. Aborting", this->index);
+	int offset = store->offsets[this->index];
+	int center_offset = store->center_offsets[this->index];
+	if(store->offsets[this->index + 1] - offset != this->N_patches || store->center_offsets[this->index + 1] - center_offset != this->N_int_centers)
+	{
+		throw oxDNAException("The patch store has the wrong size for particle %d. Aborting", this->index);
+	}
+
+	LR_vector<number> *centers = (this->N_int_centers > 0) ? &store->int_centers[center_offset] : 0;
+	for(int i = 0; i < this->N_int_centers; i++) centers[i] = this->int_centers[i];
+	if(_store == 0) delete [] this->int_centers;
+	this->int_centers = centers;
+	_store = store;
+	_update_store();
+}
+
+template<typename number>
+void PatchyShapeParticle<number>::_update_store()
+{
+	int offset = _store->offsets[this->index];
+	for(int i = 0; i < this->N_patches; i++)
+	{
+		_store->set_patch_position(this->index, i, this->int_centers[i]);
+		_store->color[offset + i] = this->patches[i].color;
+		_store->strength[offset + i] = this->patches[i].strength;
+	}
 }
 
 template<typename number> void
@@ -111,6 +148,7 @@ void PatchyShapeParticle<number>::set_positions() {
 	for(int i = 0; i < this->N_patches; i++)
     {
 		this->int_centers[i] = this->orientation * this->patches[i].position;
+		if(_store != 0) _store->set_patch_position(this->index, i, this->int_centers[i]);
         this->patches[i].a1 = (patches[i].a1_x * this->orientationT.v1) + (patches[i].a1_y * this->orientationT.v2) + (patches[i].a1_z * this->orientationT.v3); //possibly can be accelerated
         this->patches[i].a2 = (patches[i].a2_x * this->orientationT.v1) + (patches[i].a2_y * this->orientationT.v2) + (patches[i].a2_z * this->orientationT.v3); //possibly can be accelerated
 
@@ -132,26 +170,6 @@ void PatchyShapeParticle<number>::set_positions() {
 
 }
 
-template<typename number>
-void PatchyShapeParticle<number>::unlock_patches(void) {
-	for(int i = 0; i < this->N_patches; i++)
-	{
-		this->patches[i].set_lock(); //cleans the lock
-	}
-}
-
-template<typename number>
-bool PatchyShapeParticle<number>::locked_to_particle_id(int particle_id)
-{
-	for(int i = 0; i < this->N_patches; i++)
-	{
-		if (this->patches[i].locked_to_particle_id(particle_id) )
-			 return true;
-	}
-
-	return false;
-}
-
 
 
 
@@ -9,6 +9,7 @@
 #define PATCHYSPARTICLE_H_
 
 #include "../../../../src/Particles/BaseParticle.h"
+#include "PatchyShapeStore.h"
 
 /// A structure describing the patch; Each particle can have multiple patches, positioned at different places; The patches are directional and each
 /// patch interacts only with its specific complementary patch;
@@ -20,9 +21,6 @@ struct Patch {
  int id; //the id of the patch; it is used during initialization to assign patches to particles according to input file; sets the type of patch
  int index ; //this is the unique index of the patch in the simulation
  bool active; //is the patch on or not
- int locked_to_particle; //id of the particle this patch is bound to; used to make sure 1 patch is only in 1 interaction
- int locked_to_patch; //id of the particle this patch is bound to; used to make sure 1 patch is only in 1 interaction
- number locked_energy;
 
  int color; //this is the color of the patch
  number strength;  //sets the strength of the interaction
@@ -30,7 +28,7 @@ struct Patch {
  number a2_x, a2_y, a2_z;
 
 
- Patch() {active = false; id = 0; color = -1; strength = 1; a1_x = a1_y = a1_z = a2_x = a2_y = a2_z = 0; set_lock(-1,-1,0);}
+ Patch() {active = false; id = 0; color = -1; strength = 1; a1_x = a1_y = a1_z = a2_x = a2_y = a2_z = 0;}
 
  Patch(LR_vector<number> _a1_xyz, LR_vector<number> _a2_xyz, LR_vector<number> _position, int _id,int _color, number _strength=1.0,  bool _active = true) :
 	 position(_position), id(_id), active(_active),   color(_color), strength(_strength)
@@ -41,28 +39,10 @@ struct Patch {
 	 a2_x = _a2_xyz.x;
 	 a2_y = _a2_xyz.y;
 	 a2_z = _a2_xyz.z;
-
-	 set_lock(-1,-1,0);
  }
 
- void set_lock(int particle=-1,int patch=-1,number energy=0)
- {
-	 locked_to_particle = particle;
-	 locked_to_patch = patch;
-	 locked_energy = energy;
- }
-
- bool is_locked(void) {return locked_to_particle >= 0;}
-
  int get_color(void) {return color;}
 
- bool locked_to(int particle_id,int patch_id) {return is_locked() && (particle_id == locked_to_particle && locked_to_patch == patch_id);}
- bool locked_to_particle_id(int particle_id)  {return is_locked() && particle_id == locked_to_particle;}
- void get_lock(int& particle_id, int& patch_id) {particle_id = locked_to_particle; patch_id =  locked_to_patch;}
- number get_lock_energy(void) {return locked_energy;}
-
- void unlock() {locked_to_particle = -1;}
-
 };
 
 ///Excluded volume center
@@ -87,18 +67,25 @@ public:
     Patch<number> *patches;
     LR_vector<number> *_vertexes;
 
+    /// the system-wide store this particle writes its patches to, or NULL (e.g. for particle types)
+    PatchyShapeStore<number> *_store;
 
 	void _set_base_patches();
+	/// copies positions, colours and strengths of the patches to the store
+	void _update_store();
 
 public:
 	PatchyShapeParticle(int N_patches=1 , int type = 0,int N_vertexes=0);
 	PatchyShapeParticle(const PatchyShapeParticle<number> &b)
-	{patches = 0; this->_vertexes =  0; this->copy_from(b);}
+	{patches = 0; this->_vertexes =  0; N_patches = N_vertexes = 0; this->_store = 0; this->copy_from(b);}
 
 	virtual ~PatchyShapeParticle();
 
 	void set_positions();
 
+	/// moves the interaction centres of the particle into the store, which must have been sized with init() beforehand
+	void attach_to_store(PatchyShapeStore<number> *store);
+
 	virtual void copy_from(const BaseParticle<number> &);
 
 	PatchyShapeParticle<number>& operator = (const PatchyShapeParticle<number>& b) {this->copy_from(b);  return *this;}
@@ -112,9 +99,6 @@ public:
 	void _set_vertexes(void);
 	void _set_icosahedron_vertexes(void);
 
-	bool locked_to_particle_id(int particle_id); // {return is_locked() && particle_id == locked_to_particle;}
-	void unlock_patches(void);
-
 
 };
 
@@ -0,0 +1,80 @@
+/*
+ * PatchyShapeStore.h
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#ifndef PATCHYSHAPESTORE_H_
+#define PATCHYSHAPESTORE_H_
+
+#include <vector>
+
+#include "../../../../src/defs.h"
+
+/**
+ * @brief Contiguous, system-wide storage for the patches and the interaction centres of all the PatchyShapeParticles.
+ *
+ * Patch data are stored as a structure of arrays: the data of patch pi of particle p are at position offsets[p] + pi of
+ * each array. The interaction centres (patches first, then vertexes) of particle p start at center_offsets[p] of
+ * int_centers, and the int_centers pointer of each attached particle points there. The patch locks are kept, with the
+ * same per-patch indexing, by PatchyBondGraph.
+ *
+ * The arrays are sized once by init() and never reallocated, so the pointers handed to particles stay valid.
+ */
+template<typename number>
+class PatchyShapeStore {
+public:
+	/// offsets[i] is the index of the first patch of particle i, offsets[N] is the total number of patches
+	std::vector<int> offsets;
+	/// patch positions with respect to the centre of their particle, in the lab reference frame
+	std::vector<number> x, y, z;
+	std::vector<int> color;
+	std::vector<number> strength;
+
+	/// center_offsets[i] is the index of the first interaction centre of particle i
+	std::vector<int> center_offsets;
+	std::vector<LR_vector<number> > int_centers;
+
+	PatchyShapeStore() {
+		offsets.push_back(0);
+		center_offsets.push_back(0);
+	}
+
+	/**
+	 * @brief Sizes the store for N particles.
+	 *
+	 * @param N number of particles
+	 * @param N_patches number of patches of each particle
+	 * @param N_int_centers number of interaction centres of each particle
+	 */
+	void init(int N, const int *N_patches, const int *N_int_centers) {
+		offsets.assign(N + 1, 0);
+		center_offsets.assign(N + 1, 0);
+		for(int i = 0; i < N; i++) {
+			offsets[i + 1] = offsets[i] + N_patches[i];
+			center_offsets[i + 1] = center_offsets[i] + N_int_centers[i];
+		}
+
+		int N_tot = offsets[N];
+		x.assign(N_tot, (number) 0.);
+		y.assign(N_tot, (number) 0.);
+		z.assign(N_tot, (number) 0.);
+		color.assign(N_tot, 0);
+		strength.assign(N_tot, (number) 0.);
+		int_centers.assign(center_offsets[N], LR_vector<number>((number) 0., (number) 0., (number) 0.));
+	}
+
+	int N_particles() const {
+		return (int) offsets.size() - 1;
+	}
+
+	void set_patch_position(int particle, int patch, const LR_vector<number> &pos) {
+		int idx = offsets[particle] + patch;
+		x[idx] = pos.x;
+		y[idx] = pos.y;
+		z[idx] = pos.z;
+	}
+};
+
+#endif /* PATCHYSHAPESTORE_H_ */
@@ -0,0 +1,165 @@
+/**
+ * @file    ico_overlap_test.cpp
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ * @brief Randomised test of the overlap check between the icosahedra of PatchyShapeInteraction
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "../../../src/defs.h"
+#include "../../../src/Utilities/Logger.h"
+#include "../../../src/Utilities/oxDNAException.h"
+#include "../../../src/Utilities/Timings.h"
+#include "../../../src/Utilities/RandomManager.h"
+#include "../../../src/Utilities/Utils.h"
+// the factory functions are defined by PatchyShapeInteraction.cpp
+#define MCMOVE_CUSTOM
+#include "../src/Interactions/PatchyShapeInteraction.h"
+
+/**
+ * ico_overlap_test places pairs of icosahedral PatchyShapeParticles at random distances and with random orientations and
+ * compares the result of PatchyShapeInteraction's overlap check with a reference separating axis test that tries all
+ * the face normals of the two particles and all the cross products between their edges, and hence does not depend on
+ * the order of the vertexes. Pairs that are within a small tolerance of touching are not counted, since the two tests
+ * may legitimately disagree on them. The program exits with a non-zero status if the two tests disagree on any other
+ * pair.
+ *
+ * Usage is 'ico_overlap_test [N_pairs [seed]]'.
+ */
+
+/// pairs closer than this to touching are not checked
+#define ICO_TEST_TOLERANCE 1.e-6
+
+/// gives access to the overlap check of PatchyShapeInteraction
+class IcoOverlapTester: public PatchyShapeInteraction<double> {
+public:
+	IcoOverlapTester() {
+		this->_shape = ICOSAHEDRON_SHAPE;
+		this->_rcut = 1.;
+		this->_sqr_rcut = 1.;
+		this->_init_icosahedron();
+	}
+
+	bool overlap(PatchyShapeParticle<double> *p, PatchyShapeParticle<double> *q, LR_vector<double> &r) {
+		this->set_is_infinite(false);
+		this->_exc_vol_hard_icosahedron(p, q, &r, false);
+		bool res = this->get_is_infinite();
+		this->set_is_infinite(false);
+		return res;
+	}
+};
+
+/// largest gap between the projections of the two sets of vertexes on the given axes. It is positive if and only if one of the axes separates them
+double largest_gap(const std::vector<LR_vector<double> > &pv, const std::vector<LR_vector<double> > &qv, const std::vector<LR_vector<double> > &axes) {
+	double res = -1.e10;
+	for(unsigned int a = 0; a < axes.size(); a++) {
+		LR_vector<double> axis = axes[a] / axes[a].module();
+		double p_min = 1.e10, p_max = -1.e10, q_min = 1.e10, q_max = -1.e10;
+		for(unsigned int k = 0; k < pv.size(); k++) {
+			double proj = pv[k] * axis;
+			if(proj < p_min) p_min = proj;
+			if(proj > p_max) p_max = proj;
+			proj = qv[k] * axis;
+			if(proj < q_min) q_min = proj;
+			if(proj > q_max) q_max = proj;
+		}
+		double gap = std::max(q_min - p_max, p_min - q_max);
+		if(gap > res) res = gap;
+	}
+	return res;
+}
+
+/// appends the edges (pairs of close vertexes) and the face normals (triplets of mutually close vertexes) of an icosahedron centred in the origin
+void add_features(const std::vector<LR_vector<double> > &v, std::vector<LR_vector<double> > &edges, std::vector<LR_vector<double> > &normals) {
+	int N = v.size();
+	for(int i = 0; i < N; i++) {
+		for(int j = 0; j < i; j++) {
+			// vertexes sharing an edge are ~63 degrees apart, the others at least ~116 degrees
+			if(v[i] * v[j] <= 0.) continue;
+			edges.push_back(v[i] - v[j]);
+			for(int k = 0; k < j; k++) {
+				if(v[i] * v[k] > 0. && v[j] * v[k] > 0.) normals.push_back((v[j] - v[i]).cross(v[k] - v[i]));
+			}
+		}
+	}
+}
+
+int main(int argc, char *argv[]) {
+	int N_pairs = (argc > 1) ? atoi(argv[1]) : 100000;
+	long seed = (argc > 2) ? atol(argv[2]) : 12345;
+
+	try {
+		Logger::init();
+		TimingManager::init();
+		RandomManager::init();
+		RandomManager::instance()->seed(seed);
+
+		IcoOverlapTester interaction;
+		PatchyShapeParticle<double> p(0, 0, 12), q(0, 0, 12);
+		p.index = 0;
+		q.index = 1;
+		p._set_icosahedron_vertexes();
+		q._set_icosahedron_vertexes();
+
+		// the vertexes are 0.5 away from the centre and the inscribed sphere has a radius of ~0.397: the range of
+		// distances includes pairs that overlap for any orientation and pairs that cannot overlap
+		double r_min = 0.7;
+		double r_max = 1.;
+		int N_overlaps = 0, N_skipped = 0, N_missed = 0, N_spurious = 0;
+		for(int n = 0; n < N_pairs; n++) {
+			p.orientation = Utils::get_random_rotation_matrix<double>();
+			q.orientation = Utils::get_random_rotation_matrix<double>();
+			p.orientationT = p.orientation.get_transpose();
+			q.orientationT = q.orientation.get_transpose();
+			p.set_positions();
+			q.set_positions();
+			LR_vector<double> r = Utils::get_random_vector<double>() * (r_min + (r_max - r_min) * RandomManager::instance()->uniform());
+
+			std::vector<LR_vector<double> > pv, qv, edges_p, edges_q, axes;
+			for(int k = 0; k < 12; k++) {
+				pv.push_back(p.int_centers[k]);
+				qv.push_back(q.int_centers[k]);
+			}
+			add_features(pv, edges_p, axes);
+			add_features(qv, edges_q, axes);
+			for(int k = 0; k < 12; k++) qv[k] += r;
+			if(axes.size() != 40 || edges_p.size() != 30) throw oxDNAException("Found %d faces and %d edges instead of 40 and 30", (int) axes.size(), (int) edges_p.size());
+			for(unsigned int i = 0; i < edges_p.size(); i++) {
+				for(unsigned int j = 0; j < edges_q.size(); j++) {
+					LR_vector<double> axis = edges_p[i].cross(edges_q[j]);
+					if(axis.module() > 1.e-8) axes.push_back(axis);
+				}
+			}
+
+			double gap = largest_gap(pv, qv, axes);
+			if(fabs(gap) < ICO_TEST_TOLERANCE) {
+				N_skipped++;
+				continue;
+			}
+			bool reference = (gap < 0.);
+			bool result = interaction.overlap(&p, &q, r);
+			if(reference) N_overlaps++;
+			if(reference && !result) N_missed++;
+			if(!reference && result) N_spurious++;
+		}
+
+		printf("pairs: %d, overlapping: %d, skipped: %d, missed overlaps: %d, spurious overlaps: %d\n", N_pairs, N_overlaps, N_skipped, N_missed, N_spurious);
+		if(N_missed > 0 || N_spurious > 0) throw oxDNAException("The overlap check of PatchyShapeInteraction disagrees with the reference on %d pairs", N_missed + N_spurious);
+	}
+	catch (oxDNAException &e) {
+		OX_LOG(Logger::LOG_ERROR, "%s", e.error());
+		return 1;
+	}
+
+	RandomManager::clear();
+	TimingManager::clear();
+	Logger::clear();
+
+	return 0;
+}
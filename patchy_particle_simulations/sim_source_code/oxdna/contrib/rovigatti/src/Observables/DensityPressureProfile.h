@@ -30,6 +30,7 @@ public:
 	virtual ~DensityPressureProfile();
 
 	virtual std::string get_output_string(llint curr_step);
+	virtual bool is_cumulative() { return true; }
 	void get_settings (input_file &my_inp, input_file &sim_inp);
 };
 
@@ -28,6 +28,7 @@ public:
 
 	void get_settings (input_file &my_inp, input_file &sim_inp);
 	virtual std::string get_output_string(llint curr_step);
+	virtual bool is_cumulative() { return _accumulate; }
 };
 
 extern "C" BaseObservable<float> *make_float() { return new Gyradius<float>(); }
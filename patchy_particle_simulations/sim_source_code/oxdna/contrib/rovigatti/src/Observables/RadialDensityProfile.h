@@ -30,6 +30,7 @@ public:
 	virtual ~RadialDensityProfile();
 
 	virtual std::string get_output_string(llint curr_step);
+	virtual bool is_cumulative() { return !_always_reset; }
 	void get_settings (input_file &my_inp, input_file &sim_inp);
 };
 
@@ -33,6 +33,7 @@ public:
 	virtual ~Remoteness();
 
 	std::string get_output_string(llint curr_step);
+	bool is_cumulative() { return true; }
 
 	virtual void get_settings(input_file &my_inp, input_file &sim_inp);
 	virtual void init(ConfigInfo<number> &config_info);
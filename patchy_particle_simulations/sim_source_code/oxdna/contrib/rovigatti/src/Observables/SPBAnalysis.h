@@ -29,6 +29,7 @@ public:
 	virtual void init(ConfigInfo<number> &config_info);
 
 	std::string get_output_string(llint curr_step);
+	bool is_cumulative() { return true; }
 };
 
 extern "C" BaseObservable<float> *make_float() { return new SPBAnalysis<float>(); }
@@ -6,6 +6,11 @@
  */
 
 #include <sstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "AnalysisBackend.h"
 #include "../Interactions/InteractionFactory.h"
@@ -13,8 +18,9 @@
 #include "../Lists/ListFactory.h"
 #include "../Boxes/BoxFactory.h"
 #include "../PluginManagement/PluginManager.h"
+#include "../Utilities/CompressedTrajectory.h"
 
-AnalysisBackend::AnalysisBackend() : SimBackend<double>(), _done(false), _n_conf(0) {
+AnalysisBackend::AnalysisBackend() : SimBackend<double>(), _done(false), _n_conf(0), _max_confs(-1), _compressed_trajectory(false) {
 	_enable_fix_diffusion = 0;
 }
 
@@ -110,7 +116,8 @@ void AnalysisBackend::analyse() {
 	if(_n_conf % 100 == 0 && _n_conf > 0) OX_LOG(Logger::LOG_INFO, "Analysed %d configurations", _n_conf);
 	SimBackend<double>::print_observables(_read_conf_step);
 
-	if(!_read_next_configuration(_initial_conf_is_binary)) _done = true;
+	if(_max_confs > -1 && _n_conf + 1 >= _max_confs) _done = true;
+	else if(!_read_next_configuration(_initial_conf_is_binary)) _done = true;
 	else _n_conf++;
 
 	for(int i = 0; i < this->_N; i++) this->_lists->single_update(this->_particles[i]);
@@ -118,3 +125,87 @@ void AnalysisBackend::analyse() {
 
 	_mytimer->pause();
 }
+
+std::vector<llint> AnalysisBackend::_index_text_trajectory(const std::string &filename) {
+	std::vector<llint> offsets;
+
+	int fd = open(filename.c_str(), O_RDONLY);
+	if(fd == -1) throw oxDNAException("Can't read configuration file '%s'", filename.c_str());
+	struct stat info;
+	if(fstat(fd, &info) != 0) {
+		close(fd);
+		throw oxDNAException("Can't read configuration file '%s'", filename.c_str());
+	}
+	size_t size = info.st_size;
+	if(size == 0) {
+		close(fd);
+		return offsets;
+	}
+	void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) throw oxDNAException("Cannot map the configuration file '%s' in memory", filename.c_str());
+	madvise(map, size, MADV_SEQUENTIAL);
+
+	const char *data = (const char *) map;
+	const char *end = data + size;
+	const char *line = data;
+	while(line < end) {
+		if(end - line >= 4 && memcmp(line, "t = ", 4) == 0) offsets.push_back(line - data);
+		const char *next = (const char *) memchr(line, '\n', end - line);
+		if(next == NULL) break;
+		line = next + 1;
+	}
+
+	munmap(map, size);
+	return offsets;
+}
+
+std::string AnalysisBackend::_part_name(int output, int part) {
+	return Utils::sformat("%s.%d.part%d", _obs_outputs[output]->get_output_name().c_str(), output, part);
+}
+
+int AnalysisBackend::index_trajectory() {
+	if(_initial_conf_is_binary) throw oxDNAException("Binary trajectories cannot be indexed");
+
+	int N_confs;
+	if(CompressedTrajectory::is_compressed_trajectory(_conf_filename)) {
+		_compressed_trajectory = true;
+		CompressedTrajectoryReader reader(_conf_filename);
+		N_confs = reader.N_frames();
+	}
+	else {
+		_conf_offsets = _index_text_trajectory(_conf_filename);
+		N_confs = _conf_offsets.size();
+	}
+	OX_LOG(Logger::LOG_INFO, "Found %d configuration(s) in '%s'", N_confs, _conf_filename.c_str());
+
+	if(N_confs <= _confs_to_skip) throw oxDNAException("Skipping %d configuration(s) is not possible, as the trajectory only contains %d.", _confs_to_skip, N_confs);
+	return N_confs - _confs_to_skip;
+}
+
+void AnalysisBackend::check_ranges_allowed() {
+	for(unsigned int i = 0; i < _obs_outputs.size(); i++) {
+		if(_obs_outputs[i]->is_cumulative()) throw oxDNAException("The output '%s' contains observables that accumulate data over the trajectory, which cannot be computed on separate parts of it: set analysis_workers = 1 to analyse it", _obs_outputs[i]->get_output_name().c_str());
+	}
+}
+
+void AnalysisBackend::set_range(int first, int N, int part) {
+	check_ranges_allowed();
+	// compressed trajectories are seeked by SimBackend, text trajectories are read from the offset of the first configuration
+	if(_compressed_trajectory) _confs_to_skip += first;
+	else {
+		_first_conf_offset = _conf_offsets[_confs_to_skip + first];
+		_confs_to_skip = 0;
+	}
+	_max_confs = N;
+
+	for(unsigned int i = 0; i < _obs_outputs.size(); i++) _obs_outputs[i]->set_part_file(_part_name(i, part));
+}
+
+void AnalysisBackend::merge_parts(int N_parts) {
+	for(unsigned int i = 0; i < _obs_outputs.size(); i++) {
+		std::vector<std::string> parts;
+		for(int p = 0; p < N_parts; p++) parts.push_back(_part_name(i, p));
+		_obs_outputs[i]->merge_parts(parts);
+	}
+}
@@ -15,6 +15,7 @@
  *
  * @verbatim
 [analysis_confs_to_skip = <int> (number of configurations that should be excluded from the analysis.)]
+[analysis_workers = <int> (number of processes the configurations are split among, see AnalysisManager. Defaults to 1)]
 analysis_data_output_<n> = {\nObservableOutput\n} (specify an analysis output stream. <n> is an integer number and should start from 1. The setup and usage of output streams are documented in the ObservableOutput class.)
 @endverbatim
  */
@@ -22,6 +23,22 @@ class AnalysisBackend : public SimBackend<double> {
 protected:
 	bool _done;
 	llint _n_conf;
+	/// maximum number of configurations to analyse, or -1 if the whole trajectory should be analysed
+	llint _max_confs;
+	/// offsets of the configurations of the trajectory, filled by index_trajectory if the trajectory is in text format
+	std::vector<llint> _conf_offsets;
+	bool _compressed_trajectory;
+
+	/**
+	 * @brief Finds the offsets of the configurations of a text trajectory with a single scan of its memory-mapped content.
+	 *
+	 * @param filename
+	 * @return the offsets of the 't = ' lines that start the configurations
+	 */
+	static std::vector<llint> _index_text_trajectory(const std::string &filename);
+
+	/// returns the name of the file part part of the output output is written to
+	std::string _part_name(int output, int part);
 
 public:
 	AnalysisBackend();
@@ -42,6 +59,40 @@ public:
 
 	void get_settings(input_file &inp);
 	void init();
+
+	/**
+	 * @brief Indexes the trajectory, so that any configuration can be reached without parsing the previous ones.
+	 *
+	 * Text trajectories are indexed by scanning them once, compressed trajectories come with their own index. Binary
+	 * trajectories are not supported. It can be called before init.
+	 *
+	 * @return the number of configurations that would be analysed, i.e. those that are not skipped
+	 */
+	int index_trajectory();
+
+	/**
+	 * @brief Restricts the analysis to a contiguous range of configurations, whose output is written to part files. It
+	 * should be called after index_trajectory and before init.
+	 *
+	 * @param first index of the first configuration of the range, not counting those that are skipped
+	 * @param N number of configurations of the range
+	 * @param part index of the part, used to name the part files
+	 */
+	void set_range(int first, int N, int part);
+
+	/**
+	 * @brief Throws an oxDNAException if the analysis cannot be split into ranges because some of the observables
+	 * accumulate data over the trajectory (see BaseObservable::is_cumulative), since each range would then produce
+	 * averages or histograms of its own configurations only.
+	 */
+	void check_ranges_allowed();
+
+	/**
+	 * @brief Merges the part files written by the analyses of the given number of ranges into the outputs.
+	 *
+	 * @param N_parts
+	 */
+	void merge_parts(int N_parts);
 };
 
 #endif /* ANALYSISBACKEND_H_ */
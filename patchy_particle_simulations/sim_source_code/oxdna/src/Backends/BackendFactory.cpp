@@ -24,6 +24,7 @@
 
 #ifdef HAVE_MPI
 #include "PT_VMMC_CPUBackend.h"
+#include "PT_MC_CPUBackend2.h"
 #endif
 
 BackendFactory::BackendFactory() {
@@ -108,6 +109,14 @@ ISimBackend *BackendFactory::make_backend(input_file &inp) {
 			else throw oxDNAException("Backend '%s' not supported", backend_opt);
 
 	}
+	else if(!strcmp (sim_type, "PT_MC2")) {
+			if(!strcmp(backend_opt, "CPU")) {
+				if(!strcmp(backend_prec, "double")) new_backend = new PT_MC_CPUBackend2<double>();
+				else if(!strcmp(backend_prec, "float")) new_backend = new PT_MC_CPUBackend2<float>();
+				else throw oxDNAException("Backend precision '%s' is not supported", backend_prec);
+			}
+			else throw oxDNAException("Backend '%s' not supported", backend_opt);
+	}
 #endif
 	else if(!strcmp (sim_type, "min")) {
 			if(!strcmp(backend_opt, "CPU")) {
@@ -128,6 +128,7 @@ public:
 
 	void print_order_parameters(void);
 	void init_ffs_from_file(const char *fname);
+	/// checks the FFS conditions. It is called by sim_step after each step, and hence it does not need to be scheduled
 	bool check_stop_conditions(void);
 
 	virtual void get_settings(input_file &inp);
@@ -119,5 +119,31 @@ void MCBackend<number>::print_observables(llint curr_step) {
 	SimBackend<number>::print_observables(curr_step);
 }
 
+template<typename number>
+void MCBackend<number>::_write_backend_state(std::ostream &out) {
+	out.write((char *) &_MC_moves, sizeof(int));
+	for(int i = 0; i < _MC_moves; i++) {
+		double delta = _delta[i];
+		out.write((char *) &delta, sizeof(double));
+		out.write((char *) &_tries[i], sizeof(llint));
+		out.write((char *) &_accepted[i], sizeof(llint));
+	}
+}
+
+template<typename number>
+void MCBackend<number>::_read_backend_state(std::istream &in) {
+	int N_moves;
+	in.read((char *) &N_moves, sizeof(int));
+	if(!in.good() || N_moves != _MC_moves) throw oxDNAException("(MCBackend) The state file does not contain a valid MC state");
+	for(int i = 0; i < _MC_moves; i++) {
+		double delta;
+		in.read((char *) &delta, sizeof(double));
+		in.read((char *) &_tries[i], sizeof(llint));
+		in.read((char *) &_accepted[i], sizeof(llint));
+		_delta[i] = (number) delta;
+	}
+	if(!in.good()) throw oxDNAException("(MCBackend) The state file does not contain a valid MC state");
+}
+
 template class MCBackend<float>;
 template class MCBackend<double>;
@@ -58,6 +58,10 @@ protected:
 	void _get_number_settings(input_file &inp);
 	virtual void _compute_energy() = 0;
 
+	/// stores the step sizes and the acceptance statistics of the moves
+	virtual void _write_backend_state(std::ostream &out);
+	virtual void _read_backend_state(std::istream &in);
+
 public:
 	MCBackend();
 	virtual ~MCBackend();
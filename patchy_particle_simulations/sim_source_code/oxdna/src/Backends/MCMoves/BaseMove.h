@@ -11,9 +11,159 @@
 #include "../../Utilities/Logger.h"
 #include "../../Particles/BaseParticle.h"
 #include "../../Observables/BaseObservable.h"
+#include "../../Lists/Cells.h"
+#include "../../Utilities/RandomManager.h"
+#include "../../Utilities/Timings.h"
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+/// distance between the partial sums of different threads in ParticleEnergyCache, so that they lie in different cache lines
+#define ENERGY_CACHE_STRIDE 8
 
 using namespace std;
 
+/**
+ * @brief A box-shaped region made of whole cells. When the MC2 backend runs checkerboard sweeps, local moves are
+ * restricted to a domain: they only move particles belonging to it, and they reject moves that would take a particle
+ * out of it.
+ */
+template<typename number>
+struct MCDomain {
+	/// the cell lists the domain is built upon
+	Cells<number> *cells;
+	/// coordinates of the first cell of the domain; the domain may wrap around the periodic boundaries
+	int first[3];
+	/// number of cells spanned by the domain along each direction
+	int width[3];
+	/// indexes of the particles that are in the domain
+	std::vector<int> particles;
+	/// random numbers used by the moves acting on the domain
+	RandomStream rng;
+
+	MCDomain() : cells(NULL) {
+		for(int d = 0; d < 3; d++) first[d] = width[d] = 0;
+	}
+
+	bool contains(const LR_vector<number> &pos) {
+		int idx = cells->get_cell_index(pos);
+		for(int d = 0; d < 3; d++) {
+			int N_side = cells->get_N_cells_side(d);
+			int c = idx % N_side;
+			idx /= N_side;
+			if((c - first[d] + N_side) % N_side >= width[d]) return false;
+		}
+		return true;
+	}
+};
+
+/// the non-zero contributions to the energy of a particle, as (index of the other particle, pair energy) pairs
+template<typename number>
+struct EnergyTerms {
+	typedef std::vector<std::pair<int, number> > type;
+};
+
+/**
+ * @brief Stores the contributions to the energy of each particle coming from each of the particles it interacts with,
+ * so that moves do not have to compute the energy of a particle from scratch before moving it.
+ *
+ * Moves that use it store the contributions computed before and after the move. When a move is accepted, the
+ * contributions of the moved particle to the energies of its old and new partners are updated, and the energies of the
+ * particles whose interactions may have changed in some other way are invalidated. Since the energy of a particle is
+ * the sum of its cached contributions, it may differ from the one computed from scratch in the last digits. Anything
+ * else that changes the configuration should call invalidate_all().
+ *
+ * The sum of the energies of the valid particles is updated whenever their contributions change, so that once all the
+ * particles are valid the energy of the system, which is half that sum, is available without any further computation.
+ * The sum is split in per-thread partial sums, so that moves carried out in parallel on different particles do not
+ * write to the same memory.
+ */
+template<typename number>
+struct ParticleEnergyCache {
+	std::vector<typename EnergyTerms<number>::type> terms;
+	/// non-zero if the terms of the particle are up to date. chars rather than bools, so that different threads can write different entries at the same time
+	std::vector<char> valid;
+	/// partial sums of the energies of the valid particles, one every ENERGY_CACHE_STRIDE entries for each thread
+	std::vector<double> partial_totals;
+
+	void init(int N, int N_threads=1) {
+		terms.assign(N, typename EnergyTerms<number>::type());
+		valid.assign(N, 0);
+		partial_totals.assign(N_threads * ENERGY_CACHE_STRIDE, 0.);
+	}
+
+	/// adds delta to the partial sum of the calling thread
+	void add_to_total(number delta) {
+		int t = 0;
+#ifdef HAVE_OPENMP
+		t = omp_get_thread_num();
+#endif
+		partial_totals[t * ENERGY_CACHE_STRIDE] += delta;
+	}
+
+	/// returns the energy of the system, which is half the sum of the energies of the particles. They must all be valid
+	number system_energy() {
+		double total = 0.;
+		for(unsigned int i = 0; i < partial_totals.size(); i += ENERGY_CACHE_STRIDE) total += partial_totals[i];
+		return (number) (total / 2.);
+	}
+
+	/// recomputes the sum of the energies of the particles from their terms, discarding the rounding errors accumulated by the updates
+	void resum() {
+		partial_totals.assign(partial_totals.size(), 0.);
+		for(unsigned int i = 0; i < valid.size(); i++) {
+			if(valid[i]) partial_totals[0] += energy(i);
+		}
+	}
+
+	bool is_valid(int idx) {
+		return valid[idx] != 0;
+	}
+
+	/// returns the energy of the idx-th particle, which must be valid
+	number energy(int idx) {
+		number res = (number) 0.f;
+		for(typename EnergyTerms<number>::type::iterator it = terms[idx].begin(); it != terms[idx].end(); it++) res += it->second;
+		return res;
+	}
+
+	void set(int idx, const typename EnergyTerms<number>::type &new_terms) {
+		number delta = -((valid[idx]) ? energy(idx) : (number) 0.f);
+		terms[idx] = new_terms;
+		valid[idx] = 1;
+		add_to_total(delta + energy(idx));
+	}
+
+	/// sets the contribution of the other-th particle to the energy of the idx-th particle, if the latter is valid
+	void update(int idx, int other, number pair_energy) {
+		if(!valid[idx]) return;
+		typename EnergyTerms<number>::type &t = terms[idx];
+		for(typename EnergyTerms<number>::type::iterator it = t.begin(); it != t.end(); it++) {
+			if(it->first == other) {
+				add_to_total(pair_energy - it->second);
+				if(pair_energy == (number) 0.f) t.erase(it);
+				else it->second = pair_energy;
+				return;
+			}
+		}
+		if(pair_energy != (number) 0.f) {
+			t.push_back(std::make_pair(other, pair_energy));
+			add_to_total(pair_energy);
+		}
+	}
+
+	void invalidate(int idx) {
+		if(valid[idx]) add_to_total(-energy(idx));
+		valid[idx] = 0;
+	}
+
+	void invalidate_all() {
+		valid.assign(valid.size(), 0);
+		partial_totals.assign(partial_totals.size(), 0.);
+	}
+};
+
 /**
  * @brief Abstract class defining the MC moves. All the other moves inherit from this one.
  *
@@ -57,6 +207,74 @@ class BaseMove {
 		/// type of the move
 		std::string _name;
 
+		/// domain the move is restricted to, or NULL if it can act on the whole system
+		MCDomain<number> *_domain;
+
+		/// step sizes that are adjusted during the equilibration. Moves register them in their constructors so that they are saved in, and restored from, state files
+		std::vector<number *> _step_sizes;
+
+		/// telemetry counters, shared by all the moves
+		Counter *_energy_evaluations;
+		Counter *_neighbour_visits;
+
+		/// energy cache shared by all the moves, or NULL if it is not used
+		ParticleEnergyCache<number> *_energy_cache;
+		Counter *_energy_cache_hits;
+
+		/// neighbours of the particle being moved. It is reused across moves so that querying the lists does not allocate memory. Its content is overwritten by particle_energy and system_energy
+		std::vector<BaseParticle<number> *> _neighs;
+
+		/// returns a random number in [0, 1), drawn from the stream of the current domain, if any, or from the stream of the calling thread
+		double _rand() {
+			if(_domain != NULL) return _domain->rng.uniform();
+			return _Info->rng->uniform();
+		}
+
+		/// fills out with n random numbers in [0, 1), drawn as _rand() would draw them
+		void _fill_rand(double *out, int n) {
+			if(_domain != NULL) _domain->rng.fill_uniform(out, n);
+			else _Info->rng->fill_uniform(out, n);
+		}
+
+		/// same as Utils::get_random_vector, but it draws the random numbers with _rand()
+		LR_vector<number> _random_vector();
+
+		/// returns the index of a random particle belonging to the current domain or, if there is none, to the whole system
+		int _random_particle() {
+			if(_domain != NULL) return _domain->particles[(int) (_rand() * _domain->particles.size())];
+			return (int) (_rand() * (*_Info->N));
+		}
+
+		/// same as particle_energy, but the non-zero contributions to the energy are also stored in terms
+		number _particle_energy_terms(BaseParticle<number> *p, typename EnergyTerms<number>::type &terms);
+
+		/// same as _particle_energy_terms, but the energy is taken from the cache, if possible
+		number _cached_particle_energy(BaseParticle<number> *p, typename EnergyTerms<number>::type &terms) {
+			if(_energy_cache != NULL && _energy_cache->is_valid(p->index)) {
+				_energy_cache_hits->add();
+				terms = _energy_cache->terms[p->index];
+				return _energy_cache->energy(p->index);
+			}
+			return _particle_energy_terms(p, terms);
+		}
+
+		/// invalidates the cached energies of p and of its neighbours, overwriting _neighs
+		void _invalidate_energy(BaseParticle<number> *p) {
+			_energy_cache->invalidate(p->index);
+			_Info->lists->fill_neigh_list(p, _neighs);
+			for(unsigned int n = 0; n < _neighs.size(); n++) _energy_cache->invalidate(_neighs[n]->index);
+		}
+
+		/// returns true if the step sizes should be adapted right after a move. During checkerboard sweeps they are adapted by the backend instead, see adjust
+		bool _adjust_now(llint curr_step) {
+			return _adjust_moves && curr_step < _equilibration_steps && _domain == NULL;
+		}
+
+		/// returns true if p can be moved where it is now without leaving the current domain
+		bool _in_domain(BaseParticle<number> *p) {
+			return _domain == NULL || _domain->contains(p->pos);
+		}
+
 	public:
 		BaseMove();
 
@@ -83,9 +301,75 @@ class BaseMove {
 		/// helper function to compute the system energy; internally, it calls the interaction
 		number system_energy ();
 
+		/// returns the energy of the system kept by the energy cache, after computing the energies of the particles that are not valid
+		number cached_system_energy();
+
 		/// method that applies the move to the system. Each child class must have it.
 		virtual void apply (llint curr_step) = 0;
 
+		/**
+		 * @brief Returns true if the move can be restricted to a domain.
+		 *
+		 * Local moves act on a single particle picked with _random_particle(), reject moves that take it out of the domain,
+		 * draw their random numbers with _rand(), read or change only particles that are at most cell_range() cells away
+		 * from it and adapt their step sizes only if _adjust_now() returns true. Only local moves can be used in
+		 * checkerboard sweeps.
+		 */
+		virtual bool is_local() { return false; }
+
+		/**
+		 * @brief Returns the largest number of cells, along any direction, between the cell of the particle moved by a local
+		 * move and the cells of the particles the move may read or change, including the energies of the particles kept in
+		 * the energy cache. Since a cell is at least as wide as the interaction range, a move that looks at the neighbours
+		 * of the moved particle and at their neighbours has a range of two cells.
+		 */
+		virtual int cell_range() { return 2; }
+
+		/**
+		 * @brief Returns true if the move keeps the energy cache up to date (see ParticleEnergyCache). The MC2 backend
+		 * uses the cache only if all the moves support it.
+		 */
+		virtual bool supports_energy_cache() { return false; }
+
+		/// makes the move use the given cache, or no cache at all if cache is NULL
+		void set_energy_cache(ParticleEnergyCache<number> *cache) { _energy_cache = cache; }
+
+		/// restricts the move to the given domain, or lifts the restriction if domain is NULL
+		void set_domain(MCDomain<number> *domain) { _domain = domain; }
+
+		llint get_attempted() { return _attempted; }
+		llint get_accepted() { return _accepted; }
+
+		/**
+		 * @brief Adapts the step sizes according to the given numbers of accepted and rejected moves.
+		 *
+		 * During checkerboard sweeps moves do not adapt their step sizes themselves: the backend adds the counters of the
+		 * copies of the move used by the other threads to this one (see merge_counters), calls this method with the moves
+		 * accepted and rejected during the sweep and then hands the new step sizes to the copies (see copy_step_sizes).
+		 * The step sizes are multiplied by the geometric mean of the factors the moves would have applied one after the
+		 * other: this leads to the same target acceptance, but since the step sizes do not change during the sweep applying
+		 * all the factors would make them overshoot. Moves that adapt their step sizes in some other way should override it.
+		 */
+		virtual void adjust(llint curr_step, llint accepted, llint rejected);
+
+		/// adds the counters of the given copy of the move to the counters of this move, and resets them
+		void merge_counters(BaseMove<number> *copy) {
+			_attempted += copy->_attempted;
+			_accepted += copy->_accepted;
+			copy->_attempted = copy->_accepted = 0;
+		}
+
+		/// sets the step sizes of the move to the ones of the given copy
+		void copy_step_sizes(BaseMove<number> *copy) {
+			for(unsigned int i = 0; i < _step_sizes.size(); i++) *_step_sizes[i] = *copy->_step_sizes[i];
+		}
+
+		/// writes the counters and the step sizes of the move, in binary format. Moves with more state should extend it
+		virtual void write_state(std::ostream &out);
+
+		/// restores the state written by write_state
+		virtual void read_state(std::istream &in);
+
 		/// method that gets the ratio of accepted moves
 		virtual double get_acceptance() {
 			if (_attempted > 0) return _accepted / (double) _attempted;
@@ -105,6 +389,11 @@ BaseMove<number>::BaseMove ():  _Info(&ConfigInfo<number>::ref_instance()) {
 	_adjust_moves = false;
 	_compute_energy_before = true;
 	_restrict_to_type = -1;
+	_domain = NULL;
+	_energy_cache = NULL;
+	_energy_evaluations = TimingManager::instance()->get_counter("Energy evaluations");
+	_neighbour_visits = TimingManager::instance()->get_counter("Neighbour visits");
+	_energy_cache_hits = TimingManager::instance()->get_counter("Energy cache hits");
 }
 
 template<typename number>
@@ -146,6 +435,56 @@ void BaseMove<number>::log_parameters() {
 	OX_LOG(Logger::LOG_INFO, "\trestrict_to_type = %d", int(_restrict_to_type));
 }
 
+template<typename number>
+void BaseMove<number>::adjust(llint curr_step, llint accepted, llint rejected) {
+	if(!_adjust_moves || curr_step >= _equilibration_steps || accepted + rejected == 0) return;
+
+	number factor = exp((accepted * log(_acc_fact) - rejected * log(_rej_fact)) / (accepted + rejected));
+	for(unsigned int i = 0; i < _step_sizes.size(); i++) *_step_sizes[i] *= factor;
+}
+
+template<typename number>
+void BaseMove<number>::write_state(std::ostream &out) {
+	int N_sizes = _step_sizes.size();
+	out.write((char *) &_attempted, sizeof(llint));
+	out.write((char *) &_accepted, sizeof(llint));
+	out.write((char *) &N_sizes, sizeof(int));
+	for(int i = 0; i < N_sizes; i++) {
+		double size = *_step_sizes[i];
+		out.write((char *) &size, sizeof(double));
+	}
+}
+
+template<typename number>
+void BaseMove<number>::read_state(std::istream &in) {
+	int N_sizes;
+	in.read((char *) &_attempted, sizeof(llint));
+	in.read((char *) &_accepted, sizeof(llint));
+	in.read((char *) &N_sizes, sizeof(int));
+	if(!in.good() || N_sizes != (int) _step_sizes.size()) throw oxDNAException("(BaseMove.h) The state of the move of type %s is not compatible with the move", _name.c_str());
+	for(int i = 0; i < N_sizes; i++) {
+		double size;
+		in.read((char *) &size, sizeof(double));
+		*_step_sizes[i] = (number) size;
+	}
+	if(!in.good()) throw oxDNAException("(BaseMove.h) Malformed state for the move of type %s", _name.c_str());
+}
+
+template<typename number>
+LR_vector<number> BaseMove<number>::_random_vector() {
+	number ransq = 1.;
+	number ran1, ran2;
+
+	while(ransq >= 1) {
+		ran1 = 1. - 2. * _rand();
+		ran2 = 1. - 2. * _rand();
+		ransq = ran1 * ran1 + ran2 * ran2;
+	}
+
+	number ranh = 2. * sqrt(1. - ransq);
+	return LR_vector<number>(ran1 * ranh, ran2 * ranh, 1. - 2. * ransq);
+}
+
 template <typename number>
 number BaseMove<number>::particle_energy(BaseParticle<number> * p) {
 	number res = (number) 0.f;
@@ -156,9 +495,11 @@ number BaseMove<number>::particle_energy(BaseParticle<number> * p) {
 	}
 	if (_Info->interaction->get_is_infinite() == true) return (number) 1.e12;
 
-	std::vector<BaseParticle<number> *> neighs = _Info->lists->get_neigh_list(p);
-	for(unsigned int n = 0; n < neighs.size(); n++) {
-		BaseParticle<number> *q = neighs[n];
+	_Info->lists->fill_neigh_list(p, _neighs);
+	_energy_evaluations->add();
+	_neighbour_visits->add(_neighs.size());
+	for(unsigned int n = 0; n < _neighs.size(); n++) {
+		BaseParticle<number> *q = _neighs[n];
 		res += _Info->interaction->pair_interaction_nonbonded(p, q);
 		if(_Info->interaction->get_is_infinite() == true) {
 			return (number) 1.e12;
@@ -167,17 +508,46 @@ number BaseMove<number>::particle_energy(BaseParticle<number> * p) {
 	return res;
 }
 
+template <typename number>
+number BaseMove<number>::_particle_energy_terms(BaseParticle<number> *p, typename EnergyTerms<number>::type &terms) {
+	terms.clear();
+	number res = (number) 0.f;
+	typename vector<ParticlePair<number> >::iterator it = p->affected.begin();
+	for(; it != p->affected.end(); it++) {
+		number de = _Info->interaction->pair_interaction_bonded(it->first, it->second);
+		res += de;
+		if(de != (number) 0.f) terms.push_back(std::make_pair((it->first == p) ? it->second->index : it->first->index, de));
+	}
+	if (_Info->interaction->get_is_infinite() == true) return (number) 1.e12;
+
+	_Info->lists->fill_neigh_list(p, _neighs);
+	_energy_evaluations->add();
+	_neighbour_visits->add(_neighs.size());
+	for(unsigned int n = 0; n < _neighs.size(); n++) {
+		BaseParticle<number> *q = _neighs[n];
+		number de = _Info->interaction->pair_interaction_nonbonded(p, q);
+		res += de;
+		if(_Info->interaction->get_is_infinite() == true) {
+			return (number) 1.e12;
+		}
+		if(de != (number) 0.f) terms.push_back(std::make_pair(q->index, de));
+	}
+	return res;
+}
+
 template <typename number>
 number BaseMove<number>::system_energy() {
 	number res = (number) 0.f;
+	_energy_evaluations->add();
 
 	for (int i = 0; i < *_Info->N; i ++) {
 		BaseParticle<number> *p = _Info->particles[i];
 		if(p->n3 != P_VIRTUAL) res += _Info->interaction->pair_interaction_bonded(p, p->n3);
 		// we omit E(p,p->n5) because it gets counted as E(q, q->n3);
-		std::vector<BaseParticle<number> *> neighs = _Info->lists->get_neigh_list(p);
-		for(unsigned int n = 0; n < neighs.size(); n++) {
-			BaseParticle<number> *q = neighs[n];
+		_Info->lists->fill_neigh_list(p, _neighs);
+		_neighbour_visits->add(_neighs.size());
+		for(unsigned int n = 0; n < _neighs.size(); n++) {
+			BaseParticle<number> *q = _neighs[n];
 			if (p->index < q->index) {
 				res += _Info->interaction->pair_interaction_nonbonded(p, q);
 				if(_Info->interaction->get_is_infinite() == true) return (number) 1.e12;
@@ -187,4 +557,17 @@ number BaseMove<number>::system_energy() {
 
 	return res;
 }
+
+template <typename number>
+number BaseMove<number>::cached_system_energy() {
+	typename EnergyTerms<number>::type terms;
+	for(int i = 0; i < *_Info->N; i++) {
+		if(_energy_cache->is_valid(i)) continue;
+		_particle_energy_terms(_Info->particles[i], terms);
+		if(_Info->interaction->get_is_infinite() == true) return (number) 1.e12;
+		_energy_cache->set(i, terms);
+	}
+
+	return _energy_cache->system_energy();
+}
 #endif
@@ -10,6 +10,7 @@
 
 template<typename number>
 MCRot<number>::MCRot () : BaseMove<number>() {
+	this->_step_sizes.push_back(&_delta);
 	_orientation_old = LR_matrix<number> (1., 0., 0., 0., 1., 0., 0., 0., 1.);
 	_orientationT_old = LR_matrix<number> (1., 0., 0., 0., 1., 0., 0., 0., 1.);
 }
@@ -41,11 +42,11 @@ void MCRot<number>::apply (llint curr_step) {
 
 	this->_attempted ++;
 
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> *p = this->_Info->particles[pi];
 	if (this->_restrict_to_type >= 0) {
 		while(p->type != this->_restrict_to_type) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 			p = this->_Info->particles[pi];
 		}
 	}
@@ -60,7 +61,7 @@ void MCRot<number>::apply (llint curr_step) {
 	_orientationT_old = p->orientationT;
 
 	//number t = (drand48() - (number)0.5f) * _delta;
-	number t = drand48() * _delta;
+	number t = this->_rand() * _delta;
 	LR_vector<number> axis = Utils::get_random_vector<number>();
 
 	number sintheta = sin(t);
@@ -94,7 +95,7 @@ void MCRot<number>::apply (llint curr_step) {
 	delta_E_ext += p->ext_potential;
 
 	// accept or reject?
-	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48() )) {
+	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand() )) {
 		// move accepted
 		// put here the adjustment of moves
 		this->_accepted ++;
@@ -11,6 +11,7 @@
 /// traslation
 template<typename number>
 MCTras<number>::MCTras()  {
+	this->_step_sizes.push_back(&_delta);
 	pos_old = LR_vector<number> (0., 0., 0.);
 
 	_verlet_skin = -1.f;
@@ -48,11 +49,11 @@ void MCTras<number>::apply (llint curr_step) {
 	this->_attempted += 1;
 
 	// we select the particle to translate
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> *p = this->_Info->particles[pi];
 	if (this->_restrict_to_type >= 0) {
 		while(p->type != this->_restrict_to_type) {
-			pi = (int) (drand48() * (*this->_Info->N));
+			pi = (int) (this->_rand() * (*this->_Info->N));
 			p = this->_Info->particles[pi];
 		}
 	}
@@ -67,9 +68,11 @@ void MCTras<number>::apply (llint curr_step) {
 	number delta_E_ext = -p->ext_potential;
 
 	// perform the move
-	p->pos.x += 2. * (drand48() - (number)0.5f) * _delta;
-	p->pos.y += 2. * (drand48() - (number)0.5f) * _delta;
-	p->pos.z += 2. * (drand48() - (number)0.5f) * _delta;
+	double r[3];
+	this->_fill_rand(r, 3);
+	p->pos.x += 2. * (r[0] - (number)0.5f) * _delta;
+	p->pos.y += 2. * (r[1] - (number)0.5f) * _delta;
+	p->pos.z += 2. * (r[2] - (number)0.5f) * _delta;
 
 	// update lists
 	this->_Info->lists->single_update(p);
@@ -83,7 +86,7 @@ void MCTras<number>::apply (llint curr_step) {
 	delta_E_ext += p->ext_potential;
 
 	// accept or reject?
-	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48() )) {
+	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand() )) {
 		// move accepted
 		this->_accepted ++;
 		if (curr_step < this->_equilibration_steps && this->_adjust_moves) {
@@ -11,7 +11,7 @@
 
 template<typename number>
 RotateSite<number>::RotateSite () {
-
+	this->_step_sizes.push_back(&_delta);
 }
 
 template<typename number>
@@ -34,7 +34,7 @@ void RotateSite<number>::apply (llint curr_step) {
 
 	this->_attempted ++;
 
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	JordanParticle<number> *p = (JordanParticle<number> *)this->_Info->particles[pi];
 
 	number delta_E;
@@ -45,10 +45,10 @@ void RotateSite<number>::apply (llint curr_step) {
 	number delta_E_ext = -p->ext_potential;
 
 	// select site
-	int i_patch = (int) (drand48() * (p->N_int_centers));
+	int i_patch = (int) (this->_rand() * (p->N_int_centers));
 	LR_matrix<number> site_store = p->get_patch_rotation(i_patch);
 
-	number t = drand48() * _delta;
+	number t = this->_rand() * _delta;
 	LR_vector<number> axis = Utils::get_random_vector<number>();
 
 	number sintheta = sin(t);
@@ -82,7 +82,7 @@ void RotateSite<number>::apply (llint curr_step) {
 	delta_E_ext += p->ext_potential;
 
 	// accept or reject?
-	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48() )) {
+	if (this->_Info->interaction->get_is_infinite() == false && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_rand() )) {
 		// move accepted
 		// put here the adjustment of moves
 		this->_accepted ++;
@@ -11,6 +11,7 @@
 /// traslation
 template<typename number>
 ShapeMove<number>::ShapeMove () {
+	this->_step_sizes.push_back(&_delta);
 	_verlet_skin = -1.f;
 }
 
@@ -53,7 +54,7 @@ void ShapeMove<number>::apply (llint curr_step) {
 	// select axis NOT to change
 	int preserved_axis = ((int) lrand48()) % 3;
 	int change_axis_1, change_axis_2;
-	if (drand48() > 0.5) {
+	if (this->_rand() > 0.5) {
 		change_axis_1 = (preserved_axis + 1) % 3;
 		change_axis_2 = (preserved_axis + 2) % 3;
 	}
@@ -64,7 +65,7 @@ void ShapeMove<number>::apply (llint curr_step) {
 
 	//printf ("@#@@ preserving axis %d, changing %d and %d\n", preserved_axis, change_axis_1, change_axis_2);
 
-	number dL = _delta * (drand48() - (number) 0.5);
+	number dL = _delta * (this->_rand() - (number) 0.5);
 	LR_vector<number> box_sides = this->_Info->box->box_sides();
 	LR_vector<number> old_box_sides = this->_Info->box->box_sides();
 
@@ -109,7 +110,7 @@ void ShapeMove<number>::apply (llint curr_step) {
 
 	if (fabs (dV) > 1.e-6) throw oxDNAException("Too high dV: %g\n", dV);
 
-	if (this->_Info->interaction->get_is_infinite() == false && exp(- dE / this->_T) > drand48()) {
+	if (this->_Info->interaction->get_is_infinite() == false && exp(- dE / this->_T) > this->_rand()) {
 		this->_accepted ++;
 		if (curr_step < this->_equilibration_steps && this->_adjust_moves) _delta *= this->_acc_fact;
 		//number xE  = this->_Info->interaction->get_system_energy(this->_Info->particles, *this->_Info->N, this->_Info->lists);
@@ -18,6 +18,8 @@
 /// traslation
 template<typename number>
 VMMC<number>::VMMC ()  {
+	this->_step_sizes.push_back(&_delta_tras);
+	this->_step_sizes.push_back(&_delta_rot);
 	_max_move_size_sqr = -1.;
 	_max_move_size = 1.;
 	_max_cluster_size = -1;
@@ -129,11 +131,12 @@ number VMMC<number>::build_cluster (movestr<number> * moveptr, int maxsize) {
 		else qq = itb->first;
 		if (qq->inclust == false) possible_links.insert(ParticlePair<number>(pp, qq));
 	}
-	std::vector<BaseParticle<number> *> neighs1 = this->_Info->lists->get_neigh_list(pp);
+	std::vector<BaseParticle<number> *> neighs1, neighs2;
+	this->_Info->lists->fill_neigh_list(pp, neighs1);
 	_store_particle(pp);
 	_move_particle(moveptr, pp);
 	this->_Info->lists->single_update(pp);
-	std::vector<BaseParticle<number> *> neighs2 = this->_Info->lists->get_neigh_list(pp);
+	this->_Info->lists->fill_neigh_list(pp, neighs2);
 	_restore_particle (pp);
 	this->_Info->lists->single_update(pp);
 	typename std::vector<BaseParticle<number> *>::iterator itt = neighs1.begin();
@@ -228,11 +231,11 @@ number VMMC<number>::build_cluster (movestr<number> * moveptr, int maxsize) {
 					if (tmp->inclust == false) possible_links.insert(ParticlePair<number>(qq, tmp));
 				}
 
-				neighs1 = this->_Info->lists->get_neigh_list(qq);
+				this->_Info->lists->fill_neigh_list(qq, neighs1);
 				_store_particle(qq);
 				_move_particle(moveptr, qq);
 				this->_Info->lists->single_update(qq);
-				neighs2 = this->_Info->lists->get_neigh_list(qq);
+				this->_Info->lists->fill_neigh_list(qq, neighs2);
 				_restore_particle (qq);
 				this->_Info->lists->single_update(qq);
 				for (itt = neighs1.begin(); itt != neighs1.end(); itt ++)
@@ -289,14 +292,14 @@ void VMMC<number>::apply (llint curr_step) {
 	if (_clust.size() > 0) _clust.clear();
 
 	// generate the move
-	int pi = (int) (drand48() * (*this->_Info->N));
+	int pi = (int) (this->_rand() * (*this->_Info->N));
 	BaseParticle<number> *p = this->_Info->particles[pi];
 	movestr<number> move;
 	move.seed = pi;
 	move.seed_strand_id = p->strand_id;
 	//move.type = (drand48() < 0.5) ? VMMC_TRANSLATION : VMMC_ROTATION;
 	move.type = VMMC_TRANSLATION;
-	if (p->is_rigid_body() && (drand48() > 0.5)) move.type = VMMC_ROTATION;
+	if (p->is_rigid_body() && (this->_rand() > 0.5)) move.type = VMMC_ROTATION;
 	if (move.type == VMMC_TRANSLATION) {
 		move.t = LR_vector<number> (Utils::gaussian<number>(), Utils::gaussian<number>(), Utils::gaussian<number>()) *_delta_tras;
 	}
@@ -330,7 +333,7 @@ void VMMC<number>::apply (llint curr_step) {
 		pprime *= exp(-(1. / this->_T) * delta_E_ext);
 	}
 
-	if (this->_Info->interaction->get_is_infinite() == false && pprime > drand48()) {
+	if (this->_Info->interaction->get_is_infinite() == false && pprime > this->_rand()) {
 		// move accepted
 		this->_accepted += 1;
 
@@ -43,7 +43,7 @@ class VMMC : public BaseMove<number> {
 		inline void _move_particle(movestr<number> * moveptr, BaseParticle<number> * p);
 
 		number VMMC_link(double E_new, double E_old) { return (1. - exp((1. / this->_T) * (E_old - E_new)));}
-		inline number _next_rand () {return drand48();}
+		inline number _next_rand () {return this->_rand();}
 
 		number build_cluster (movestr<number> * moveptr, int maxsize);
 		number build_cluster_old (movestr<number> * moveptr, int maxsize);
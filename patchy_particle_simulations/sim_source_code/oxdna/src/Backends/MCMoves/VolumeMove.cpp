@@ -11,6 +11,7 @@
 /// traslation
 template<typename number>
 VolumeMove<number>::VolumeMove ()  {
+	this->_step_sizes.push_back(&_delta);
 	_verlet_skin = -1.f;
 	_isotropic = true;
 }
@@ -62,7 +63,7 @@ void VolumeMove<number>::apply (llint curr_step) {
 	number oldV = this->_Info->box->V();
 
 	if(_isotropic) {
-		number dL = _delta*(drand48() - (number) 0.5);
+		number dL = _delta*(this->_rand() - (number) 0.5);
 		box_sides.x += dL;
 		box_sides.y += dL;
 		box_sides.z += dL;
@@ -70,9 +71,9 @@ void VolumeMove<number>::apply (llint curr_step) {
 		  box_sides.x = box_sides.y = box_sides.z = newL;*/
 	}
 	else {
-		box_sides.x += _delta*(drand48() - (number) 0.5);
-		box_sides.y += _delta*(drand48() - (number) 0.5);
-		box_sides.z += _delta*(drand48() - (number) 0.5);
+		box_sides.x += _delta*(this->_rand() - (number) 0.5);
+		box_sides.y += _delta*(this->_rand() - (number) 0.5);
+		box_sides.z += _delta*(this->_rand() - (number) 0.5);
 	}
 
 	this->_Info->box->init(box_sides[0], box_sides[1], box_sides[2]);
@@ -97,7 +98,7 @@ void VolumeMove<number>::apply (llint curr_step) {
 	number V = this->_Info->box->V();
 	number dV = V - oldV;
 
-	if (this->_Info->interaction->get_is_infinite() == false && exp(-(dE + _P*dV - (N + 1)*this->_T*log(V/oldV))/this->_T) > drand48()) {
+	if (this->_Info->interaction->get_is_infinite() == false && exp(-(dE + _P*dV - (N + 1)*this->_T*log(V/oldV))/this->_T) > this->_rand()) {
 		//printf("B %lld %lf ---- %lf %lf %lf\n", curr_step, newE/N, dE, dV, exp(-(dE + _P*dV - N*this->_T*log(V/oldV))/this->_T));
 		this->_accepted++;
 		if(curr_step < this->_equilibration_steps && this->_adjust_moves) _delta *= this->_acc_fact;
@@ -153,16 +153,16 @@ void MC_CPUBackend<number>::_compute_energy() {
 
 template<typename number>
 inline void MC_CPUBackend<number>::_translate_particle(BaseParticle<number> *p) {
-	p->pos.x += (drand48() - (number)0.5f)*this->_delta[MC_MOVE_TRANSLATION];
-	p->pos.y += (drand48() - (number)0.5f)*this->_delta[MC_MOVE_TRANSLATION];
-	p->pos.z += (drand48() - (number)0.5f)*this->_delta[MC_MOVE_TRANSLATION];
+	p->pos.x += (this->_config_info->rng->uniform() - (number)0.5f)*this->_delta[MC_MOVE_TRANSLATION];
+	p->pos.y += (this->_config_info->rng->uniform() - (number)0.5f)*this->_delta[MC_MOVE_TRANSLATION];
+	p->pos.z += (this->_config_info->rng->uniform() - (number)0.5f)*this->_delta[MC_MOVE_TRANSLATION];
 }
 
 template<typename number>
 inline void MC_CPUBackend<number>::_rotate_particle(BaseParticle<number> *p) {
 	number t;
 	LR_vector<number> axis;
-	if (_enable_flip && drand48() < (1.f / 20.f)) {
+	if (_enable_flip && this->_config_info->rng->uniform() < (1.f / 20.f)) {
 		// flip move
 		//fprintf (stderr, "Flipping %d\n", p->index);
 		t = M_PI / 2.;
@@ -171,7 +171,7 @@ inline void MC_CPUBackend<number>::_rotate_particle(BaseParticle<number> *p) {
 	}
 	else {
 		// normal random move
-		t = (drand48() - (number)0.5f) * this->_delta[MC_MOVE_ROTATION];
+		t = (this->_config_info->rng->uniform() - (number)0.5f) * this->_delta[MC_MOVE_ROTATION];
 		axis = Utils::get_random_vector<number>();
 	}
 
@@ -199,7 +199,7 @@ void MC_CPUBackend<number>::sim_step(llint curr_step) {
 
 	for(int i = 0; i < this->_N; i++) {
 		if (i > 0 && this->_interaction->get_is_infinite() == true) throw oxDNAException ("should not happen %d", i);
-		if (this->_ensemble == MC_ENSEMBLE_NPT && drand48() < 1. / this->_N) {
+		if (this->_ensemble == MC_ENSEMBLE_NPT && this->_config_info->rng->uniform() < 1. / this->_N) {
 			_timer_box->resume();
 			// do npt move
 
@@ -215,7 +215,7 @@ void MC_CPUBackend<number>::sim_step(llint curr_step) {
 			LR_vector<number> box_sides = this->_box->box_sides();
 			LR_vector<number> old_box_sides = box_sides;
 
-			number dL = this->_delta[MC_MOVE_VOLUME] * (drand48() - (number) 0.5);
+			number dL = this->_delta[MC_MOVE_VOLUME] * (this->_config_info->rng->uniform() - (number) 0.5);
 			
 			// isotropic move
 			box_sides.x += dL;
@@ -257,7 +257,7 @@ void MC_CPUBackend<number>::sim_step(llint curr_step) {
 				number V_target = _target_box * _target_box * _target_box;
 				second_factor = fabs(V - V_target) < fabs (oldV - V_target) && dE < _e_tolerance;
 			}
-			else second_factor = exp (-(dE + this->_P * dV - this->_N * this->_T * log (V / oldV)) / this->_T) > drand48();
+			else second_factor = exp (-(dE + this->_P * dV - this->_N * this->_T * log (V / oldV)) / this->_T) > this->_config_info->rng->uniform();
 
 			if (this->_interaction->get_is_infinite() == false && second_factor) {
 				// volume move accepted
@@ -302,10 +302,10 @@ void MC_CPUBackend<number>::sim_step(llint curr_step) {
 		else {
 			_timer_move->resume();
 			// do normal move
-			int pi = (int) (drand48() * this->_N);
+			int pi = (int) (this->_config_info->rng->uniform() * this->_N);
 			BaseParticle<number> *p = this->_particles[pi];
 
-			int move = (drand48() < (number) 0.5f) ? MC_MOVE_TRANSLATION : MC_MOVE_ROTATION;
+			int move = (this->_config_info->rng->uniform() < (number) 0.5f) ? MC_MOVE_TRANSLATION : MC_MOVE_ROTATION;
 			if(!p->is_rigid_body()) move = MC_MOVE_TRANSLATION;
 
 			this->_tries[move]++;
@@ -347,7 +347,7 @@ void MC_CPUBackend<number>::sim_step(llint curr_step) {
 			//if (curr_step > 410000 && curr_step <= 420001)
 			// printf("delta_E: %lf\n", (double)delta_E);
 
-			if(!this->_overlap && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > drand48())) {
+			if(!this->_overlap && ((delta_E + delta_E_ext) < 0 || exp(-(delta_E + delta_E_ext) / this->_T) > this->_config_info->rng->uniform())) {
 				this->_accepted[move]++;
 				this->_U += delta_E;
 				if (curr_step < this->_MC_equilibration_steps && this->_adjust_moves) {
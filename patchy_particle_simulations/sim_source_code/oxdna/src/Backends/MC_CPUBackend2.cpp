@@ -8,6 +8,10 @@
 #include "MC_CPUBackend2.h"
 #include <sstream>
 
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
 template<typename number>
 MC_CPUBackend2<number>::MC_CPUBackend2() : MCBackend<number>() {
 	this->_is_CUDA_sim = false;
@@ -17,23 +21,39 @@ MC_CPUBackend2<number>::MC_CPUBackend2() : MCBackend<number>() {
 	_accumulated_prob = 0.; // total weight
 
 	_MC_Info = ConfigInfo<number>::instance();
+
+	_checkerboard_sweeps = false;
+	_N_threads = 1;
+	_cells = NULL;
+	for(int d = 0; d < 3; d++) _N_domains_side[d] = 0;
+	_checkerboard_timer = NULL;
+	_use_energy_cache = false;
 }
 
 template<typename number>
 MC_CPUBackend2<number>::~MC_CPUBackend2() {
 	for(typename std::vector <BaseMove<number> *>::iterator it = _moves.begin(); it != _moves.end(); it++) delete *it;
+	// the moves of the first thread are the ones in _moves
+	for(unsigned int t = 1; t < _thread_moves.size(); t++) {
+		for(typename std::vector <BaseMove<number> *>::iterator it = _thread_moves[t].begin(); it != _thread_moves[t].end(); it++) delete *it;
+	}
 }
 
 template<typename number>
-void MC_CPUBackend2<number>::add_move (std::string move_string, input_file &sim_inp) {
+BaseMove<number> *MC_CPUBackend2<number>::_make_move(std::string move_string, input_file &sim_inp) {
 	input_file * move_inp = Utils::get_input_file_from_string(move_string);
 
 	BaseMove<number> * new_move = MoveFactory::make_move<number> (*move_inp, sim_inp);
 
-	_moves.push_back (new_move);
-
 	cleanInputFile(move_inp);
 	delete move_inp;
+
+	return new_move;
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::add_move (std::string move_string, input_file &sim_inp) {
+	_moves.push_back (_make_move(move_string, sim_inp));
 }
 
 template<typename number>
@@ -45,14 +65,42 @@ void MC_CPUBackend2<number>::get_settings(input_file &inp) {
 
 	//_MC_Info.lists = this->_lists;
 
+	getInputBool(&inp, "energy_cache", &_use_energy_cache, 0);
+	getInputBool(&inp, "checkerboard_sweeps", &_checkerboard_sweeps, 0);
+	if(_checkerboard_sweeps) {
+#ifdef HAVE_OPENMP
+		_N_threads = omp_get_max_threads();
+		getInputInt(&inp, "checkerboard_threads", &_N_threads, 0);
+		if(_N_threads < 1) throw oxDNAException("(MC_CPUBackend2) checkerboard_threads should be larger than 0");
+		// the number of threads has to be set before the moves and the interaction are initialised
+		omp_set_num_threads(_N_threads);
+		this->_config_info->rng->set_N_threads(_N_threads);
+		OX_LOG(Logger::LOG_INFO, "(MC_CPUBackend2) Using checkerboard sweeps with %d threads", _N_threads);
+#else
+		throw oxDNAException("(MC_CPUBackend2) checkerboard_sweeps = true requires oxDNA to be compiled with OpenMP support (-DOPENMP=ON)");
+#endif
+	}
+
 	std::vector<std::string> move_strings;
 	_N_moves = getInputKeys (&inp, std::string("move_"), &move_strings, 0);
 	if (_N_moves < 1) throw oxDNAException ("(MC_CPUBackend2) No moves found in the input file");
+	_thread_moves.resize(_N_threads);
 	for (int i = 0; i < _N_moves; i ++) {
 		std::string tmps;
 		getInputString (&inp, move_strings[i].c_str(), tmps, 1);
 		add_move (tmps, inp);
+
+		input_file *move_inp = Utils::get_input_file_from_string(tmps);
+		std::string move_type("unknown");
+		getInputString(move_inp, "type", move_type, 0);
+		_move_types.push_back(move_type);
+		cleanInputFile(move_inp);
+		delete move_inp;
+
+		// each additional thread gets its own copy of the move
+		for(int t = 1; t < _N_threads; t++) _thread_moves[t].push_back(_make_move(tmps, inp));
 	}
+	_thread_moves[0] = _moves;
 
 	typename vector<BaseMove<number> *>::iterator it;
 	//for(it = _moves.begin(); it != _moves.end(); it ++) (*it)->get_settings(inp);
@@ -110,13 +158,196 @@ void MC_CPUBackend2<number>::init() {
 		//OX_LOG(Logger::LOG_DEBUG, "(MC_CPUBackend2) Initializing move...");
 		(*it)->init();
 	}
+
+	for(int j = 0; j < _N_moves && _use_energy_cache; j++) {
+		if(!_moves[j]->supports_energy_cache()) {
+			OX_LOG(Logger::LOG_INFO, "(MC_CPUBackend2) Move number %d (%s) does not support the energy cache, which will not be used", j + 1, _move_types[j].c_str());
+			_use_energy_cache = false;
+		}
+	}
+	if(_use_energy_cache) {
+		_energy_cache.init(this->_N, _N_threads);
+		for(int t = 0; t < _N_threads; t++) {
+			for(int j = 0; j < _N_moves; j++) _thread_moves[t][j]->set_energy_cache(&_energy_cache);
+		}
+		OX_LOG(Logger::LOG_INFO, "(MC_CPUBackend2) Caching the energies of the particles");
+	}
+
+	// the range of the moves, and hence the size of the domains, depends on whether the energy cache is used
+	if(_checkerboard_sweeps) _init_checkerboard();
+
+	TimingManager *timings = TimingManager::instance();
+	if(timings->telemetry_enabled()) {
+		if(_checkerboard_sweeps) _checkerboard_timer = timings->new_timer(std::string("Checkerboard sweeps"), std::string("SimBackend"));
+		else {
+			for(int j = 0; j < _N_moves; j++) {
+				std::string desc = Utils::sformat("Move %d (%s)", j + 1, _move_types[j].c_str());
+				_move_timers.push_back(timings->new_timer(desc, std::string("SimBackend")));
+				_move_attempts.push_back(timings->get_counter(desc + " attempts"));
+				_move_accepted.push_back(timings->get_counter(desc + " accepted"));
+			}
+		}
+	}
 }
 
 template<typename number>
-void MC_CPUBackend2<number>::sim_step(llint curr_step) {
+void MC_CPUBackend2<number>::_init_checkerboard() {
+	_cells = dynamic_cast<Cells<number> *>(this->_lists);
+	if(_cells == NULL) throw oxDNAException("(MC_CPUBackend2) checkerboard_sweeps = true requires list_type = cells");
+
+	for(int t = 1; t < _N_threads; t++) {
+		for(int j = 0; j < _N_moves; j++) _thread_moves[t][j]->init();
+	}
+	for(int j = 0; j < _N_moves; j++) {
+		if(!_moves[j]->is_local()) throw oxDNAException("(MC_CPUBackend2) Move number %d cannot be used with checkerboard_sweeps = true, since it is not a local move", j);
+	}
+
+#ifdef HAVE_OPENMP
+	this->_interaction->set_N_threads(_N_threads);
+#endif
+
+	// particles in adjacent cells have to be found among the neighbours found by the lists
+	LR_vector<number> box_sides = this->_box->box_sides();
+	for(int d = 0; d < 3; d++) {
+		number cell_width = box_sides[d] / _cells->get_N_cells_side(d);
+		if(cell_width < this->_interaction->get_rcut()) throw oxDNAException("(MC_CPUBackend2) checkerboard_sweeps = true requires cells that are at least as wide as the interaction range (%g), but along direction %d they are %g wide", this->_interaction->get_rcut(), d, cell_width);
+	}
+
+	// domains that are swept at the same time are separated by a domain, and hence moves acting on them cannot read or
+	// change the same particles if each domain is at least twice as wide as the range of the moves
+	int range = 0;
+	for(int j = 0; j < _N_moves; j++) range = std::max(range, _moves[j]->cell_range());
+	int min_width = 2 * range;
+
+	// there must be an even number of domains along each direction
+	int N_domains = 1;
+	for(int d = 0; d < 3; d++) {
+		int N_cells_side = _cells->get_N_cells_side(d);
+		_N_domains_side[d] = 2 * (N_cells_side / (2 * min_width));
+		if(_N_domains_side[d] == 0) throw oxDNAException("(MC_CPUBackend2) checkerboard_sweeps = true requires at least %d cells along each direction, but there are only %d cells along direction %d", 2 * min_width, N_cells_side, d);
+		N_domains *= _N_domains_side[d];
+
+		_first_cell[d].resize(_N_domains_side[d] + 1);
+		_domain_of_cell[d].resize(N_cells_side);
+		for(int b = 0; b <= _N_domains_side[d]; b++) _first_cell[d][b] = (b * N_cells_side) / _N_domains_side[d];
+		for(int b = 0; b < _N_domains_side[d]; b++) {
+			for(int c = _first_cell[d][b]; c < _first_cell[d][b + 1]; c++) _domain_of_cell[d][c] = b;
+		}
+	}
+
+	_domains.resize(N_domains);
+	for(int i = 0; i < N_domains; i++) _domains[i].cells = _cells;
+
+	OX_LOG(Logger::LOG_INFO, "(MC_CPUBackend2) Checkerboard sweeps: %dx%dx%d domains, moves acting up to %d cells away", _N_domains_side[0], _N_domains_side[1], _N_domains_side[2], range);
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::_sweep_domain(llint curr_step, std::vector<BaseMove<number> *> &moves, MCDomain<number> &domain) {
+	for(int j = 0; j < _N_moves; j++) moves[j]->set_domain(&domain);
+
+	int N_attempts = domain.particles.size();
+	for(int i = 0; i < N_attempts; i++) {
+		number choice = domain.rng.uniform() * _accumulated_prob;
+		int j = 0;
+		number tmp = moves[0]->prob;
+		while (choice > tmp) {
+			j++;
+			tmp += moves[j]->prob;
+		}
+
+		moves[j]->apply (curr_step);
+	}
+
+	for(int j = 0; j < _N_moves; j++) moves[j]->set_domain(NULL);
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::_checkerboard_sweep(llint curr_step) {
+	// the domains are shifted by a random number of cells along each direction
+	int offset[3], N_cells_side[3];
+	for(int d = 0; d < 3; d++) {
+		N_cells_side[d] = _cells->get_N_cells_side(d);
+		offset[d] = (int) (this->_config_info->rng->uniform() * N_cells_side[d]);
+	}
+
+	for(unsigned int i = 0; i < _domains.size(); i++) _domains[i].particles.clear();
 	for(int i = 0; i < this->_N; i++) {
-		// pick a move with a given probability
-		number choice = drand48() * _accumulated_prob;
+		int cell = _cells->get_cell_index(this->_particles[i]->pos);
+		int domain = 0, stride = 1;
+		for(int d = 0; d < 3; d++) {
+			int c = (cell % N_cells_side[d] - offset[d] + N_cells_side[d]) % N_cells_side[d];
+			cell /= N_cells_side[d];
+			domain += stride * _domain_of_cell[d][c];
+			stride *= _N_domains_side[d];
+		}
+		_domains[domain].particles.push_back(i);
+	}
+
+	for(int b = 0; b < (int) _domains.size(); b++) {
+		MCDomain<number> &domain = _domains[b];
+		int idx = b;
+		for(int d = 0; d < 3; d++) {
+			int db = idx % _N_domains_side[d];
+			idx /= _N_domains_side[d];
+			domain.first[d] = (offset[d] + _first_cell[d][db]) % N_cells_side[d];
+			domain.width[d] = _first_cell[d][db + 1] - _first_cell[d][db];
+		}
+	}
+
+	// the step sizes are adapted once all the sets have been swept, using the moves accepted and rejected by all the threads
+	std::vector<llint> attempted(_N_moves), accepted(_N_moves);
+	for(int j = 0; j < _N_moves; j++) {
+		attempted[j] = _moves[j]->get_attempted();
+		accepted[j] = _moves[j]->get_accepted();
+	}
+
+	// the 8 sets of domains are swept in random order
+	int sets[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	for(int i = 7; i > 0; i--) std::swap(sets[i], sets[(int) (this->_config_info->rng->uniform() * (i + 1))]);
+
+	for(int s = 0; s < 8; s++) {
+		// each domain gets its own stream: the streams of a set share a key, drawn from the main stream, and are told
+		// apart by the index of the domain. This makes the trajectory independent of the number of threads
+		uint64_t key = (uint64_t) (this->_config_info->rng->uniform() * 9007199254740992.);
+		_active_domains.clear();
+		for(int b = 0; b < (int) _domains.size(); b++) {
+			int idx = b, set = 0;
+			for(int d = 0; d < 3; d++) {
+				set += ((idx % _N_domains_side[d]) % 2) << d;
+				idx /= _N_domains_side[d];
+			}
+			if(set == sets[s] && _domains[b].particles.size() > 0) {
+				_domains[b].rng.init(key, b);
+				_active_domains.push_back(b);
+			}
+		}
+
+		int N_active = _active_domains.size();
+#ifdef HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+		for(int i = 0; i < N_active; i++) {
+			int t = 0;
+#ifdef HAVE_OPENMP
+			t = omp_get_thread_num();
+#endif
+			_sweep_domain(curr_step, _thread_moves[t], _domains[_active_domains[i]]);
+		}
+	}
+
+	for(int j = 0; j < _N_moves; j++) {
+		for(int t = 1; t < _N_threads; t++) _moves[j]->merge_counters(_thread_moves[t][j]);
+		llint new_accepted = _moves[j]->get_accepted() - accepted[j];
+		llint new_rejected = _moves[j]->get_attempted() - attempted[j] - new_accepted;
+		_moves[j]->adjust(curr_step, new_accepted, new_rejected);
+		for(int t = 1; t < _N_threads; t++) _thread_moves[t][j]->copy_step_sizes(_moves[j]);
+	}
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::_instrumented_sweep(llint curr_step) {
+	for(int i = 0; i < this->_N; i++) {
+		number choice = this->_config_info->rng->uniform() * _accumulated_prob;
 		int j = 0;
 		number tmp = _moves[0]->prob;
 		while (choice > tmp) {
@@ -124,18 +355,91 @@ void MC_CPUBackend2<number>::sim_step(llint curr_step) {
 			tmp += _moves[j]->prob;
 		}
 
-		// now j is the chosen move
+		llint accepted = _moves[j]->get_accepted();
+		_move_timers[j]->resume();
 		_moves[j]->apply (curr_step);
+		_move_timers[j]->pause();
+		_move_attempts[j]->add();
+		_move_accepted[j]->add(_moves[j]->get_accepted() - accepted);
+	}
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::sim_step(llint curr_step) {
+	this->_mytimer->resume();
 
+	if(_checkerboard_sweeps) {
+		if(_checkerboard_timer != NULL) _checkerboard_timer->resume();
+		_checkerboard_sweep(curr_step);
+		if(_checkerboard_timer != NULL) _checkerboard_timer->pause();
 	}
+	else if(!_move_timers.empty()) _instrumented_sweep(curr_step);
+	else {
+		for(int i = 0; i < this->_N; i++) {
+			// pick a move with a given probability
+			number choice = this->_config_info->rng->uniform() * _accumulated_prob;
+			int j = 0;
+			number tmp = _moves[0]->prob;
+			while (choice > tmp) {
+				j++;
+				tmp += _moves[j]->prob;
+			}
+
+			// now j is the chosen move
+			_moves[j]->apply (curr_step);
+
+		}
+	}
+
+	if(_use_energy_cache && this->_check_energy_every > 0 && (curr_step % this->_check_energy_every) == 0) _check_energy_cache(curr_step);
+
+	this->_mytimer->pause();
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::_check_energy_cache(llint curr_step) {
+	for(int i = 0; i < this->_N; i++) {
+		if(!_energy_cache.is_valid(i)) continue;
+
+		number cached = _energy_cache.energy(i);
+		number energy = _moves[0]->particle_energy(this->_particles[i]);
+		if(fabs(energy - cached) > this->_check_energy_threshold) throw oxDNAException("(MC_CPUBackend2) The cached energy of particle %d (%g) differs from the one computed from scratch (%g) at step %lld", i, cached, energy, curr_step);
+	}
+
+	number cached = _moves[0]->cached_system_energy();
+	number energy = this->_interaction->get_system_energy(this->_particles, this->_N, this->_lists);
+	if(fabs(energy - cached) > this->_check_energy_threshold * this->_N) throw oxDNAException("(MC_CPUBackend2) The cached energy of the system (%g) differs from the one computed from scratch (%g) at step %lld", cached, energy, curr_step);
+	_energy_cache.resum();
+}
+
+template<typename number>
+number MC_CPUBackend2<number>::_system_energy() {
+	if(_use_energy_cache) return _moves[0]->cached_system_energy();
+	return this->_interaction->get_system_energy(this->_particles, this->_N, this->_lists);
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::_print_ready_observables(llint curr_step) {
+	if(_use_energy_cache) {
+		this->_U = _system_energy();
+		this->_config_info->system_energy = &this->_U;
+	}
+	MCBackend<number>::_print_ready_observables(curr_step);
+	this->_config_info->system_energy = NULL;
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::fix_diffusion() {
+	MCBackend<number>::fix_diffusion();
+	if(_use_energy_cache) _energy_cache.invalidate_all();
 }
 
 template<typename number>
 void MC_CPUBackend2<number>::print_observables(llint curr_step) {
 	std::string tmpstr("");
-	typename std::vector<BaseMove<number> *>::iterator it;
-	for(it = _moves.begin(); it != _moves.end(); it ++) {
-		number ratio = (*it)->get_acceptance();
+	for(int j = 0; j < (int) _moves.size(); j++) {
+		// the counters of the copies of the moves used by the other threads are added to these after each sweep
+		number ratio = _moves[j]->get_acceptance();
 		tmpstr += Utils::sformat (" %5.3f", ratio);
 	}
 	this->_backend_info.insert(0, tmpstr + "  ");
@@ -157,5 +461,45 @@ void MC_CPUBackend2<number>::_compute_energy() {
 	abort ();
 }
 
+template<typename number>
+void MC_CPUBackend2<number>::_write_backend_state(std::ostream &out) {
+	MCBackend<number>::_write_backend_state(out);
+
+	out.write((char *) &_N_threads, sizeof(int));
+	out.write((char *) &_N_moves, sizeof(int));
+	for(int t = 0; t < _N_threads; t++) {
+		for(int j = 0; j < _N_moves; j++) {
+			std::stringstream move_state;
+			_thread_moves[t][j]->write_state(move_state);
+			Utils::write_blob(out, move_state.str());
+		}
+	}
+}
+
+template<typename number>
+void MC_CPUBackend2<number>::_read_backend_state(std::istream &in) {
+	MCBackend<number>::_read_backend_state(in);
+	// the configuration and the locks are those of the state file
+	if(_use_energy_cache) _energy_cache.invalidate_all();
+
+	int N_threads, N_moves;
+	in.read((char *) &N_threads, sizeof(int));
+	in.read((char *) &N_moves, sizeof(int));
+	if(!in.good() || N_threads < 1) throw oxDNAException("(MC_CPUBackend2) The state file does not contain a valid MC2 state");
+	if(N_moves != _N_moves) throw oxDNAException("(MC_CPUBackend2) The state file contains the state of %d moves, but %d moves are specified", N_moves, _N_moves);
+	// with a different number of threads, the additional copies of the moves start afresh
+	if(N_threads != _N_threads) OX_LOG(Logger::LOG_WARNING, "(MC_CPUBackend2) The state file has been printed by a simulation that used %d threads instead of %d, the simulation will not follow the same trajectory", N_threads, _N_threads);
+	for(int t = 0; t < N_threads; t++) {
+		for(int j = 0; j < _N_moves; j++) {
+			std::stringstream move_state(Utils::read_blob(in));
+			if(t < _N_threads) _thread_moves[t][j]->read_state(move_state);
+		}
+	}
+	// all the copies of a move share the step sizes
+	for(int t = 1; t < _N_threads; t++) {
+		for(int j = 0; j < _N_moves; j++) _thread_moves[t][j]->copy_step_sizes(_moves[j]);
+	}
+}
+
 template class MC_CPUBackend2<float>;
 template class MC_CPUBackend2<double>;
@@ -15,6 +15,36 @@
 
 /**
  * @brief Manages a MC simulation on CPU. It supports NVT and NPT simulations
+ *
+ * If the code has been compiled with OpenMP support, NVT simulations can be run with checkerboard sweeps: the cells are
+ * grouped in 2x2x2 blocks of domains, and the 8 sets of domains that are not next to each other are swept one after the
+ * other. Moves acting on the domains of the same set are carried out in parallel: each domain spans at least twice as
+ * many cells as the range of the moves (see BaseMove::cell_range) along each direction, so that moves acting on
+ * different domains of the same set never read or change the same particles. Since the energy cache extends the range
+ * of the moves, it requires larger domains. The cells have to be at least as wide as the interaction range. The
+ * counters of the copies of the moves used by the different threads are added together after each sweep, and the step
+ * sizes, which are the same for all the threads, are adapted according to the moves accepted and rejected during the
+ * whole sweep (see BaseMove::adjust).
+ * The domains are shifted by a random offset before each sweep, so that particles can cross their boundaries.
+ *
+ * If the telemetry is enabled each move gets its own timer and its own attempt and acceptance counters. Checkerboard
+ * sweeps are timed as a whole.
+ *
+ * If energy_cache = true and all the moves support it, the contributions to the energy of each particle are cached and
+ * updated as the moves are accepted (see ParticleEnergyCache), so that the energy of a particle does not have to be
+ * computed from scratch before moving it. Energies obtained from the cache may differ from the ones computed from
+ * scratch in the last digits, and hence the trajectory, as well as the printed energies, may differ from the ones
+ * obtained without the cache. The energy of the system is also taken from the cache, which keeps it up to date as the
+ * moves are accepted, and it is used by the potential energy observables and by the replica exchanges of the PT
+ * backend. Every check_energy_every steps all the cached energies, as well as the energy of the system, are compared
+ * with energies computed from scratch, and the simulation is stopped if any of them differ by more than
+ * check_energy_threshold.
+ *
+ * @verbatim
+[energy_cache = <bool> (if true, the energies of the particles are cached when all the moves support it. Defaults to false)]
+[checkerboard_sweeps = <bool> (if true, moves are applied in parallel to distant domains of the box. Requires OpenMP support, list_type = cells and local moves only. Defaults to false)]
+[checkerboard_threads = <int> (number of threads used by the checkerboard sweeps. Defaults to the value of OMP_NUM_THREADS or, if it is not set, to the number of cores)]
+@endverbatim
  */
 template<typename number>
 class MC_CPUBackend2: public MCBackend<number> {
@@ -27,6 +57,50 @@ protected:
 	number _accumulated_prob;
 	number _verlet_skin;
 
+	bool _checkerboard_sweeps;
+	int _N_threads;
+	/// copies of the moves used by each thread during checkerboard sweeps. _thread_moves[0] is _moves
+	std::vector<std::vector<BaseMove<number> *> > _thread_moves;
+	Cells<number> *_cells;
+	/// number of domains along each direction
+	int _N_domains_side[3];
+	/// _domain_of_cell[d][c] is the domain containing the c-th cell after the first one along direction d
+	std::vector<int> _domain_of_cell[3];
+	/// _first_cell[d][b] is the index, counted from the first cell, of the first cell of domain b along direction d
+	std::vector<int> _first_cell[3];
+	std::vector<MCDomain<number> > _domains;
+	/// indexes of the domains belonging to the set being swept
+	std::vector<int> _active_domains;
+
+	/// telemetry timers and counters, which are allocated only if the telemetry is enabled (see TimingManager)
+	std::vector<std::string> _move_types;
+	std::vector<Timer *> _move_timers;
+	std::vector<Counter *> _move_attempts;
+	std::vector<Counter *> _move_accepted;
+	Timer *_checkerboard_timer;
+
+	bool _use_energy_cache;
+	ParticleEnergyCache<number> _energy_cache;
+
+	BaseMove<number> *_make_move(std::string move_string, input_file &sim_inp);
+	/// applies the moves of the given thread to the particles of the given domain
+	void _sweep_domain(llint curr_step, std::vector<BaseMove<number> *> &moves, MCDomain<number> &domain);
+	void _init_checkerboard();
+	void _checkerboard_sweep(llint curr_step);
+	/// same as a serial sim_step, but each move is timed and counted separately
+	void _instrumented_sweep(llint curr_step);
+	/// throws an exception if a cached energy differs from the one computed from scratch
+	void _check_energy_cache(llint curr_step);
+	/// returns the energy of the system, taken from the cache if it is used or computed from scratch otherwise
+	number _system_energy();
+
+	/// if the cache is used, the observables get the energy of the system from it
+	virtual void _print_ready_observables(llint curr_step);
+
+	/// on top of the MCBackend state, stores the state of the moves of each thread
+	virtual void _write_backend_state(std::ostream &out);
+	virtual void _read_backend_state(std::istream &in);
+
 public:
 	MC_CPUBackend2();
 	virtual ~MC_CPUBackend2();
@@ -37,7 +111,12 @@ public:
 	void sim_step(llint cur_step);
 	void add_move (std::string move_string, input_file &sim_inp);
 
+	/// returns the moves, in the order in which they have been specified in the input file
+	std::vector<BaseMove<number> *> &get_moves() { return _moves; }
+
 	void print_observables(llint curr_step);
+	/// the particles moved back into the box invalidate the cached energies
+	virtual void fix_diffusion();
 
 	virtual void print_equilibration_info();
 };
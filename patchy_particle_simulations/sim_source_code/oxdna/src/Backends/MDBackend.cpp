@@ -117,7 +117,7 @@ void MDBackend<number>::init() {
 template<typename number>
 bool MDBackend<number>::_is_barostat_active() {
 	if(!_use_barostat) return false;
-	return _barostat_probability > drand48();
+	return _barostat_probability > this->_config_info->rng->uniform();
 }
 
 template<typename number>
@@ -279,5 +279,16 @@ void MD_CPUBackend<number>::init() {
 	}
 }
 
+template<typename number>
+llint MD_CPUBackend<number>::next_event_step(llint curr_step) {
+	llint next = MDBackend<number>::next_event_step(curr_step);
+	if(!_compute_stress_tensor) return next;
+
+	// the backend info set by the step that completes an average should be cleared by the following print_observables,
+	// as it is when print_observables is called on every step
+	llint update = curr_step + _stress_tensor_avg_every - _stress_tensor_counter - 1;
+	return Utils::earliest_step(next, update);
+}
+
 template class MD_CPUBackend<float>;
 template class MD_CPUBackend<double>;
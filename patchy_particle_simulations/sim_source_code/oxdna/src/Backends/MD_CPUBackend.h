@@ -42,6 +42,7 @@ public:
 	void init();
 	void get_settings (input_file &inp);
 	void sim_step(llint cur_step);
+	llint next_event_step(llint curr_step);
 	void activate_thermostat();
 };
 
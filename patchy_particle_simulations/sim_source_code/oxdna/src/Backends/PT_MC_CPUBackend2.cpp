@@ -0,0 +1,268 @@
+/*
+ * PT_MC_CPUBackend2.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include "PT_MC_CPUBackend2.h"
+#include "../Interactions/BaseInteraction.h"
+
+#include "mpi.h"
+
+template<typename number>
+PT_MC_CPUBackend2<number>::PT_MC_CPUBackend2() : MC_CPUBackend2<number>() {
+	_npttemps = 0;
+	_pttemps = NULL;
+	_my_mpi_id = -1;
+	_mpi_nprocs = 0;
+	_which_replica = -1;
+	_pt_move_every = 1000;
+	_pt_exchange_tries = (llint) 0;
+	_pt_exchange_accepted = (llint) 0;
+	_U_ext = (number) 0.;
+	_exchange_conf = NULL;
+	_exchange_state = NULL;
+	_state_size = 0;
+}
+
+template<typename number>
+PT_MC_CPUBackend2<number>::~PT_MC_CPUBackend2() {
+	delete[] _exchange_conf;
+	delete[] _exchange_state;
+	delete[] _pttemps;
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::get_settings(input_file &inp) {
+	MPI_Comm_rank(MPI_COMM_WORLD, &_my_mpi_id);
+	MPI_Comm_size(MPI_COMM_WORLD, &_mpi_nprocs);
+	// all the replicas are started with the same seed, but they have to draw different random numbers
+	this->_config_info->rng->set_replica(_my_mpi_id);
+
+	getInputInt(&inp, "pt_every", &_pt_move_every, 0);
+	if(_pt_move_every < 1) throw oxDNAException("(PT_MC_CPUBackend2) pt_every should be larger than 0");
+
+	std::string tstring;
+	getInputString(&inp, "pt_temp_list", tstring, 1);
+	std::vector<std::string> temps = Utils::split(tstring, ',');
+	_npttemps = temps.size();
+	if(_npttemps == 0) throw oxDNAException("Nothing found in pt_temp_list");
+	if(_npttemps != _mpi_nprocs) throw oxDNAException("Number of PT temperatures does not match number of processes (%d != %d)", _npttemps, _mpi_nprocs);
+
+	_pttemps = new double[_npttemps];
+	for(int i = 0; i < _npttemps; i++) {
+		std::string raw_T = Utils::trim(temps[i]);
+		_pttemps[i] = Utils::get_temperature<number>((char *) raw_T.c_str());
+		if(i > 0 && _pttemps[i] <= _pttemps[i - 1]) OX_LOG(Logger::LOG_WARNING, "(PT_MC_CPUBackend2) Temperatures are not in increasing order. Hoping for the best");
+	}
+
+	// the moves, the interaction and the observables all read T from the input, so we
+	// replace it with the temperature of this replica before anybody has a chance to read it
+	addInput(&inp, Utils::sformat("T = %.15lf", _pttemps[_my_mpi_id]));
+
+	MC_CPUBackend2<number>::get_settings(inp);
+
+	fprintf(stderr, "Replica %d: Running at T=%g\n", _my_mpi_id, this->_T);
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::init() {
+	this->_conf_filename = Utils::sformat("%s%d", this->_conf_filename.c_str(), _my_mpi_id);
+	fprintf(stderr, "REPLICA %d: reading configuration from %s\n", _my_mpi_id, this->_conf_filename.c_str());
+
+	MC_CPUBackend2<number>::init();
+
+	_which_replica = _my_mpi_id;
+
+	_exchange_conf = new PT_MC2_particle_info<number>[this->_N];
+	_state_size = this->_interaction->get_state_size(this->_N);
+	if(_state_size > 0) _exchange_state = new char[_state_size];
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::_compute_total_energy(llint curr_step) {
+	this->_U = this->_system_energy();
+	if(this->_interaction->get_is_infinite()) throw oxDNAException("(PT_MC_CPUBackend2) Replica %d: overlap found while computing the energy for a swap", _my_mpi_id);
+
+	_U_ext = (number) 0.;
+	if(this->_external_forces) {
+		for(int i = 0; i < this->_N; i++) {
+			BaseParticle<number> *p = this->_particles[i];
+			p->set_ext_potential(curr_step, this->_box);
+			_U_ext += p->ext_potential;
+		}
+	}
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::sim_step(llint curr_step) {
+	MC_CPUBackend2<number>::sim_step(curr_step);
+
+	if(curr_step % _pt_move_every != 0 || curr_step == 0) return;
+
+	_compute_total_energy(curr_step);
+
+	// we alternate between (0,1),(2,3),... and (1,2),(3,4),... pairs
+	bool odd_pairs = (((curr_step / _pt_move_every) % 2) == 0);
+	bool im_responsible = ((_my_mpi_id % 2) == odd_pairs);
+	int resp_id, irresp_id;
+	if(im_responsible) {
+		resp_id = _my_mpi_id;
+		irresp_id = _my_mpi_id + 1;
+	}
+	else {
+		resp_id = _my_mpi_id - 1;
+		irresp_id = _my_mpi_id;
+	}
+
+	if(im_responsible) {
+		if(irresp_id >= _mpi_nprocs) return;
+
+		_pt_exchange_tries++;
+		_get_exchange(irresp_id);
+
+		number b1 = 1. / this->_T;
+		number b2 = 1. / _exchange_energy.T;
+		number fact = exp((b1 - b2) * ((this->_U + _U_ext) - (_exchange_energy.U + _exchange_energy.U_ext)));
+
+		if(this->_config_info->rng->uniform() < fact) {
+			_pt_exchange_accepted++;
+
+			// store the other guy's stuff, since we need the buffers to send him ours
+			PT_MC2_particle_info<number> *buffer_conf = new PT_MC2_particle_info<number>[this->_N];
+			memcpy(buffer_conf, _exchange_conf, this->_N * sizeof(PT_MC2_particle_info<number>));
+			PT_MC2_energy_info<number> buffer_energy = _exchange_energy;
+			char *buffer_state = NULL;
+			if(_state_size > 0) {
+				buffer_state = new char[_state_size];
+				memcpy(buffer_state, _exchange_state, _state_size);
+			}
+
+			_build_exchange_energy();
+			_build_exchange_conf();
+			_send_exchange(irresp_id);
+
+			memcpy(_exchange_conf, buffer_conf, this->_N * sizeof(PT_MC2_particle_info<number>));
+			_exchange_energy = buffer_energy;
+			if(_state_size > 0) memcpy(_exchange_state, buffer_state, _state_size);
+
+			_rebuild_exchange_energy();
+			_rebuild_exchange_conf();
+
+			delete[] buffer_conf;
+			delete[] buffer_state;
+		}
+		// send back the guy's conf as it was
+		else _send_exchange(irresp_id);
+	}
+	else {
+		if(resp_id < 0) return;
+
+		_build_exchange_energy();
+		_build_exchange_conf();
+		_send_exchange(resp_id);
+
+		// wait for the conf to use next, which may or may not be our own
+		_get_exchange(resp_id);
+		_rebuild_exchange_energy();
+		_rebuild_exchange_conf();
+	}
+
+	// we should set the forces again if we have swapped conf
+	if(this->_external_forces) {
+		for(int i = 0; i < this->_N; i++) this->_particles[i]->set_ext_potential(curr_step, this->_box);
+	}
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::_send_exchange(int other_id) {
+	_MPI_send_block_data((void *) &_exchange_energy, sizeof(PT_MC2_energy_info<number>), other_id);
+	_MPI_send_block_data((void *) _exchange_conf, this->_N * sizeof(PT_MC2_particle_info<number>), other_id);
+	if(_state_size > 0) _MPI_send_block_data((void *) _exchange_state, _state_size, other_id);
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::_get_exchange(int other_id) {
+	_MPI_receive_block_data((void *) &_exchange_energy, sizeof(PT_MC2_energy_info<number>), other_id);
+	_MPI_receive_block_data((void *) _exchange_conf, this->_N * sizeof(PT_MC2_particle_info<number>), other_id);
+	if(_state_size > 0) _MPI_receive_block_data((void *) _exchange_state, _state_size, other_id);
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::_build_exchange_conf() {
+	for(int i = 0; i < this->_N; i++) {
+		_exchange_conf[i].pos = this->_particles[i]->pos;
+		_exchange_conf[i].orientation = this->_particles[i]->orientation;
+	}
+	if(_state_size > 0) this->_interaction->write_state(this->_particles, this->_N, _exchange_state);
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::_rebuild_exchange_conf() {
+	for(int i = 0; i < this->_N; i++) {
+		BaseParticle<number> *p = this->_particles[i];
+		p->pos = _exchange_conf[i].pos;
+		p->orientation = _exchange_conf[i].orientation;
+		p->orientationT = p->orientation.get_transpose();
+		p->set_positions();
+	}
+	if(_state_size > 0) this->_interaction->read_state(this->_particles, this->_N, _exchange_state);
+
+	this->_lists->global_update(true);
+	if(this->_use_energy_cache) this->_energy_cache.invalidate_all();
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::_build_exchange_energy() {
+	_exchange_energy.U = this->_U;
+	_exchange_energy.U_ext = _U_ext;
+	_exchange_energy.T = this->_T;
+	_exchange_energy.replica_id = _which_replica;
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::_rebuild_exchange_energy() {
+	// the temperature stays the same, since it belongs to the process and not to the configuration
+	this->_U = _exchange_energy.U;
+	_U_ext = _exchange_energy.U_ext;
+	_which_replica = _exchange_energy.replica_id;
+}
+
+template<typename number>
+int PT_MC_CPUBackend2<number>::_MPI_send_block_data(void *data, size_t size, int node_to, int TAG) {
+	int ret = MPI_Send((void *) data, size, MPI_CHAR, node_to, TAG, MPI_COMM_WORLD);
+	if(ret != MPI_SUCCESS) throw oxDNAException("Error while sending MPI message");
+	return 1;
+}
+
+template<typename number>
+int PT_MC_CPUBackend2<number>::_MPI_receive_block_data(void *data, size_t size, int node_from, int TAG) {
+	MPI_Status stat;
+	int ret = MPI_Recv((void *) data, size, MPI_CHAR, node_from, TAG, MPI_COMM_WORLD, &stat);
+	if(ret != MPI_SUCCESS) throw oxDNAException("Error while receiving MPI message");
+	return 1;
+}
+
+template<typename number>
+number PT_MC_CPUBackend2<number>::get_pt_acc() {
+	// the last replica is never responsible, so by definition...
+	if(_pt_exchange_tries == 0) return 0.;
+	return _pt_exchange_accepted / (number) _pt_exchange_tries;
+}
+
+template<typename number>
+char *PT_MC_CPUBackend2<number>::get_replica_info_str() {
+	sprintf(_replica_info, "%d %d", _my_mpi_id, _which_replica);
+	return _replica_info;
+}
+
+template<typename number>
+void PT_MC_CPUBackend2<number>::print_observables(llint curr_step) {
+	this->_backend_info.insert(0, Utils::sformat(" %5.3f", get_pt_acc()));
+
+	MC_CPUBackend2<number>::print_observables(curr_step);
+}
+
+template class PT_MC_CPUBackend2<float>;
+template class PT_MC_CPUBackend2<double>;
@@ -0,0 +1,101 @@
+/**
+ * @file    PT_MC_CPUBackend2.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef PT_MC_CPUBACKEND2_H_
+#define PT_MC_CPUBACKEND2_H_
+
+#include "MC_CPUBackend2.h"
+
+template<typename number>
+struct PT_MC2_particle_info {
+	LR_vector<number> pos;
+	LR_matrix<number> orientation;
+};
+
+template <typename number>
+struct PT_MC2_energy_info {
+	number U, U_ext, T;
+	int replica_id;
+	PT_MC2_energy_info (number _U = 0., number _T = 1.) {
+		U = _U;
+		U_ext = (number) 0.;
+		T = _T;
+		replica_id = 0;
+	}
+};
+
+/**
+ * @brief Parallel tempering version of MC_CPUBackend2. Each MPI process runs one replica.
+ *
+ * Replicas at neighbouring temperatures periodically attempt to swap their configurations. The
+ * interaction-dependent state (e.g. patch locks of PatchyShapeInteraction) travels together with
+ * the configuration (see IBaseInteraction::write_state). Each process reports the swap acceptance
+ * ratio between itself and the next replica as the last column of the backend info.
+ *
+ * This backend is selected with sim_type = PT_MC2 and requires oxDNA_mpi.
+ *
+ * @verbatim
+pt_temp_list = <float>, <float>, ... (temperatures of the replicas, one per MPI process, in increasing order; the value of T is ignored)
+[pt_every = <int> (number of steps between two swap attempts, defaults to 1000)]
+@endverbatim
+ *
+ * Each replica reads its initial configuration from conf_file followed by its MPI rank.
+ */
+template<typename number>
+class PT_MC_CPUBackend2: public MC_CPUBackend2<number> {
+protected:
+	int _npttemps;
+	double *_pttemps;
+
+	char _replica_info[256];
+
+	/// keep track of who's got which replica
+	int _which_replica;
+
+	number _U_ext;
+
+	/// exchanges with the next replica (i.e. the one at the next temperature)
+	llint _pt_exchange_tries, _pt_exchange_accepted;
+
+	int _pt_move_every;
+	int _my_mpi_id, _mpi_nprocs;
+	int _MPI_send_block_data(void *data, size_t size, int node_to, int TAG=1);
+	int _MPI_receive_block_data(void *data, size_t size, int node_from, int TAG=1);
+
+	void _compute_total_energy(llint curr_step);
+
+	void _build_exchange_conf();
+	void _rebuild_exchange_conf();
+	void _build_exchange_energy();
+	void _rebuild_exchange_energy();
+	void _get_exchange(int other);
+	void _send_exchange(int other);
+
+	PT_MC2_particle_info<number> *_exchange_conf;
+	PT_MC2_energy_info<number> _exchange_energy;
+	/// interaction-dependent state of the exchanged configuration
+	char *_exchange_state;
+	size_t _state_size;
+
+public:
+	PT_MC_CPUBackend2();
+	virtual ~PT_MC_CPUBackend2();
+
+	virtual void get_settings(input_file &inp);
+	void init();
+
+	int get_mpi_id () { return _my_mpi_id; }
+	int get_which_replica () { return _which_replica; }
+	char *get_replica_info_str ();
+	number get_pt_acc ();
+
+	void sim_step(llint cur_step);
+	void print_observables(llint curr_step);
+};
+
+#endif /* PT_MC_CPUBACKEND2_H_ */
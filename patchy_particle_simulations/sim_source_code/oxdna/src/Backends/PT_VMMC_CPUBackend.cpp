@@ -39,6 +39,8 @@ void PT_VMMC_CPUBackend<number>::init () {
 
 	MPI_Comm_rank (MPI_COMM_WORLD, &(_my_mpi_id));
 	MPI_Comm_size (MPI_COMM_WORLD, &(_mpi_nprocs));
+	// all the replicas are started with the same seed, but they have to draw different random numbers
+	this->_config_info->rng->set_replica(_my_mpi_id);
 
 	char my_conf_filename[1024];
 	sprintf (my_conf_filename, "%s%d",this->_conf_filename.c_str(), _my_mpi_id);
@@ -309,7 +311,7 @@ void PT_VMMC_CPUBackend<number>::sim_step(llint curr_step) {
 				}
 
 				//printf ("(from %d) fact: %lf\n", _my_mpi_id, fact);
-				if (drand48() < fact) {
+				if (this->_config_info->rng->uniform() < fact) {
 					this->_pt_exchange_accepted ++;
 					// send my conf over there
 					// store the other guy's
@@ -7,6 +7,9 @@
 
 #include <sstream>
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
 
 #include "SimBackend.h"
 #include "../Utilities/Utils.h"
@@ -18,7 +21,14 @@
 #include "../PluginManagement/PluginManager.h"
 #include "../Particles/BaseParticle.h"
 #include "../Observables/ObservableOutput.h"
+#include "../Observables/StopCondition.h"
+#include "../Observables/ObservableFactory.h"
 #include "../Utilities/Timings.h"
+#include "../Utilities/AsyncWriter.h"
+#include "../Utilities/CompressedTrajectory.h"
+
+// written between the configuration and the other sections of a state file
+static const char state_magic[] = "OXSTATE";
 
 template<typename number>
 SimBackend<number>::SimBackend() {
@@ -52,10 +62,20 @@ SimBackend<number>::SimBackend() {
 	_box = NULL;
 	_max_io = 1.e30;
 	_read_conf_step = -1;
+	_first_conf_offset = 0;
 	_conf_interval = -1;
 	_obs_output_trajectory = _obs_output_stdout = _obs_output_file = _obs_output_reduced_conf = _obs_output_last_conf = _obs_output_checkpoints = _obs_output_last_checkpoint = NULL;
 	_mytimer = NULL;
 	_restart_step_counter = false;
+	_state_every = 0;
+	_last_state_step = -1;
+	_restart_from_state = false;
+	_state_conf = NULL;
+	_last_stop_check_step = -1;
+	_async_output = false;
+	_async_output_buffer = 64.;
+	_async_writer = NULL;
+	_conf_reader = NULL;
 
 	ConfigInfo<number>::init();
 	_config_info = ConfigInfo<number>::instance();
@@ -63,6 +83,9 @@ SimBackend<number>::SimBackend() {
 
 template<typename number>
 SimBackend<number>::~SimBackend() {
+	// the output streams can be closed only once the queued output has been written
+	if(_async_writer != NULL) delete _async_writer;
+
 	if(_particles != NULL) {
 		for(int i = 0; i < _N; i++) delete _particles[i];
 		delete[] _particles;
@@ -106,6 +129,9 @@ SimBackend<number>::~SimBackend() {
 	*/
 
 	for(typename vector<ObservableOutput<number> *>::iterator it = _obs_outputs.begin(); it != _obs_outputs.end(); it++) delete *it;
+	for(typename vector<StopCondition<number> *>::iterator it = _stop_conditions.begin(); it != _stop_conditions.end(); it++) delete *it;
+	if(_state_conf != NULL) delete _state_conf;
+	if(_conf_reader != NULL) delete _conf_reader;
 
 	// destroy lists;
 	if (_lists != NULL) delete _lists;
@@ -137,8 +163,19 @@ void SimBackend<number>::get_settings(input_file &inp) {
 	getInputBool(&inp, "restart_step_counter", &_restart_step_counter, 0);
 
 	// reload configuration
-	std::string reload_from;
-	if (getInputString (&inp, "reload_from", reload_from, 0) == KEY_FOUND) {
+	std::string reload_from, restart_from;
+	if(getInputString(&inp, "restart_from_state", restart_from, 0) == KEY_FOUND) {
+		std::string tmpstring;
+		if(getInputString(&inp, "reload_from", tmpstring, 0) == KEY_FOUND) throw oxDNAException("Input file error: \"reload_from\" cannot be specified if \"restart_from_state\" is specified");
+		if(getInputString(&inp, "conf_file", tmpstring, 0) == KEY_FOUND) throw oxDNAException("Input file error: \"conf_file\" cannot be specified if \"restart_from_state\" is specified");
+		if(_restart_step_counter) throw oxDNAException("Input file error: \"restart_step_counter\" must be set to false if \"restart_from_state\" is specified");
+		int my_seed;
+		if(getInputInt(&inp, "seed", &my_seed, 0) == KEY_FOUND) throw oxDNAException("Input file error: \"seed\" must not be specified if \"restart_from_state\" is specified");
+
+		_restart_from_state = true;
+		_conf_filename = restart_from;
+	}
+	else if (getInputString (&inp, "reload_from", reload_from, 0) == KEY_FOUND) {
 		// set default variables in this case
 		_initial_conf_is_binary = true;
 
@@ -159,6 +196,7 @@ void SimBackend<number>::get_settings(input_file &inp) {
 	}
 
 	getInputBool(&inp, "binary_initial_conf", &_initial_conf_is_binary, 0);
+	if(_restart_from_state) _initial_conf_is_binary = true;
 	if (_initial_conf_is_binary){
 		OX_LOG(Logger::LOG_INFO, "Reading binary configuration");
 	}
@@ -174,6 +212,26 @@ void SimBackend<number>::get_settings(input_file &inp) {
 	_reseed = (getInputInt (&inp, "seed", &tmpi, 0) == KEY_NOT_FOUND || tmpi == 0);
 
 	getInputInt(&inp, "confs_to_skip", &_confs_to_skip, 0);
+	if(_restart_from_state && _confs_to_skip > 0) throw oxDNAException("Input file error: \"confs_to_skip\" cannot be larger than 0 if \"restart_from_state\" is specified");
+
+	if(getInputString(&inp, "state_file", _state_file, 0) == KEY_FOUND) {
+		std::string prefix;
+		getInputString(&inp, "output_prefix", prefix, 0);
+		_state_file = prefix + _state_file;
+	}
+	getInputBool(&inp, "async_output", &_async_output, 0);
+	getInputDouble(&inp, "async_output_buffer", &_async_output_buffer, 0);
+	if(_async_output_buffer <= 0.) throw oxDNAException("async_output_buffer should be larger than 0");
+
+	getInputLLInt(&inp, "state_every", &_state_every, 0);
+	if(_state_every < 0) throw oxDNAException("state_every should be a non-negative integer");
+	if(_state_every > 0 && _state_file.empty()) throw oxDNAException("Input file error: \"state_file\" must be specified if \"state_every\" is larger than 0");
+	if(!_state_file.empty()) {
+		input_file *state_inp = Utils::get_input_file_from_string("type = binary_configuration");
+		_state_conf = ObservableFactory::make_observable<number>(*state_inp, inp);
+		cleanInputFile(state_inp);
+		delete state_inp;
+	}
 
 	int val = getInputBoolAsInt(&inp, "external_forces", &tmp, 0);
 	if(val == KEY_FOUND) {
@@ -214,6 +272,22 @@ void SimBackend<number>::get_settings(input_file &inp) {
 		i++;
 	}
 
+	// and here the _stop_conditions one
+	i = 1;
+	found = true;
+	while(found) {
+		stringstream ss;
+		ss << "stop_condition_" << i;
+		string cond_string;
+		if(getInputString(&inp, ss.str().c_str(), cond_string, 0) == KEY_FOUND) {
+			StopCondition<number> *new_cond = new StopCondition<number>(i, cond_string, inp);
+			_stop_conditions.push_back(new_cond);
+		}
+		else found = false;
+
+		i++;
+	}
+
 	if(getInputBoolAsInt(&inp, "back_in_box", &tmp, 0) == KEY_FOUND){
 		_back_in_box = (tmp != 0);
 		if (_back_in_box) OX_LOG(Logger::LOG_INFO, "ascii configuration files will have the particles put back in the box");
@@ -229,8 +303,11 @@ void SimBackend<number>::get_settings(input_file &inp) {
 	// Trajectory
 	getInputString(&inp, "trajectory_file", traj_file, 1);
 	std::string fake = Utils::sformat("{\n\tname = %s\n\tprint_every = 0\n}\n", traj_file.c_str());
+	std::string traj_format("text");
+	getInputString(&inp, "trajectory_format", traj_format, 0);
+	if(traj_format != "text" && traj_format != "compressed") throw oxDNAException("Unsupported trajectory_format '%s' (should be either text or compressed)", traj_format.c_str());
 	_obs_output_trajectory = new ObservableOutput<number>(fake, inp);
-	_obs_output_trajectory->add_observable("type = configuration");
+	_obs_output_trajectory->add_observable((traj_format == "text") ? "type = configuration" : "type = compressed_configuration");
 	_obs_outputs.push_back(_obs_output_trajectory);
 
 	// Last configuration
@@ -298,6 +375,10 @@ template<typename number>
 void SimBackend<number>::init() {
 	_conf_input.open(_conf_filename.c_str());
 	if(_conf_input.good() == false) throw oxDNAException("Can't read configuration file '%s'", _conf_filename.c_str());
+	if(!_initial_conf_is_binary && CompressedTrajectory::is_compressed_trajectory(_conf_filename)) {
+		_conf_reader = new CompressedTrajectoryReader(_conf_filename);
+		OX_LOG(Logger::LOG_INFO, "'%s' is a compressed trajectory containing %d configuration(s)", _conf_filename.c_str(), _conf_reader->N_frames());
+	}
 
 	_interaction->init();
 
@@ -317,11 +398,17 @@ void SimBackend<number>::init() {
 				throw oxDNAException ("Found an interaction with bonded interactions that did not set the affected attribute for particle %d. Aborting\n", p->index);
 	}
 
-	_conf_input.seekg(0, ios::beg);
+	_conf_input.seekg(_first_conf_offset, ios::beg);
 
 	// we need to skip a certain number of lines, depending on how many
 	// particles we have and how many configurations we want to skip
-	if(_confs_to_skip > 0) {
+	if(_confs_to_skip > 0 && _conf_reader != NULL) {
+		// compressed trajectories are indexed, and so the configurations need not be read
+		OX_LOG(Logger::LOG_INFO, "Skipping %d configuration(s)", _confs_to_skip);
+		if(_confs_to_skip >= _conf_reader->N_frames()) throw oxDNAException("Skipping %d configuration(s) is not possible, as the initial configuration file only contains %d.", _confs_to_skip, _conf_reader->N_frames());
+		_conf_reader->seek(_confs_to_skip);
+	}
+	else if(_confs_to_skip > 0) {
 		OX_LOG(Logger::LOG_INFO, "Skipping %d configuration(s)", _confs_to_skip);
 		int i;
 		for(i = 0; i < _confs_to_skip && _conf_input.good(); i++) {
@@ -335,6 +422,7 @@ void SimBackend<number>::init() {
 	bool check = false;
 	check = _read_next_configuration(_initial_conf_is_binary);
 	if(!check) throw oxDNAException("Could not read the initial configuration, aborting");
+	if(_restart_from_state) _read_state_sections();
 
 	_start_step_from_file = (_restart_step_counter) ? 0 : _read_conf_step;
 	_config_info->curr_step = _start_step_from_file;
@@ -353,8 +441,24 @@ void SimBackend<number>::init() {
 	// read_topology() since _particles has to be initialized
 	_config_info->set(_particles, _interaction, &_N, &_backend_info, _lists, _box);
 
+	// the interaction state has to be restored before anything (e.g. the moves) is initialised with it
+	if(_state_sections.count("interaction") > 0) {
+		std::string &data = _state_sections["interaction"];
+		if(data.size() != _interaction->get_state_size(_N)) throw oxDNAException("The interaction state contained in '%s' has the wrong size (%d bytes instead of %d)", _conf_filename.c_str(), (int) data.size(), (int) _interaction->get_state_size(_N));
+		_interaction->read_state(_particles, _N, data.c_str());
+		_state_sections.erase("interaction");
+	}
+
+	if(_async_output) {
+		_async_writer = new AsyncWriter((size_t) (_async_output_buffer * 1024. * 1024.));
+		for(typename vector<ObservableOutput<number> *>::iterator it = _obs_outputs.begin(); it != _obs_outputs.end(); it++) (*it)->set_writer(_async_writer);
+		OX_LOG(Logger::LOG_INFO, "Output files will be written asynchronously (buffer size: %g MB)", _async_output_buffer);
+	}
+
 	typename vector<ObservableOutput<number> *>::iterator it;
 	for(it = _obs_outputs.begin(); it != _obs_outputs.end(); it++) (*it)->init(*_config_info);
+	for(typename vector<StopCondition<number> *>::iterator sc = _stop_conditions.begin(); sc != _stop_conditions.end(); sc++) (*sc)->init(*_config_info);
+	if(_state_conf != NULL) _state_conf->init(*_config_info);
 
 	OX_LOG(Logger::LOG_INFO, "N: %d", _N);
 }
@@ -378,12 +482,79 @@ LR_vector<number_n> SimBackend<number>::_read_next_vector(bool binary) {
 	return res;
 }
 
+// the conversions used by the stream extraction operators
+template<typename number_n> static inline number_n _parse_value(const char *str, char **end);
+
+template<> inline double _parse_value<double>(const char *str, char **end) {
+	return strtod(str, end);
+}
+
+template<> inline float _parse_value<float>(const char *str, char **end) {
+	return strtof(str, end);
+}
+
+template<typename number>
+int SimBackend<number>::_read_text_particles() {
+	_conf_lines.clear();
+	_conf_line_offsets.resize(_N);
+	int N_lines = 0;
+	std::string line;
+	while(N_lines < _N && std::getline(_conf_input, line)) {
+		if(line.find_first_not_of(" \t\r") == std::string::npos) continue;
+		_conf_line_offsets[N_lines] = _conf_lines.size();
+		_conf_lines.append(line);
+		_conf_lines.push_back('\0');
+		N_lines++;
+	}
+
+	_conf_positions.resize(3 * N_lines);
+	_conf_values.resize(12 * N_lines);
+	int malformed = N_lines;
+	const char *lines = _conf_lines.c_str();
+#ifdef HAVE_OPENMP
+#pragma omp parallel for if(N_lines > 10000)
+#endif
+	for(int i = 0; i < N_lines; i++) {
+		const char *str = lines + _conf_line_offsets[i];
+		char *end;
+		bool ok = true;
+		for(int j = 0; j < 3 && ok; j++) {
+			_conf_positions[3 * i + j] = _parse_value<double>(str, &end);
+			ok = (end != str);
+			str = end;
+		}
+		for(int j = 0; j < 12 && ok; j++) {
+			_conf_values[12 * i + j] = _parse_value<number>(str, &end);
+			ok = (end != str);
+			str = end;
+		}
+		if(!ok) {
+#ifdef HAVE_OPENMP
+#pragma omp critical
+#endif
+			if(i < malformed) malformed = i;
+		}
+	}
+	if(malformed < N_lines) throw oxDNAException("The line of particle %d of the configuration at step %lld contains less than 15 numbers: '%s'", malformed, _read_conf_step, lines + _conf_line_offsets[malformed]);
+
+	return N_lines;
+}
+
 template<typename number>
 bool SimBackend<number>::_read_next_configuration(bool binary) {
 	double Lx, Ly, Lz;
+	TrajectoryFrame frame;
 	// parse headers. Binary and ascii configurations have different headers, and hence
 	// we have to separate the two procedures
-	if(binary) {
+	if(_conf_reader != NULL) {
+		if(!_conf_reader->read_next(frame)) return false;
+		if(frame.N() != _N) throw oxDNAException("The configuration at step %lld of '%s' contains %d particles, but the topology contains %d", frame.step, _conf_filename.c_str(), frame.N(), _N);
+		_read_conf_step = frame.step;
+		Lx = frame.box[0];
+		Ly = frame.box[1];
+		Lz = frame.box[2];
+	}
+	else if(binary) {
 
 		// first bytes: step
 		// if there's nothing to read, _read_conf_step is unchanged and equal to -1
@@ -403,6 +574,7 @@ bool SimBackend<number>::_read_next_configuration(bool binary) {
 			OX_LOG(Logger::LOG_INFO,"Overriding seed: restoring seed: %hu %hu %hu from binary conf", rndseed[0], rndseed[1], rndseed[2]);
 			seed48 (rndseed);
 		}
+		if (_config_info->rng->is_philox()) _config_info->rng->read_state(_conf_input, _reseed);
 
 		double tmpf;
 		_conf_input.read ((char *)&Lx, sizeof(double));
@@ -466,18 +638,30 @@ bool SimBackend<number>::_read_next_configuration(bool binary) {
 		scdm[k] = LR_vector<double> ((double)0., (double)0., (double)0.);
 	}
 
+	// text configurations are read in one go
+	int N_lines = (_conf_reader == NULL && !binary) ? _read_text_particles() : -1;
+
 	i = 0;
-	while(!_conf_input.eof() && i < _N) {
+	while(i < _N && ((N_lines > -1) ? i < N_lines : !_conf_input.eof())) {
 		BaseParticle<number> *p = this->_particles[i];
 
-		tmp_poss[i] = _read_next_vector<double>(binary);
+		if(_conf_reader != NULL) tmp_poss[i] = LR_vector<double>(frame.pos[3 * i], frame.pos[3 * i + 1], frame.pos[3 * i + 2]);
+		else if(!binary) tmp_poss[i] = LR_vector<double>(_conf_positions[3 * i], _conf_positions[3 * i + 1], _conf_positions[3 * i + 2]);
+		else tmp_poss[i] = _read_next_vector<double>(binary);
 		k = p->strand_id;
 		scdm[k] += tmp_poss[i];
 		nins[k] ++;
 
-		if (!binary) {
-			p->orientation.v1 = _read_next_vector<number>(binary);
-			p->orientation.v3 = _read_next_vector<number>(binary);
+		if(_conf_reader != NULL) {
+			double *o = &frame.orientation[9 * i];
+			p->orientation.v1 = LR_vector<number>(o[0], o[1], o[2]);
+			p->orientation.v2 = LR_vector<number>(o[3], o[4], o[5]);
+			p->orientation.v3 = LR_vector<number>(o[6], o[7], o[8]);
+		}
+		else if (!binary) {
+			number *values = &_conf_values[12 * i];
+			p->orientation.v1 = LR_vector<number>(values[0], values[1], values[2]);
+			p->orientation.v3 = LR_vector<number>(values[3], values[4], values[5]);
 			// get v2 from v1 and v3
 			p->orientation.v1.normalize();
 			p->orientation.v3.normalize();
@@ -501,8 +685,23 @@ bool SimBackend<number>::_read_next_configuration(bool binary) {
 		if(p->orientation.v1.module() < 0.9 || p->orientation.v2.module() < 0.9 || p->orientation.v3.module() < 0.9) throw oxDNAException("Invalid orientation for particle %d: at least one of the vectors is a null vector", p->index);
 		p->orientation.transpone();
 
-		p->vel = _read_next_vector<number>(binary);
-		p->L = _read_next_vector<number>(binary);
+		if(_conf_reader != NULL) {
+			if(frame.vel.empty()) p->vel = p->L = LR_vector<number>((number) 0., (number) 0., (number) 0.);
+			else {
+				double *v = &frame.vel[6 * i];
+				p->vel = LR_vector<number>(v[0], v[1], v[2]);
+				p->L = LR_vector<number>(v[3], v[4], v[5]);
+			}
+		}
+		else if(!binary) {
+			number *values = &_conf_values[12 * i];
+			p->vel = LR_vector<number>(values[6], values[7], values[8]);
+			p->L = LR_vector<number>(values[9], values[10], values[11]);
+		}
+		else {
+			p->vel = _read_next_vector<number>(binary);
+			p->L = _read_next_vector<number>(binary);
+		}
 
 		p->init();
 		p->orientationT = p->orientation.get_transpose();
@@ -511,14 +710,8 @@ bool SimBackend<number>::_read_next_configuration(bool binary) {
 		i++;
 	}
 
-	// this is needed because, if reading from an ascii trajectory, at this stage the _conf_input pointer points to a \n
-	if(!binary && !_conf_input.eof()) {
-		std::string line;
-		std::getline(_conf_input,line);
-	}
-	
 	// discarding the final '\n' in the binary file...
-	if (binary && !_conf_input.eof()) {
+	if (_conf_reader == NULL && binary && !_conf_input.eof()) {
 		char tmpc;
 		_conf_input.read ((char *)&tmpc, sizeof(char));
 	}
@@ -588,6 +781,205 @@ void SimBackend<number>::print_observables(llint curr_step) {
 	_backend_info = std::string ("");
 }
 
+template<typename number>
+bool SimBackend<number>::check_stop_conditions(llint curr_step) {
+	// a simulation restarted from a state printed after the check goes on with the next step
+	if(curr_step == _last_stop_check_step) return false;
+	_last_stop_check_step = curr_step;
+
+	bool stop = false;
+	bool checkpoint = false;
+	typename vector<StopCondition<number> *>::iterator it;
+	for(it = _stop_conditions.begin(); it != _stop_conditions.end(); it++) {
+		int result = (*it)->check(curr_step);
+		if(result == StopCondition<number>::STOP) stop = true;
+		else if(result == StopCondition<number>::CHECKPOINT) {
+			print_conf(curr_step, false, true);
+			if(_obs_output_last_checkpoint != NULL) _obs_output_last_checkpoint->print_output(curr_step);
+			checkpoint = true;
+		}
+	}
+	// the state is printed only once all the conditions have been checked, so that it contains their latest state
+	if(checkpoint) print_state(curr_step, true);
+
+	return stop;
+}
+
+template<typename number>
+llint SimBackend<number>::next_event_step(llint curr_step) {
+	llint next = -1;
+	typename vector<ObservableOutput<number> *>::iterator it;
+	for(it = _obs_outputs.begin(); it != _obs_outputs.end(); it++) {
+		next = Utils::earliest_step(next, (*it)->next_ready_step(curr_step));
+	}
+
+	typename vector<StopCondition<number> *>::iterator sc;
+	for(sc = _stop_conditions.begin(); sc != _stop_conditions.end(); sc++) {
+		next = Utils::earliest_step(next, (*sc)->next_check_step(curr_step));
+	}
+
+	if(!_state_file.empty()) next = Utils::earliest_step(next, Utils::next_multiple(curr_step, _state_every));
+
+	return next;
+}
+
+template<typename number>
+void SimBackend<number>::print_state(llint curr_step, bool force) {
+	if(_state_file.empty() || curr_step == _last_state_step) return;
+	if(!force && (_state_every == 0 || (curr_step % _state_every) != 0 || curr_step <= _start_step_from_file)) return;
+
+	// the outputs the state refers to have to be on disk before the state is
+	flush_output();
+
+	// the lists of the restarted simulation will be built from scratch, and so have to be these
+	_lists->global_update(true);
+
+	std::stringstream state;
+	state << _state_conf->get_output_string(curr_step) << '\n';
+	state.write(state_magic, sizeof(state_magic));
+
+	std::map<std::string, std::string> sections;
+
+	std::stringstream rng;
+	unsigned short rndseed[3];
+	Utils::get_seed(rndseed);
+	rng.write((char *) rndseed, 3 * sizeof(unsigned short));
+	if(_config_info->rng->is_philox()) _config_info->rng->write_state(rng);
+	sections["rng"] = rng.str();
+
+	std::string interaction(_interaction->get_state_size(_N), '\0');
+	if(interaction.size() > 0) _interaction->write_state(_particles, _N, &interaction[0]);
+	sections["interaction"] = interaction;
+
+	std::stringstream backend;
+	_write_backend_state(backend);
+	sections["backend"] = backend.str();
+
+	std::stringstream observables;
+	int N_outputs = _obs_outputs.size();
+	observables.write((char *) &N_outputs, sizeof(int));
+	for(int i = 0; i < N_outputs; i++) {
+		std::stringstream output;
+		_obs_outputs[i]->write_state(output);
+		Utils::write_blob(observables, _obs_outputs[i]->get_output_name());
+		Utils::write_blob(observables, output.str());
+	}
+	sections["observables"] = observables.str();
+
+	std::stringstream conditions;
+	bool checked = (_last_stop_check_step == curr_step);
+	int N_conditions = _stop_conditions.size();
+	conditions.write((char *) &checked, sizeof(bool));
+	conditions.write((char *) &N_conditions, sizeof(int));
+	for(int i = 0; i < N_conditions; i++) {
+		std::stringstream condition;
+		_stop_conditions[i]->write_state(condition);
+		Utils::write_blob(conditions, condition.str());
+	}
+	sections["stop_conditions"] = conditions.str();
+
+	int N_sections = sections.size();
+	state.write((char *) &N_sections, sizeof(int));
+	for(std::map<std::string, std::string>::iterator it = sections.begin(); it != sections.end(); it++) {
+		Utils::write_blob(state, it->first);
+		Utils::write_blob(state, it->second);
+	}
+
+	std::string data = state.str();
+	std::string tmp_name = _state_file + ".tmp";
+	FILE *out = fopen(tmp_name.c_str(), "wb");
+	if(out == NULL) throw oxDNAException("Cannot open '%s' for writing", tmp_name.c_str());
+	bool ok = (fwrite(data.c_str(), 1, data.size(), out) == data.size());
+	ok = ok && (fflush(out) == 0) && (fsync(fileno(out)) == 0);
+	ok = (fclose(out) == 0) && ok;
+	if(!ok) throw oxDNAException("Error while writing the state to '%s'", tmp_name.c_str());
+	if(rename(tmp_name.c_str(), _state_file.c_str()) != 0) throw oxDNAException("Cannot rename '%s' to '%s'", tmp_name.c_str(), _state_file.c_str());
+
+	_last_state_step = curr_step;
+	OX_DEBUG("State printed to '%s' at step %lld (%s)", _state_file.c_str(), curr_step, Utils::bytes_to_human(data.size()).c_str());
+}
+
+template<typename number>
+void SimBackend<number>::flush_output() {
+	if(_async_writer != NULL) _async_writer->flush();
+}
+
+template<typename number>
+void SimBackend<number>::_read_state_sections() {
+	char magic[sizeof(state_magic)];
+	_conf_input.read(magic, sizeof(state_magic));
+	if(!_conf_input.good() || memcmp(magic, state_magic, sizeof(state_magic)) != 0) throw oxDNAException("'%s' is not a state file", _conf_filename.c_str());
+
+	int N_sections;
+	_conf_input.read((char *) &N_sections, sizeof(int));
+	if(!_conf_input.good() || N_sections < 0) throw oxDNAException("Malformed state file '%s'", _conf_filename.c_str());
+	for(int i = 0; i < N_sections; i++) {
+		std::string name = Utils::read_blob(_conf_input);
+		_state_sections[name] = Utils::read_blob(_conf_input);
+	}
+}
+
+template<typename number>
+void SimBackend<number>::restore_state() {
+	if(!_restart_from_state) return;
+
+	if(_state_sections.count("backend") > 0) {
+		std::stringstream backend(_state_sections["backend"]);
+		_read_backend_state(backend);
+	}
+
+	if(_state_sections.count("observables") > 0) {
+		std::stringstream observables(_state_sections["observables"]);
+		int N_outputs;
+		observables.read((char *) &N_outputs, sizeof(int));
+		if(!observables.good() || N_outputs < 0) throw oxDNAException("Malformed observable state in '%s'", _conf_filename.c_str());
+		// outputs are matched by name, so that outputs can be added or removed between restarts
+		std::vector<bool> restored(_obs_outputs.size(), false);
+		for(int i = 0; i < N_outputs; i++) {
+			std::string name = Utils::read_blob(observables);
+			std::stringstream output(Utils::read_blob(observables));
+			bool found = false;
+			for(unsigned int j = 0; j < _obs_outputs.size() && !found; j++) {
+				if(!restored[j] && _obs_outputs[j]->get_output_name() == name) {
+					_obs_outputs[j]->read_state(output);
+					restored[j] = found = true;
+				}
+			}
+			if(!found) OX_LOG(Logger::LOG_WARNING, "The state file contains the state of the output stream '%s', which does not exist any more", name.c_str());
+		}
+	}
+
+	if(_state_sections.count("stop_conditions") > 0) {
+		std::stringstream conditions(_state_sections["stop_conditions"]);
+		bool checked;
+		int N_conditions;
+		conditions.read((char *) &checked, sizeof(bool));
+		conditions.read((char *) &N_conditions, sizeof(int));
+		if(!conditions.good()) throw oxDNAException("Malformed stop condition state in '%s'", _conf_filename.c_str());
+		if(checked) _last_stop_check_step = _read_conf_step;
+		if(N_conditions != (int) _stop_conditions.size()) OX_LOG(Logger::LOG_WARNING, "The state file contains the state of %d stop conditions, but %d are specified: their state will not be restored", N_conditions, (int) _stop_conditions.size());
+		else {
+			for(int i = 0; i < N_conditions; i++) {
+				std::stringstream condition(Utils::read_blob(conditions));
+				_stop_conditions[i]->read_state(condition);
+			}
+		}
+	}
+
+	// the random number generators are restored last, since initialising the other objects may have consumed random numbers
+	if(_state_sections.count("rng") > 0) {
+		std::stringstream rng(_state_sections["rng"]);
+		unsigned short rndseed[3];
+		rng.read((char *) rndseed, 3 * sizeof(unsigned short));
+		if(!rng.good()) throw oxDNAException("Malformed random number generator state in '%s'", _conf_filename.c_str());
+		seed48(rndseed);
+		if(_config_info->rng->is_philox()) _config_info->rng->read_state(rng);
+	}
+
+	_state_sections.clear();
+	OX_LOG(Logger::LOG_INFO, "Simulation restored from the state file '%s' at step %lld", _conf_filename.c_str(), _read_conf_step);
+}
+
 template<typename number>
 void SimBackend<number>::fix_diffusion() {
 	if(!_enable_fix_diffusion) return;
@@ -644,7 +1036,7 @@ void SimBackend<number>::fix_diffusion() {
 		// we try to normalize a few of them...
 		std::vector<int> apply;
 		for (int i = 0; i < _N_strands; i ++) 
-			if (drand48() < 0.005) apply.push_back(1);
+			if (_config_info->rng->uniform() < 0.005) apply.push_back(1);
 			else apply.push_back(0);
 
 		for (int i = 0; i < _N; i ++) {
@@ -16,6 +16,9 @@
 #include <fstream>
 #include <cfloat>
 #include <vector>
+#include <map>
+#include <string>
+#include <iostream>
 
 #include "../defs.h"
 
@@ -26,8 +29,12 @@ template <typename number> class BaseBox;
 template <typename number> class BaseList;
 template <typename number> class BaseParticle;
 template <typename number> class ObservableOutput;
+template <typename number> class StopCondition;
+template <typename number> class BaseObservable;
 template <typename number> class ConfigInfo;
 class Timer;
+class AsyncWriter;
+class CompressedTrajectoryReader;
 
 /**
  * @brief Defines the backend interface. It is an abstract class.
@@ -75,6 +82,45 @@ public:
 	 */
 	virtual void print_observables(llint curr_step) = 0;
 
+	/**
+	 * @brief Applies the stopping criteria attached to the backend.
+	 *
+	 * @param curr_step
+	 * @return true if the simulation should be stopped, false otherwise
+	 */
+	virtual bool check_stop_conditions(llint curr_step) = 0;
+
+	/**
+	 * @brief Prints the full state of the simulation, if it has to be printed at this step.
+	 *
+	 * @param curr_step
+	 * @param force if true the state is printed regardless of the step
+	 */
+	virtual void print_state(llint curr_step, bool force=false) = 0;
+
+	/**
+	 * @brief Returns the first step, larger than or equal to curr_step, at which print_observables, check_stop_conditions
+	 * or print_state may have something to do. The steps that come before it can be run by calling sim_step only.
+	 *
+	 * Conditions that are checked by sim_step itself (e.g. the order parameters of the FFS backends) are not events:
+	 * sim_step sets SimManager::stop, which is checked after each step.
+	 *
+	 * @param curr_step
+	 * @return the step, or -1 if there is nothing left to do
+	 */
+	virtual llint next_event_step(llint curr_step) = 0;
+
+	/**
+	 * @brief Restores the parts of the state that can only be restored after the backend has been initialised.
+	 * Does nothing if the simulation has not been restarted from a state file.
+	 */
+	virtual void restore_state() = 0;
+
+	/**
+	 * @brief Blocks until all the output generated so far has been written to disk.
+	 */
+	virtual void flush_output() = 0;
+
 	virtual void fix_diffusion() = 0;
 
 	virtual void print_equilibration_info() = 0;
@@ -99,6 +145,7 @@ restart_step_counter = <boolean> (false means that the step counter will start f
 
 [lastconf_file = <path> (path to the file where the last configuration will be dumped)]
 trajectory_file = <path> (path to the file which will contain the output trajectory of the simulation)
+[trajectory_format = text|compressed (format of the trajectory. Compressed trajectories are written by the compressed_configuration observable with its default settings: they are much smaller and faster to read, but positions and orientations are stored with a finite precision. Both formats are recognised automatically when they are read, e.g. by DNAnalysis. Defaults to text)]
 
 [binary_initial_conf = <bool> (whether the initial configuration is a binary configuration or not, defaults to false)]
 [lastconf_file_bin = <path> (path to the file where the last configuration will be printed in binary format, if not specified no binary configurations will be printed)]
@@ -118,6 +165,13 @@ trajectory_file = <path> (path to the file which will contain the output traject
 [checkpoint_trajectory = <string> (File name for the checkpoint trajectory. If not specified, only the last checkpoint will be printed)]
 [reload_from = <string> (checkpoint to reload from. This option is incompatible with the keys conf_file and seed, and requires restart_step_counter=0 as well as binary_initial_conf!=1)]
 
+[state_file = <string> (file the full state of the simulation is printed to. On top of the configuration and of the state of the random number generators, the state contains the state of the interaction (e.g. the patch locks), of the backend and of its moves (e.g. the step sizes adjusted during the equilibration) and of the observables and stop conditions. A simulation restarted from it continues exactly as if it had never been stopped, although the observables due at the step the state was printed at are printed again. The file is first written to <state_file>.tmp and then renamed, so that it is never left half-written)]
+[state_every = <int> (how often the state should be printed, in number of steps. If 0 it is printed only at the end of the simulation and when a stop condition with action = checkpoint is met. Defaults to 0)]
+[restart_from_state = <string> (state file to restart from. This option is incompatible with the keys conf_file, seed and reload_from, requires restart_step_counter=0 and skips the equilibration steps)]
+
+[async_output = <bool> (if true, the output files (trajectory, last configurations, data_output_<n> streams...) are written by a background thread, so that the simulation does not wait for the file system. The outputs are still computed at the right steps by the simulation thread, and the content of the files does not change. The queued output is written before the state is printed and at the end of the simulation, also when it is stopped by a signal. Defaults to false)]
+[async_output_buffer = <float> (maximum amount of output, in MB, that can wait to be written when async_output = true. If it is exceeded the simulation waits for the background thread. Defaults to 64)]
+
 @endverbatim
  */
 template<typename number>
@@ -157,11 +211,36 @@ protected:
 	bool _custom_conf_name;
 	char _custom_conf_str[256];
 	ifstream _conf_input;
+	/// used instead of _conf_input if the configuration file is a compressed trajectory
+	CompressedTrajectoryReader *_conf_reader;
+	/// the particle lines of the text configuration being read, separated by '\0's
+	std::string _conf_lines;
+	std::vector<size_t> _conf_line_offsets;
+	/// the positions (in double precision) and the other 12 values of each particle of the text configuration being read
+	std::vector<double> _conf_positions;
+	std::vector<number> _conf_values;
 	llint _read_conf_step;
+	/// offset of the configuration file at which the first configuration to be read starts
+	llint _first_conf_offset;
 	std::string _checkpoint_file;
 	std::string _checkpoint_traj;
 	bool _restart_step_counter;
 
+	std::string _state_file;
+	llint _state_every;
+	llint _last_state_step;
+	bool _restart_from_state;
+	/// used to print the configuration contained in the state files
+	BaseObservable<number> *_state_conf;
+	/// sections of the state file the simulation has been restarted from, indexed by name, that have not been restored yet
+	std::map<std::string, std::string> _state_sections;
+	/// last step at which the stop conditions have been checked, so that they are not checked twice after a restart
+	llint _last_stop_check_step;
+
+	bool _async_output;
+	double _async_output_buffer;
+	AsyncWriter *_async_writer;
+
 	/// Vector of ObservableOutput used to manage the simulation output
 	vector<ObservableOutput<number> *> _obs_outputs;
 	ObservableOutput<number> *_obs_output_stdout;
@@ -173,6 +252,9 @@ protected:
 	ObservableOutput<number> *_obs_output_checkpoints;
 	ObservableOutput<number> *_obs_output_last_checkpoint;
 
+	/// Vector of StopCondition used to decide whether the simulation should be stopped or checkpointed
+	vector<StopCondition<number> *> _stop_conditions;
+
 	/// Pointer to the interaction manager
 	IBaseInteraction<number> *_interaction;
 
@@ -231,6 +313,18 @@ protected:
 	 */
 	bool _read_next_configuration(bool binary=false);
 
+	/**
+	 * @brief Reads and parses the particle lines of a text configuration into _conf_positions and _conf_values.
+	 *
+	 * The lines are first read into a single buffer, and then parsed with strtod (strtof for single-precision values),
+	 * which give exactly the same values as the stream extraction operators but are much faster. If oxDNA has been
+	 * compiled with OpenMP support, large configurations are parsed in parallel. Lines that contain only whitespace are
+	 * skipped.
+	 *
+	 * @return the number of particle lines read, which is smaller than the number of particles only if the file ended
+	 */
+	int _read_text_particles();
+
 	int _get_N_from_conf(ifstream &conf_input);
 
 	/**
@@ -240,6 +334,25 @@ protected:
 	 */
 	virtual void _print_ready_observables(llint curr_step);
 
+	/**
+	 * @brief Reads the sections that follow the configuration in a state file into _state_sections.
+	 */
+	void _read_state_sections();
+
+	/**
+	 * @brief Writes the state of the backend. Backends with a state of their own (e.g. MC step sizes) should extend it.
+	 *
+	 * @param out
+	 */
+	virtual void _write_backend_state(std::ostream &out) {}
+
+	/**
+	 * @brief Restores the state written by _write_backend_state.
+	 *
+	 * @param in
+	 */
+	virtual void _read_backend_state(std::istream &in) {}
+
 public:
 	SimBackend();
 	virtual ~SimBackend();
@@ -251,6 +364,11 @@ public:
 	virtual void fix_diffusion();
 	virtual void print_equilibration_info();
 	virtual void print_observables(llint curr_step);
+	virtual bool check_stop_conditions(llint curr_step);
+	virtual void print_state(llint curr_step, bool force=false);
+	virtual llint next_event_step(llint curr_step);
+	virtual void restore_state();
+	virtual void flush_output();
 	virtual void print_conf(llint curr_step, bool reduced=false, bool only_last=false);
 };
 
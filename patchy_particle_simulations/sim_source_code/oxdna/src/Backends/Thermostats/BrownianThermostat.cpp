@@ -59,10 +59,10 @@ void BrownianThermostat<number>::apply (BaseParticle<number> **particles, llint
 
 	for(int i = 0; i < this->_N_part; i++) {
 		BaseParticle<number> *p = particles[i];
-		if(drand48() < _pt) {
+		if(RandomManager::instance()->uniform() < _pt) {
 			p->vel = LR_vector<number>(Utils::gaussian<number>(), Utils::gaussian<number>(), Utils::gaussian<number>()) * _rescale_factor;
 		}
-		if(drand48() < _pr) {
+		if(RandomManager::instance()->uniform() < _pr) {
 			p->L = LR_vector<number>(Utils::gaussian<number>(), Utils::gaussian<number>(), Utils::gaussian<number>()) * _rescale_factor;
 		}
 	}
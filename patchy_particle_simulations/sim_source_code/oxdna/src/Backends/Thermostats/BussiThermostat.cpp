@@ -120,15 +120,15 @@ number BussiThermostat<number>::_gamdev(int ia) {
 	if(ia < 6) {
 		x = 1.0;
 		for(j = 1; j <= ia; j++)
-			x *= drand48();
+			x *= RandomManager::instance()->uniform();
 		x = -log(x);
 	}
 	else {
 		do {
 			do {
 				do {
-					v1 = drand48();
-					v2 = 2.0 * drand48() - 1.0;
+					v1 = RandomManager::instance()->uniform();
+					v2 = 2.0 * RandomManager::instance()->uniform() - 1.0;
 				} while(SQR(v1) + SQR(v2) > 1.0);
 				y = v2 / v1;
 				am = ia - 1;
@@ -136,7 +136,7 @@ number BussiThermostat<number>::_gamdev(int ia) {
 				x = s * y + am;
 			} while(x <= 0.0);
 			e = (1.0 + SQR(y)) * exp(am * log(x / am) - s * y);
-		} while(drand48() > e);
+		} while(RandomManager::instance()->uniform() > e);
 	}
 	return x;
 }
@@ -77,9 +77,9 @@ void SRDThermostat<number>::init(int N_part) {
 
 		number rescale_factor = sqrt(_T/_m);
 		for(int i = 0; i < _N_particles; i++) {
-			_srd_particles[i].r.x = drand48() * L;
-			_srd_particles[i].r.y = drand48() * L;
-			_srd_particles[i].r.z = drand48() * L;
+			_srd_particles[i].r.x = RandomManager::instance()->uniform() * L;
+			_srd_particles[i].r.y = RandomManager::instance()->uniform() * L;
+			_srd_particles[i].r.z = RandomManager::instance()->uniform() * L;
 
 			_srd_particles[i].v.x = Utils::gaussian<number>() * rescale_factor;
 			_srd_particles[i].v.y = Utils::gaussian<number>() * rescale_factor;
@@ -1382,7 +1382,7 @@ void VMMC_CPUBackend<number>::sim_step(llint curr_step) {
 		//}
 
 		// seed particle;
-		int pi = (int) (drand48() * this->_N);
+		int pi = (int) (this->_config_info->rng->uniform() * this->_N);
 		BaseParticle<number> *p = this->_particles[pi];
 
 		// this gives a random number distributed ~ 1/x (x real)
@@ -1404,7 +1404,7 @@ void VMMC_CPUBackend<number>::sim_step(llint curr_step) {
 		//printf("generating move...\n");
 		movestr<number> move;
 		move.seed = pi;
-		move.type = (drand48() < 0.5) ? MC_MOVE_TRANSLATION : MC_MOVE_ROTATION;
+		move.type = (this->_config_info->rng->uniform() < 0.5) ? MC_MOVE_TRANSLATION : MC_MOVE_ROTATION;
 
 		//generate translation / rotataion
 		//LR_vector<number> translation;
@@ -1480,7 +1480,7 @@ void VMMC_CPUBackend<number>::sim_step(llint curr_step) {
 		this->_tries[_last_move] ++;
 
 		//printf("## U: %lf dU: %lf, p': %lf, nclust: %d \n", this->_U, this->_dU, pprime, nclust);
-		if (this->_overlap == false && pprime > drand48()) {
+		if (this->_overlap == false && pprime > this->_config_info->rng->uniform()) {
 			if (nclust <= _maxclust) this->_accepted[_last_move]++;
 			//if (!_reject_prelinks) this->_accepted[0]++;
 			this->_U += this->_dU;
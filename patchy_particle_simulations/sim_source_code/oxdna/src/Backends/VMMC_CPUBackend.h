@@ -12,6 +12,7 @@
 #include "../Utilities/Weights.h"
 #include "../Utilities/OrderParameters.h"
 #include "../Utilities/Histogram.h"
+#include "../Utilities/ConfigInfo.h"
 
 #define MAX(a,b) (((a)>(b))?(a):(b))
 #define MIN(a,b) (((a)>(b))?(b):(a))
@@ -130,7 +131,7 @@ protected:
 	number VMMC_link(double E_new, double E_old) { return (1. - exp((1. / this->_T) * (E_old - E_new)));}
 
 	//inline number _next_rand (void) const { return drand48(); }
-	inline number _next_rand () {return drand48();}
+	inline number _next_rand () {return this->_config_info->rng->uniform();}
 
 	inline void _move_particle(movestr<number> * moveptr, BaseParticle<number> *p, BaseParticle<number> *q);
 	//void _r_move_particle(movestr<number> * moveptr, BaseParticle<number> *p);
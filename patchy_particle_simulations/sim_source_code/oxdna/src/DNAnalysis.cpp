@@ -15,6 +15,7 @@
 #include "Utilities/SignalManager.h"
 #include "Utilities/oxDNAException.h"
 #include "Utilities/Timings.h"
+#include "Utilities/RandomManager.h"
 
 using namespace std;
 
@@ -28,6 +29,7 @@ int main(int argc, char *argv[]) {
 		Logger::init();
 		SignalManager::manage_segfault();
 		TimingManager::init();
+		RandomManager::init();
 
 		if(argc < 2) throw oxDNAException("Usage is '%s input_file'", argv[0]);
 		if(!strcmp(argv[1], "-v")) print_version();
@@ -51,6 +53,7 @@ int main(int argc, char *argv[]) {
 		OX_LOG(Logger::LOG_ERROR, "%s", e.error());
 	}
 
+	RandomManager::clear();
 	TimingManager::clear();
 	Logger::clear();
 
@@ -8,6 +8,7 @@
 
 #include <map>
 #include <cfloat>
+#include <cstring>
 #include <fstream>
 #include <set>
 #include <vector>
@@ -22,6 +23,10 @@
 
 #include "../Lists/Cells.h"
 
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 /**
@@ -39,6 +44,16 @@ protected:
 	/// This is useful for "hard" potentials
 	bool _is_infinite;
 
+#ifdef HAVE_OPENMP
+	/// one cache line per flag, so that threads setting their own flag do not slow each other down
+	struct _ThreadFlag {
+		bool value;
+		char padding[63];
+	};
+	/// copies of _is_infinite used by get_is_infinite and set_is_infinite when they are called from within a parallel region
+	std::vector<_ThreadFlag> _thread_is_infinite;
+#endif
+
 	/// This are needed to create initial configurations, and they are used by the generator functions
 	number _energy_threshold, _temperature;
 	/// If true, the generation of the initial configuration will try to take into account the fact that particles that are bonded neighbours should be close to each other
@@ -174,17 +189,77 @@ public:
 	 */
 	virtual map<int, number> get_system_energy_split(BaseParticle<number> **particles, int N, BaseList<number> *lists) = 0;
 
+	/**
+	 * @brief Returns the size (in bytes) of the interaction-dependent state that goes together with a configuration
+	 * but is not stored in positions and orientations (e.g. which patch is locked to which). The default is 0.
+	 *
+	 * Backends that move configurations around (e.g. parallel tempering) use this method, {\@link write_state}
+	 * and {\@link read_state} to carry this state along.
+	 *
+	 * @param N number of particles
+	 * @return size of the buffer required by write_state and read_state
+	 */
+	virtual size_t get_state_size(int N) { return 0; }
+
+	/**
+	 * @brief Serializes the interaction-dependent state into buffer, which must be at least get_state_size(N) bytes long.
+	 *
+	 * @param particles
+	 * @param N
+	 * @param buffer
+	 */
+	virtual void write_state(BaseParticle<number> **particles, int N, char *buffer) {}
+
+	/**
+	 * @brief Restores the interaction-dependent state from a buffer filled by {\@link write_state}.
+	 *
+	 * @param particles
+	 * @param N
+	 * @param buffer
+	 */
+	virtual void read_state(BaseParticle<number> **particles, int N, const char *buffer) {}
+
 	/**
 	 * @brief Returns the state of the interaction
+	 *
+	 * When called from within an OpenMP parallel region, it returns the state seen by the calling thread.
 	 */
-	bool get_is_infinite () { return _is_infinite; }
+	bool get_is_infinite () {
+#ifdef HAVE_OPENMP
+		if(omp_in_parallel()) return _thread_is_infinite[omp_get_thread_num()].value;
+#endif
+		return _is_infinite;
+	}
 
 	/**
 	 * @brief Sets _is_infinite
 	 *
+	 * When called from within an OpenMP parallel region, it sets the state seen by the calling thread only.
+	 *
 	 * @param arg bool
 	 */
-	void set_is_infinite (bool arg) { _is_infinite = arg; }
+	void set_is_infinite (bool arg) {
+#ifdef HAVE_OPENMP
+		if(omp_in_parallel()) {
+			_thread_is_infinite[omp_get_thread_num()].value = arg;
+			return;
+		}
+#endif
+		_is_infinite = arg;
+	}
+
+#ifdef HAVE_OPENMP
+	/**
+	 * @brief Makes room for the per-thread copies of _is_infinite. It must be called before the interaction is used by more than one thread.
+	 *
+	 * @param N_threads the maximum number of threads that will use the interaction at the same time
+	 */
+	void set_N_threads(int N_threads) {
+		_ThreadFlag flag;
+		memset(&flag, 0, sizeof(flag));
+		_thread_is_infinite.assign(N_threads, flag);
+	}
+#endif
 
 	/**
 	 * @brief overlap criterion. Used only in the generation of configurations. Can be overloaded.
@@ -267,13 +342,19 @@ template<typename number>
 number IBaseInteraction<number>::get_system_energy(BaseParticle<number> **particles, int N, BaseList<number> *lists) {
 	double energy = 0.;
 
-	vector<ParticlePair<number> > pairs = lists->get_potential_interactions();
-	typename std::vector<ParticlePair<number> >::iterator it;
-	for(it = pairs.begin(); it != pairs.end(); it++ ) {
-		BaseParticle<number> *p = (*it).first;
-		BaseParticle<number> *q = (*it).second;
-		energy += (double) pair_interaction(p, q);
-		if(this->get_is_infinite()) return energy;
+	// we don't build the whole list of pairs: the neighbours of each particle are stored in the same vector, one particle at a time
+	vector<BaseParticle<number> *> neighs;
+	for(int i = 0; i < N; i++) {
+		BaseParticle<number> *p = particles[i];
+		lists->fill_all_neighbours(p, neighs);
+
+		for(unsigned int n = 0; n < neighs.size(); n++) {
+			BaseParticle<number> *q = neighs[n];
+			if(p->index > q->index) {
+				energy += (double) pair_interaction(p, q);
+				if(this->get_is_infinite()) return energy;
+			}
+		}
 	}
 
 	return (number) energy;
@@ -283,9 +364,10 @@ template<typename number>
 number IBaseInteraction<number>::get_system_energy_term(int name, BaseParticle<number> **particles, int N, BaseList<number> *lists) {
 	number energy = (number) 0.f;
 
+	vector<BaseParticle<number> *> neighs;
 	for (int i = 0; i < N; i ++) {
 		BaseParticle<number> *p = particles[i];
-		vector<BaseParticle<number> *> neighs = lists->get_all_neighbours(p);
+		lists->fill_all_neighbours(p, neighs);
 
 		for(unsigned int n = 0; n < neighs.size(); n++) {
 			BaseParticle<number> *q = neighs[n];
@@ -540,9 +622,10 @@ map<int, number> BaseInteraction<number, child>::get_system_energy_split(BasePar
 		energy_map[name] = (number) 0.f;
 	}
 
+	vector<BaseParticle<number> *> neighs;
 	for (int i = 0; i < N; i ++) {
 		BaseParticle<number> *p = particles[i];
-		vector<BaseParticle<number> *> neighs = lists->get_all_neighbours(p);
+		lists->fill_all_neighbours(p, neighs);
 
 		for(unsigned int n = 0; n < neighs.size(); n++) {
 			BaseParticle<number> *q = neighs[n];
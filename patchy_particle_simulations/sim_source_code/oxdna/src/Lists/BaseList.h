@@ -11,6 +11,7 @@
 #include <vector>
 #include <utility>
 #include <set>
+#include <algorithm>
 
 #include "../defs.h"
 #include "../Utilities/Timings.h"
@@ -47,6 +48,7 @@ public:
 		if(strncmp("MD", sim_type, 512) == 0) _is_MC = false;
 		else if(strncmp("MC", sim_type, 512) == 0) _is_MC = true;
 		else if(strncmp("MC2", sim_type, 512) == 0) _is_MC = true;
+		else if(strncmp("PT_MC2", sim_type, 512) == 0) _is_MC = true;
 		else if(strncmp("VMMC", sim_type, 512) == 0) _is_MC = true;
 	        else if(strncmp("PT_VMMC", sim_type, 512) == 0) _is_MC = true;
 		else if(strncmp("FFS_MD", sim_type, 512) == 0) _is_MC = false;
@@ -92,6 +94,38 @@ public:
 	 */
 	virtual std::vector<BaseParticle<number> *> get_complete_neigh_list(BaseParticle<number> *p) = 0;
 
+	/**
+	 * @brief Same as get_neigh_list, but the neighbours are stored in the given vector rather than in a newly allocated one.
+	 *
+	 * The vector is cleared before being filled. Callers that keep the vector around (e.g. as a class member) can query
+	 * neighbours in tight loops without hitting the allocator, since the vector's capacity is retained between calls.
+	 * The default implementation falls back on get_neigh_list.
+	 *
+	 * @param p particle
+	 * @param neighs vector that will contain the neighbours of p
+	 */
+	virtual void fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+		neighs = get_neigh_list(p);
+	}
+
+	/**
+	 * @brief Same as get_complete_neigh_list, but the neighbours are stored in the given vector (see fill_neigh_list).
+	 *
+	 * @param p particle
+	 * @param neighs vector that will contain the neighbours of p
+	 */
+	virtual void fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+		neighs = get_complete_neigh_list(p);
+	}
+
+	/**
+	 * @brief Same as get_all_neighbours, but the neighbours are stored in the given vector (see fill_neigh_list).
+	 *
+	 * @param p particle
+	 * @param neighs vector that will contain the neighbours of p
+	 */
+	virtual void fill_all_neighbours(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
+
 	/**
 	 * @brief Returns a list of potentially interaction neighbours of particle p. It does contain also bonded neighbours.
 	 *
@@ -118,28 +152,35 @@ public:
 
 template<typename number>
 std::vector<BaseParticle<number> *> BaseList<number>::get_all_neighbours(BaseParticle<number> *p) {
-//	std::vector<BaseParticle<number> *> neighs = std::move(get_complete_neigh_list(p));
-	std::vector<BaseParticle<number> *> neighs = get_complete_neigh_list(p);
+	std::vector<BaseParticle<number> *> neighs;
+	fill_all_neighbours(p, neighs);
+	return neighs;
+}
+
+template<typename number>
+void BaseList<number>::fill_all_neighbours(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	fill_complete_neigh_list(p, neighs);
 
-	std::set<BaseParticle<number> *> bonded_neighs;
+	// bonded neighbours are few, so a linear search is cheaper than building a std::set
+	typename std::vector<BaseParticle<number> *>::size_type n_unbonded = neighs.size();
 	typename std::vector<ParticlePair<number> >::iterator it = p->affected.begin();
 	for(; it != p->affected.end(); it++) {
-		if(it->first != p) bonded_neighs.insert(it->first);
-		if(it->second != p) bonded_neighs.insert(it->second);
+		BaseParticle<number> *others[2] = { it->first, it->second };
+		for(int i = 0; i < 2; i++) {
+			BaseParticle<number> *q = others[i];
+			if(q != p && std::find(neighs.begin() + n_unbonded, neighs.end(), q) == neighs.end()) neighs.push_back(q);
+		}
 	}
-
-	neighs.insert(neighs.end(), bonded_neighs.begin(), bonded_neighs.end());
-	return neighs;
 }
 
 template<typename number>
 std::vector<ParticlePair<number> > BaseList<number>::get_potential_interactions() {
 	std::vector<ParticlePair<number> > list;
+	std::vector<BaseParticle<number> *> neighs;
 
 	for(int i = 0; i < _N; i++) {
 		BaseParticle<number> *p = _particles[i];
-//		std::vector<BaseParticle<number> *> neighs = std::move(get_all_neighbours(p));
-		std::vector<BaseParticle<number> *> neighs = get_all_neighbours(p);
+		fill_all_neighbours(p, neighs);
 		typename std::vector<BaseParticle<number> *>::iterator it = neighs.begin();
 		for(; it != neighs.end(); it++) {
 			BaseParticle<number> *q = *it;
@@ -90,11 +90,10 @@ void BinVerletList<number>::global_update(bool force_update) {
 
 	for(int i = 0; i < this->_N; i++) {
 		BaseParticle<number> *p = this->_particles[i];
-		if(p->type == 0 || !_is_AO) _lists[p->index] = _cells[2*p->type]->get_neigh_list(p);
+		if(p->type == 0 || !_is_AO) _cells[2*p->type]->fill_neigh_list(p, _lists[p->index]);
 		else _lists[p->index].clear();
-		vector<BaseParticle<number> *> l2 = _cells[1]->get_neigh_list(p);
-		_lists[p->index].reserve(_lists[p->index].size() + l2.size());
-		_lists[p->index].insert(_lists[p->index].end(), l2.begin(), l2.end());
+		_cells[1]->fill_neigh_list(p, _scratch);
+		_lists[p->index].insert(_lists[p->index].end(), _scratch.begin(), _scratch.end());
 
 		_list_poss[p->index] = p->pos;
 	}
@@ -108,13 +107,22 @@ std::vector<BaseParticle<number> *> BinVerletList<number>::get_neigh_list(BasePa
 
 template<typename number>
 std::vector<BaseParticle<number> *> BinVerletList<number>::get_complete_neigh_list(BaseParticle<number> *p) {
-	vector<BaseParticle<number> *> l1 = _cells[2*p->type]->get_complete_neigh_list(p);
-	vector<BaseParticle<number> *> l2 = _cells[1]->get_complete_neigh_list(p);
-
-	l1.reserve(l1.size() + l2.size());
-	l1.insert(l1.end(), l2.begin(), l2.end());
+	vector<BaseParticle<number> *> l1;
+	fill_complete_neigh_list(p, l1);
 	return l1;
 }
 
+template<typename number>
+void BinVerletList<number>::fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	neighs = _lists[p->index];
+}
+
+template<typename number>
+void BinVerletList<number>::fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_cells[2*p->type]->fill_complete_neigh_list(p, neighs);
+	_cells[1]->fill_complete_neigh_list(p, _scratch);
+	neighs.insert(neighs.end(), _scratch.begin(), _scratch.end());
+}
+
 template class BinVerletList<float>;
 template class BinVerletList<double>;
@@ -31,6 +31,8 @@ protected:
 	number _sqr_rcut[3];
 	// this has to be a vector of pointers because Cells is not copy-constructible
 	std::vector<Cells<number> *> _cells;
+	/// used to merge the lists of two different Cells objects without allocating memory every time
+	std::vector<BaseParticle<number> *> _scratch;
 
 public:
 	BinVerletList(int &N, BaseBox<number> *box);
@@ -44,6 +46,8 @@ public:
 	virtual void global_update(bool force_update = false);
 	virtual std::vector<BaseParticle<number> *> get_neigh_list(BaseParticle<number> *p);
 	virtual std::vector<BaseParticle<number> *> get_complete_neigh_list(BaseParticle<number> *p);
+	virtual void fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
+	virtual void fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
 };
 
 #endif /* BINVERLETLIST_H_ */
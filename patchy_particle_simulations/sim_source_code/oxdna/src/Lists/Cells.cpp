@@ -9,6 +9,9 @@
 
 #include "../Utilities/ConfigInfo.h"
 
+#include <limits>
+#include <algorithm>
+
 template<typename number>
 Cells<number>::Cells(int &N, BaseBox<number> *box) : BaseList<number>(N, box) {
 	_heads = NULL;
@@ -23,6 +26,7 @@ Cells<number>::Cells(int &N, BaseBox<number> *box) : BaseList<number>(N, box) {
 	_lees_edwards = false;
 	_shear_rate = 0.;
 	_dt = 0.;
+	_rebuilds = TimingManager::instance()->get_counter("Cell list rebuilds");
 }
 
 template<typename number>
@@ -176,6 +180,7 @@ void Cells<number>::single_update(BaseParticle<number> *p) {
 
 template<typename number>
 void Cells<number>::global_update(bool force_update) {
+	_rebuilds->add();
 	this->_box_sides = this->_box->box_sides();
 	_set_N_cells_side_from_box(_N_cells_side, this->_box);
 	_N_cells = _N_cells_side[0]*_N_cells_side[1]*_N_cells_side[2];
@@ -206,8 +211,8 @@ void Cells<number>::global_update(bool force_update) {
 }
 
 template<typename number>
-std::vector<BaseParticle<number> *> Cells<number>::_get_neigh_list(BaseParticle<number> *p, bool all) {
-	std::vector<BaseParticle<number> *> res;
+void Cells<number>::_fill_neigh_list(BaseParticle<number> *p, bool all, number sqr_cutoff, std::vector<BaseParticle<number> *> &res) {
+	res.clear();
 
 	int cind = _cells[p->index];
 	int ind[3] = {
@@ -257,7 +262,7 @@ std::vector<BaseParticle<number> *> Cells<number>::_get_neigh_list(BaseParticle<
 					// if this is an MC simulation or all == true we need full lists, otherwise the i-th particle will have neighbours with index > i
 					bool include_q = (p != q) && (all || ((p->index > q->index || this->_is_MC)));
 					include_q = include_q && (!_unlike_type_only || p->type != q->type);
-					if(include_q && !p->is_bonded(q) && this->_box->sqr_min_image_distance(p->pos, q->pos) < _sqr_rcut) {
+					if(include_q && !p->is_bonded(q) && this->_box->sqr_min_image_distance(p->pos, q->pos) < sqr_cutoff) {
 						res.push_back(q);
 					}
 
@@ -266,18 +271,67 @@ std::vector<BaseParticle<number> *> Cells<number>::_get_neigh_list(BaseParticle<
 			}
 		}
 	}
-
-	return res;
 }
 
 template<typename number>
 std::vector<BaseParticle<number> *> Cells<number>::get_neigh_list(BaseParticle<number> *p) {
-	return _get_neigh_list(p, false);
+	std::vector<BaseParticle<number> *> res;
+	_fill_neigh_list(p, false, _sqr_rcut, res);
+	return res;
 }
 
 template<typename number>
 std::vector<BaseParticle<number> *> Cells<number>::get_complete_neigh_list(BaseParticle<number> *p) {
-	return _get_neigh_list(p, true);
+	std::vector<BaseParticle<number> *> res;
+	_fill_neigh_list(p, true, _sqr_rcut, res);
+	return res;
+}
+
+template<typename number>
+void Cells<number>::fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_fill_neigh_list(p, false, _sqr_rcut, neighs);
+}
+
+template<typename number>
+void Cells<number>::fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_fill_neigh_list(p, true, _sqr_rcut, neighs);
+}
+
+template<typename number>
+void Cells<number>::fill_cell_neighbours(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs, int layers) {
+	if(layers == 1) {
+		_fill_neigh_list(p, true, std::numeric_limits<number>::max(), neighs);
+		return;
+	}
+
+	neighs.clear();
+	int cind = _cells[p->index];
+	int ind[3] = {
+		cind % _N_cells_side[0],
+		(cind / _N_cells_side[0]) % _N_cells_side[1],
+		cind / (_N_cells_side[0]*_N_cells_side[1])
+	};
+	// each cell is visited only once, even if the layers wrap around the box
+	int N_visited[3];
+	for(int d = 0; d < 3; d++) N_visited[d] = std::min(2*layers + 1, _N_cells_side[d]);
+
+	int loop_ind[3];
+	for(int k = 0; k < N_visited[2]; k++) {
+		loop_ind[2] = (ind[2] - layers + k + layers*_N_cells_side[2]) % _N_cells_side[2];
+		for(int j = 0; j < N_visited[1]; j++) {
+			loop_ind[1] = (ind[1] - layers + j + layers*_N_cells_side[1]) % _N_cells_side[1];
+			for(int i = 0; i < N_visited[0]; i++) {
+				loop_ind[0] = (ind[0] - layers + i + layers*_N_cells_side[0]) % _N_cells_side[0];
+				int loop_index = loop_ind[0] + _N_cells_side[0]*(loop_ind[1] + loop_ind[2]*_N_cells_side[1]);
+
+				BaseParticle<number> *q = _heads[loop_index];
+				while(q != P_VIRTUAL) {
+					if(p != q && !p->is_bonded(q)) neighs.push_back(q);
+					q = _next[q->index];
+				}
+			}
+		}
+	}
 }
 
 template class Cells<float>;
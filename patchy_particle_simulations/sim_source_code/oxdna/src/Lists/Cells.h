@@ -9,6 +9,7 @@
 #define CELLS_H_
 
 #include "BaseList.h"
+#include "../Utilities/Timings.h"
 #include <cfloat>
 
 /**
@@ -32,9 +33,10 @@ protected:
 	bool _lees_edwards;
 	number _shear_rate;
 	number _dt;
+	Counter *_rebuilds;
 
 	void _set_N_cells_side_from_box(int N_cells_side[3], BaseBox<number> *box);
-	std::vector<BaseParticle<number> *> _get_neigh_list(BaseParticle<number> *p, bool all);
+	void _fill_neigh_list(BaseParticle<number> *p, bool all, number sqr_cutoff, std::vector<BaseParticle<number> *> &res);
 public:
 	Cells(int &N, BaseBox<number> *box);
 	virtual ~Cells();
@@ -47,11 +49,24 @@ public:
 	virtual void global_update(bool force_update=false);
 	virtual std::vector<BaseParticle<number> *> get_neigh_list(BaseParticle<number> *p);
 	virtual std::vector<BaseParticle<number> *> get_complete_neigh_list(BaseParticle<number> *p);
+	virtual void fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
+	virtual void fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
+	/**
+	 * @brief Fills neighs with all the non-bonded particles in the cells that are at most layers cells away from p's cell
+	 * along each direction, regardless of their distance from p. Lees-Edwards conditions are taken into account only if
+	 * layers = 1.
+	 *
+	 * @param p
+	 * @param neighs
+	 * @param layers
+	 */
+	void fill_cell_neighbours(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs, int layers=1);
 
 	virtual void set_allowed_type(int type) { _allowed_type = type; }
 	virtual void set_unlike_type_only() { _unlike_type_only = true; }
 
 	virtual int get_N_cells() { return _N_cells; }
+	int get_N_cells_side(int dim) { return _N_cells_side[dim]; }
 	inline int get_cell_index(const LR_vector<number> &pos);
 };
 
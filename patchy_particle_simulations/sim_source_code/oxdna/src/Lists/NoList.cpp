@@ -35,8 +35,8 @@ void NoList<number>::global_update(bool force_update) {
 }
 
 template<typename number>
-std::vector<BaseParticle<number> *> NoList<number>::_get_neigh_list(BaseParticle<number> *p, bool all) {
-	std::vector<BaseParticle<number> *> res;
+void NoList<number>::_fill_neigh_list(BaseParticle<number> *p, bool all, std::vector<BaseParticle<number> *> &res) {
+	res.clear();
 
 	int last = (all) ? this->_N : p->index;
 
@@ -44,18 +44,30 @@ std::vector<BaseParticle<number> *> NoList<number>::_get_neigh_list(BaseParticle
 		BaseParticle<number> *q = this->_particles[i];
 		if(p != q && !p->is_bonded(q)) res.push_back(this->_particles[i]);
 	}
-
-	return res;
 }
 
 template<typename number>
 std::vector<BaseParticle<number> *> NoList<number>::get_neigh_list(BaseParticle<number> *p) {
-	return _get_neigh_list(p, this->_is_MC);
+	std::vector<BaseParticle<number> *> res;
+	_fill_neigh_list(p, this->_is_MC, res);
+	return res;
 }
 
 template<typename number>
 std::vector<BaseParticle<number> *> NoList<number>::get_complete_neigh_list(BaseParticle<number> *p) {
-	return _get_neigh_list(p, true);
+	std::vector<BaseParticle<number> *> res;
+	_fill_neigh_list(p, true, res);
+	return res;
+}
+
+template<typename number>
+void NoList<number>::fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_fill_neigh_list(p, this->_is_MC, neighs);
+}
+
+template<typename number>
+void NoList<number>::fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_fill_neigh_list(p, true, neighs);
 }
 
 template class NoList<float>;
@@ -18,7 +18,7 @@ class NoList: public BaseList<number> {
 protected:
 	std::vector<BaseParticle<number> *> _all_particles;
 
-	std::vector<BaseParticle<number> *> _get_neigh_list(BaseParticle<number> *p, bool all);
+	void _fill_neigh_list(BaseParticle<number> *p, bool all, std::vector<BaseParticle<number> *> &res);
 public:
 	NoList(int &N, BaseBox<number> *box);
 	virtual ~NoList();
@@ -30,6 +30,8 @@ public:
 	virtual void global_update(bool force_update=false);
 	virtual std::vector<BaseParticle<number> *> get_neigh_list(BaseParticle<number> *p);
 	virtual std::vector<BaseParticle<number> *> get_complete_neigh_list(BaseParticle<number> *p);
+	virtual void fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
+	virtual void fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
 };
 
 #endif /* NOLIST_H_ */
@@ -170,8 +170,8 @@ void RodCells<number>::global_update(bool force_update) {
 }
 
 template<typename number>
-std::vector<BaseParticle<number> *> RodCells<number>::_get_neigh_list(BaseParticle<number> *p, bool all) {
-	std::vector<BaseParticle<number> *> res;
+void RodCells<number>::_fill_neigh_list(BaseParticle<number> *p, bool all, std::vector<BaseParticle<number> *> &res) {
+	res.clear();
 
 	int want_type = -1;
 	if (_restrict_to_type >= 0) {
@@ -284,8 +284,6 @@ std::vector<BaseParticle<number> *> RodCells<number>::_get_neigh_list(BasePartic
 		}
 	}
 	*/
-
-	return res;
 }
 
 template<typename number>
@@ -335,12 +333,26 @@ std::vector<BaseParticle<number> *> RodCells<number>::whos_there(int idx) {
 
 template<typename number>
 std::vector<BaseParticle<number> *> RodCells<number>::get_neigh_list(BaseParticle<number> *p) {
-	return _get_neigh_list(p, false);
+	std::vector<BaseParticle<number> *> res;
+	_fill_neigh_list(p, false, res);
+	return res;
 }
 
 template<typename number>
 std::vector<BaseParticle<number> *> RodCells<number>::get_complete_neigh_list(BaseParticle<number> *p) {
-	return _get_neigh_list(p, true);
+	std::vector<BaseParticle<number> *> res;
+	_fill_neigh_list(p, true, res);
+	return res;
+}
+
+template<typename number>
+void RodCells<number>::fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_fill_neigh_list(p, false, neighs);
+}
+
+template<typename number>
+void RodCells<number>::fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_fill_neigh_list(p, true, neighs);
 }
 
 template class RodCells<float>;
@@ -47,7 +47,7 @@ protected:
 	std::vector<bool> _added;
 
 	void _set_N_cells_side_from_box(int N_cells_side[3], BaseBox<number> *box);
-	std::vector<BaseParticle<number> *> _get_neigh_list(BaseParticle<number> *p, bool all);
+	void _fill_neigh_list(BaseParticle<number> *p, bool all, std::vector<BaseParticle<number> *> &res);
 public:
 	RodCells(int &N, BaseBox<number> *box);
 	virtual ~RodCells();
@@ -60,6 +60,8 @@ public:
 	virtual void global_update(bool force_update=false);
 	virtual std::vector<BaseParticle<number> *> get_neigh_list(BaseParticle<number> *p);
 	virtual std::vector<BaseParticle<number> *> get_complete_neigh_list(BaseParticle<number> *p);
+	virtual void fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
+	virtual void fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
 
 	std::vector<BaseParticle<number> * > whos_there(int idx);
 	
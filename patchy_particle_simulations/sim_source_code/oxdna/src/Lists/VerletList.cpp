@@ -9,7 +9,7 @@
 
 template<typename number>
 VerletList<number>::VerletList(int &N, BaseBox<number> *box) : BaseList<number>(N, box), _updated(false), _cells(N, box) {
-
+	_rebuilds = TimingManager::instance()->get_counter("Verlet list rebuilds");
 }
 
 template<typename number>
@@ -59,11 +59,12 @@ void VerletList<number>::single_update(BaseParticle<number> *p) {
 
 template<typename number>
 void VerletList<number>::global_update(bool force_update) {
+	_rebuilds->add();
 	if(!_cells.is_updated() || force_update) _cells.global_update();
 
 	for(int i = 0; i < this->_N; i++) {
 		BaseParticle<number> *p = this->_particles[i];
-		_lists[p->index] = _cells.get_neigh_list(p);
+		_cells.fill_neigh_list(p, _lists[p->index]);
 		_list_poss[p->index] = p->pos;
 	}
 	_updated = true;
@@ -79,6 +80,16 @@ std::vector<BaseParticle<number> *> VerletList<number>::get_complete_neigh_list(
 	return _cells.get_complete_neigh_list(p);
 }
 
+template<typename number>
+void VerletList<number>::fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	neighs = _lists[p->index];
+}
+
+template<typename number>
+void VerletList<number>::fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs) {
+	_cells.fill_complete_neigh_list(p, neighs);
+}
+
 template<typename number>
 void VerletList<number>::change_box () {
 	LR_vector<number> new_box_sides = this->_box->box_sides();
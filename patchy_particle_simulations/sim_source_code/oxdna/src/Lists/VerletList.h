@@ -26,6 +26,7 @@ protected:
 	number _sqr_skin;
 	bool _updated;
 	number _sqr_rcut;
+	Counter *_rebuilds;
 
 	Cells<number> _cells;
 
@@ -41,6 +42,8 @@ public:
 	virtual void global_update(bool force_update = false);
 	virtual std::vector<BaseParticle<number> *> get_neigh_list(BaseParticle<number> *p);
 	virtual std::vector<BaseParticle<number> *> get_complete_neigh_list(BaseParticle<number> *p);
+	virtual void fill_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
+	virtual void fill_complete_neigh_list(BaseParticle<number> *p, std::vector<BaseParticle<number> *> &neighs);
 	virtual void change_box();
 };
 
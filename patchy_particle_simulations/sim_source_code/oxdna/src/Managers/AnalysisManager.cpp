@@ -5,11 +5,21 @@
  *      Author: rovigatti
  */
 
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <csignal>
+#include <exception>
+#include <unistd.h>
+#include <sys/wait.h>
+
 #include "AnalysisManager.h"
 
 #include "../Utilities/oxDNAException.h"
+#include "../Utilities/RandomManager.h"
 
-AnalysisManager::AnalysisManager(int argc, char *argv[]) {
+AnalysisManager::AnalysisManager(int argc, char *argv[]) : _N_workers(1), _N_confs(0) {
 	loadInputFile(&_input, argv[1]);
 	if(_input.state == ERROR) throw oxDNAException("Caught an error while opening the input file");
 	argc -= 2;
@@ -20,11 +30,12 @@ AnalysisManager::AnalysisManager(int argc, char *argv[]) {
 
 AnalysisManager::~AnalysisManager() {
 	cleanInputFile(&_input);
-	delete _backend;
+	if(_backend != NULL) delete _backend;
 }
 
 void AnalysisManager::load_options() {
 	Logger::instance()->get_settings(_input);
+	RandomManager::instance()->get_settings(_input);
 
 	// seed;
 	int seed;
@@ -42,15 +53,95 @@ void AnalysisManager::load_options() {
 		}
 	}
 	OX_LOG(Logger::LOG_INFO, "Setting the random number generator with seed = %d", seed);
-	srand48((long int)seed);
+	RandomManager::instance()->seed((long int)seed);
 
 	_backend->get_settings(_input);
+
+	getInputInt(&_input, "analysis_workers", &_N_workers, 0);
+	if(_N_workers < 1) throw oxDNAException("analysis_workers should be larger than 0");
 }
 
 void AnalysisManager::init() {
-	_backend->init();
+	if(_N_workers > 1) {
+		_backend->check_ranges_allowed();
+		_N_confs = _backend->index_trajectory();
+		if(_N_workers > _N_confs) _N_workers = _N_confs;
+		OX_LOG(Logger::LOG_INFO, "Analysing %d configuration(s) with %d worker(s)", _N_confs, _N_workers);
+	}
+	// the workers initialise their own copies of the backend
+	if(_N_workers == 1) _backend->init();
 }
 
 void AnalysisManager::analysis() {
-	while(!_backend->done()) _backend->analyse();
+	if(_N_workers > 1) _parallel_analysis();
+	else while(!_backend->done()) _backend->analyse();
+}
+
+void AnalysisManager::_parallel_analysis() {
+	std::vector<pid_t> pids;
+	int first = 0;
+	for(int w = 0; w < _N_workers; w++) {
+		int N = _N_confs / _N_workers + ((w < _N_confs % _N_workers) ? 1 : 0);
+
+		// otherwise whatever is still buffered would be printed by each worker
+		fflush(NULL);
+		std::cout.flush();
+		pid_t pid = fork();
+		if(pid == -1) {
+			for(unsigned int i = 0; i < pids.size(); i++) kill(pids[i], SIGTERM);
+			throw oxDNAException("Cannot start analysis worker %d", w);
+		}
+		if(pid == 0) _run_worker(first, N, w);
+
+		pids.push_back(pid);
+		first += N;
+	}
+
+	int N_failed = 0;
+	for(int w = 0; w < _N_workers; w++) {
+		int status;
+		// waitpid is restarted only if it has been interrupted by a signal
+		while(waitpid(pids[w], &status, 0) == -1) {
+			if(errno != EINTR) {
+				int error = errno;
+				for(int i = w; i < _N_workers; i++) kill(pids[i], SIGTERM);
+				throw oxDNAException("Cannot wait for analysis worker %d: %s", w, strerror(error));
+			}
+		}
+		if(!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			OX_LOG(Logger::LOG_WARNING, "Analysis worker %d failed", w);
+			N_failed++;
+		}
+	}
+	if(N_failed > 0) throw oxDNAException("%d analysis worker(s) failed, their outputs have been left in the part files", N_failed);
+
+	_backend->merge_parts(_N_workers);
+}
+
+void AnalysisManager::_run_worker(int first, int N, int part) {
+	int status = 0;
+	try {
+		_backend->set_range(first, N, part);
+		_backend->init();
+		while(!_backend->done()) _backend->analyse();
+		// closes the part files
+		delete _backend;
+		_backend = NULL;
+	}
+	catch(oxDNAException &e) {
+		OX_LOG(Logger::LOG_ERROR, "Analysis worker %d: %s", part, e.error());
+		status = 1;
+	}
+	catch(std::exception &e) {
+		OX_LOG(Logger::LOG_ERROR, "Analysis worker %d: %s", part, e.what());
+		status = 1;
+	}
+	catch(...) {
+		OX_LOG(Logger::LOG_ERROR, "Analysis worker %d: caught an unexpected exception", part);
+		status = 1;
+	}
+
+	fflush(NULL);
+	std::cout.flush();
+	_exit(status);
 }
@@ -16,11 +16,27 @@
  *
  * This very basic class runs the analysis. It internally uses an instance of AnalysisBackend
  * to perform all the necessary analysis on the input trajectory.
+ *
+ * If analysis_workers is larger than 1, the trajectory is indexed and its configurations are split into as many
+ * contiguous ranges, which are analysed at the same time by separate processes, each with its own particles, box and
+ * lists. Each worker writes the output of its range to part files ('\<name\>.\<n\>.part\<worker\>'), which are
+ * merged in order once all the workers are done, so that the outputs are the same as those of a serial analysis.
+ * This holds for the observables whose output depends on the current configuration only: the analysis is refused if
+ * any of the observables accumulates data over the trajectory (e.g. averages or histograms, see
+ * BaseObservable::is_cumulative), since each worker would only see its own range. Text and compressed trajectories are
+ * supported, binary ones are not. If a worker fails, for whatever reason, it exits with a non-zero status and the part
+ * files are left on disk.
  */
 class AnalysisManager {
 protected:
 	input_file _input;
 	AnalysisBackend *_backend;
+	int _N_workers;
+	int _N_confs;
+
+	void _parallel_analysis();
+	/// analyses the given range in the current (forked) process and exits
+	void _run_worker(int first, int N, int part);
 
 public:
 	AnalysisManager(int argc, char *argv[]);
@@ -0,0 +1,416 @@
+/*
+ * BatchManager.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <csignal>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <set>
+
+#include "BatchManager.h"
+#include "SimManager.h"
+#include "../Utilities/Utils.h"
+#include "../Utilities/oxDNAException.h"
+
+volatile bool BatchManager::_stop = false;
+
+BatchManager::BatchManager(int argc, char *argv[]) {
+	_N_workers = -1;
+	_preload_plugins = true;
+	_summary_name = std::string("batch_summary.dat");
+	_manifest = std::string(argv[1]);
+
+	argc -= 2;
+	if(argc > 0) addCommandLineArguments(&_input, argc, argv+2);
+}
+
+BatchManager::~BatchManager() {
+	cleanInputFile(&_input);
+	for(std::vector<void *>::iterator it = _handles.begin(); it != _handles.end(); it++) dlclose(*it);
+}
+
+void BatchManager::_terminate(int arg) {
+	_stop = true;
+}
+
+double BatchManager::_wall_time() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+std::vector<std::string> BatchManager::_expand_braces(const std::string &token) {
+	std::vector<std::string> res;
+
+	// look for the first brace expression that contains either a comma or a range
+	size_t open = token.find('{');
+	while(open != std::string::npos) {
+		size_t close = token.find('}', open);
+		if(close == std::string::npos) break;
+		// nested braces are not supported: we restart from the innermost opening brace
+		size_t inner = token.rfind('{', close);
+		if(inner != open) {
+			open = inner;
+			continue;
+		}
+
+		std::string body = token.substr(open + 1, close - open - 1);
+		std::vector<std::string> items;
+		size_t dots = body.find("..");
+		if(body.find(',') != std::string::npos) {
+			std::string item;
+			std::istringstream ss(body);
+			while(std::getline(ss, item, ',')) items.push_back(item);
+			if(body[body.size() - 1] == ',') items.push_back(std::string(""));
+		}
+		else if(dots != std::string::npos) {
+			std::string first = body.substr(0, dots);
+			std::string last = body.substr(dots + 2);
+			char *end_first, *end_last;
+			long from = strtol(first.c_str(), &end_first, 10);
+			long to = strtol(last.c_str(), &end_last, 10);
+			if(first.empty() || last.empty() || *end_first != '\0' || *end_last != '\0') throw oxDNAException("Invalid range '{%s}' found in the batch manifest: only integer ranges are supported", body.c_str());
+			int step = (from <= to) ? 1 : -1;
+			for(long i = from; i != to + step; i += step) items.push_back(Utils::sformat("%ld", i));
+		}
+
+		if(items.size() == 0) {
+			open = token.find('{', open + 1);
+			continue;
+		}
+
+		std::string head = token.substr(0, open);
+		std::vector<std::string> tails = _expand_braces(token.substr(close + 1));
+		for(std::vector<std::string>::iterator it = items.begin(); it != items.end(); it++) {
+			for(std::vector<std::string>::iterator jt = tails.begin(); jt != tails.end(); jt++) res.push_back(head + *it + *jt);
+		}
+		return res;
+	}
+
+	res.push_back(token);
+	return res;
+}
+
+void BatchManager::_parse_manifest() {
+	std::ifstream manifest(_manifest.c_str());
+	if(!manifest.good()) throw oxDNAException("Cannot open the batch manifest '%s'", _manifest.c_str());
+
+	std::string base_dir(".");
+	size_t slash = _manifest.rfind('/');
+	if(slash != std::string::npos) base_dir = (slash == 0) ? std::string("") : _manifest.substr(0, slash);
+
+	std::string line;
+	int N_line = 0;
+	while(std::getline(manifest, line)) {
+		N_line++;
+		Utils::trim(line);
+		if(line.size() == 0 || line[0] == '#') continue;
+
+		// each token is expanded on its own, and the runs are the cartesian product of the expanded tokens
+		std::vector<std::vector<std::string> > combinations(1);
+		std::istringstream ss(line);
+		std::string token;
+		while(ss >> token) {
+			std::vector<std::string> expanded = _expand_braces(token);
+			std::vector<std::vector<std::string> > new_combinations;
+			for(unsigned int i = 0; i < combinations.size(); i++) {
+				for(unsigned int j = 0; j < expanded.size(); j++) {
+					new_combinations.push_back(combinations[i]);
+					new_combinations.back().push_back(expanded[j]);
+				}
+			}
+			combinations.swap(new_combinations);
+		}
+
+		for(unsigned int i = 0; i < combinations.size(); i++) {
+			BatchRun run;
+			run.id = _runs.size();
+
+			std::string input = combinations[i][0];
+			if(input[0] != '/') input = base_dir + "/" + input;
+			slash = input.rfind('/');
+			run.dir = input.substr(0, slash);
+			run.input = input.substr(slash + 1);
+			if(run.dir.empty()) run.dir = "/";
+
+			for(unsigned int j = 1; j < combinations[i].size(); j++) {
+				std::string &arg = combinations[i][j];
+				if(arg.find('=') == std::string::npos) throw oxDNAException("Line %d of the batch manifest: argument '%s' is not in the key=value form", N_line, arg.c_str());
+				std::string key = arg.substr(0, arg.find('='));
+				if(Utils::trim(key) == "output_prefix") run.prefix = arg.substr(arg.find('=') + 1);
+				run.args.push_back(arg);
+			}
+			if(run.prefix.empty()) {
+				run.prefix = Utils::sformat("batch_%d_", run.id);
+				run.args.push_back(std::string("output_prefix=") + run.prefix);
+			}
+
+			_runs.push_back(run);
+		}
+	}
+
+	if(_runs.size() == 0) throw oxDNAException("The batch manifest '%s' does not contain any run", _manifest.c_str());
+
+	std::set<std::string> outputs;
+	for(std::vector<BatchRun>::iterator it = _runs.begin(); it != _runs.end(); it++) {
+		if(!outputs.insert(it->dir + "/" + it->prefix).second) throw oxDNAException("Run %d of the batch manifest would overwrite the output of another run: please use different output_prefix values for runs sharing a directory", it->id);
+	}
+}
+
+void BatchManager::_preload(BatchRun &run) {
+	std::string input_path = run.dir + "/" + run.input;
+	input_file inp;
+	loadInputFile(&inp, input_path.c_str());
+	if(inp.state == ERROR) {
+		OX_LOG(Logger::LOG_WARNING, "Cannot open '%s', its plugins will not be preloaded", input_path.c_str());
+		return;
+	}
+	// the arguments are kept apart, since merging them with the input file would make it warn about each overwritten key
+	std::string args;
+	for(std::vector<std::string>::iterator it = run.args.begin(); it != run.args.end(); it++) args += *it + "\n";
+	input_file *args_inp = Utils::get_input_file_from_string(args);
+
+	// the same search path used by PluginManager, with relative directories resolved from the directory of the run
+	std::vector<std::string> paths(1, run.dir);
+	std::string ppath;
+	if(getInputString(args_inp, "plugin_search_path", ppath, 0) == KEY_FOUND || getInputString(&inp, "plugin_search_path", ppath, 0) == KEY_FOUND) {
+		std::vector<std::string> tokens = Utils::split(ppath, ':');
+		for(std::vector<std::string>::iterator it = tokens.begin(); it != tokens.end(); it++) {
+			if(it->size() == 0) continue;
+			paths.push_back(((*it)[0] == '/') ? *it : run.dir + "/" + *it);
+		}
+	}
+
+	std::vector<std::string> names;
+	std::string name;
+	if(getInputString(args_inp, "interaction_type", name, 0) == KEY_FOUND || getInputString(&inp, "interaction_type", name, 0) == KEY_FOUND) names.push_back(name);
+	std::vector<std::string> move_keys;
+	getInputKeys(&inp, std::string("move_"), &move_keys, 0);
+	getInputKeys(args_inp, std::string("move_"), &move_keys, 0);
+	for(std::vector<std::string>::iterator it = move_keys.begin(); it != move_keys.end(); it++) {
+		std::string move_string;
+		if(getInputString(args_inp, it->c_str(), move_string, 0) == KEY_NOT_FOUND) getInputString(&inp, it->c_str(), move_string, 0);
+		input_file *move_inp = Utils::get_input_file_from_string(move_string);
+		if(getInputString(move_inp, "type", name, 0) == KEY_FOUND) names.push_back(name);
+		cleanInputFile(move_inp);
+		delete move_inp;
+	}
+	cleanInputFile(args_inp);
+	delete args_inp;
+	cleanInputFile(&inp);
+
+	for(std::vector<std::string>::iterator it = names.begin(); it != names.end(); it++) {
+		for(std::vector<std::string>::iterator jt = paths.begin(); jt != paths.end(); jt++) {
+			std::string path = *jt + "/" + *it + ".so";
+			struct stat buffer;
+			if(stat(path.c_str(), &buffer) != 0) continue;
+
+			// the first match is the one PluginManager will pick
+			char *real_path = realpath(path.c_str(), NULL);
+			std::string key = (real_path != NULL) ? std::string(real_path) : path;
+			free(real_path);
+			bool found = false;
+			for(std::vector<std::string>::iterator kt = _preloaded.begin(); kt != _preloaded.end() && !found; kt++) found = (*kt == key);
+			if(!found) {
+				void *handle = dlopen(key.c_str(), RTLD_LAZY);
+				if(handle == NULL) OX_LOG(Logger::LOG_WARNING, "Cannot preload plugin '%s': %s", key.c_str(), dlerror());
+				else {
+					OX_DEBUG("Preloaded plugin '%s'", key.c_str());
+					_handles.push_back(handle);
+				}
+				_preloaded.push_back(key);
+			}
+			break;
+		}
+	}
+}
+
+int BatchManager::_run_child(BatchRun &run) {
+	// the signal handlers of the parent should not be inherited: SimManager installs its own
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+
+	if(chdir(run.dir.c_str()) != 0) {
+		OX_LOG(Logger::LOG_ERROR, "Run %d: cannot change directory to '%s'", run.id, run.dir.c_str());
+		return 1;
+	}
+
+	std::string log_name = run.prefix + "batch.log";
+	if(freopen(log_name.c_str(), "w", stdout) == NULL) {
+		OX_LOG(Logger::LOG_ERROR, "Run %d: cannot open '%s' for writing", run.id, log_name.c_str());
+		return 1;
+	}
+	dup2(fileno(stdout), fileno(stderr));
+
+	// SimManager expects the same arguments as oxDNA
+	std::vector<std::string> args;
+	args.push_back(std::string("oxDNA"));
+	args.push_back(run.input);
+	args.insert(args.end(), run.args.begin(), run.args.end());
+	std::vector<char *> argv;
+	for(std::vector<std::string>::iterator it = args.begin(); it != args.end(); it++) argv.push_back(const_cast<char *>(it->c_str()));
+	argv.push_back(NULL);
+
+	SimManager *mysim = NULL;
+	try {
+		mysim = new SimManager(args.size(), &argv[0]);
+		mysim->load_options();
+
+		OX_DEBUG("Initializing");
+		mysim->init();
+
+		OX_LOG(Logger::LOG_INFO, "SVN CODE VERSION: %s", SVN_VERSION);
+		OX_LOG(Logger::LOG_INFO, "COMPILED ON: %s", BUILD_TIME);
+
+		OX_DEBUG("Running");
+		mysim->run();
+
+		OX_LOG(Logger::LOG_INFO, "END OF THE SIMULATION, everything went OK!");
+	}
+	catch (oxDNAException &e) {
+		OX_LOG(Logger::LOG_ERROR, "%s", e.error());
+		return 1;
+	}
+
+	delete mysim;
+	return 0;
+}
+
+void BatchManager::_start(BatchRun &run) {
+	// unflushed output would be printed by the child as well
+	fflush(stdout);
+	fflush(stderr);
+
+	pid_t pid = fork();
+	if(pid < 0) throw oxDNAException("Run %d: fork() failed (%s)", run.id, strerror(errno));
+	if(pid == 0) {
+		// the child must never get back to the loop of the parent
+		int ret = 1;
+		try {
+			ret = _run_child(run);
+		}
+		catch (...) {
+			OX_LOG(Logger::LOG_ERROR, "Run %d: caught an unexpected exception", run.id);
+		}
+		// exit() would also run the atexit handlers and the static destructors inherited from the parent, so the
+		// buffers are flushed by hand and the process is terminated right away
+		fflush(NULL);
+		std::cout.flush();
+		_exit(ret);
+	}
+
+	run.pid = pid;
+	run.start = _wall_time();
+	run.status = std::string("running");
+	OX_LOG(Logger::LOG_INFO, "Run %d started in '%s' (pid %d)", run.id, run.dir.c_str(), (int) pid);
+}
+
+void BatchManager::load_options() {
+	Logger::instance()->get_settings(_input);
+
+	getInputInt(&_input, "batch_workers", &_N_workers, 0);
+	if(_N_workers == -1) _N_workers = sysconf(_SC_NPROCESSORS_ONLN);
+	if(_N_workers < 1) throw oxDNAException("batch_workers should be larger than 0");
+	getInputString(&_input, "batch_summary", _summary_name, 0);
+	getInputBool(&_input, "batch_preload_plugins", &_preload_plugins, 0);
+}
+
+void BatchManager::init() {
+	_parse_manifest();
+	OX_LOG(Logger::LOG_INFO, "%d runs found in '%s', %d of them will be executed at the same time", (int) _runs.size(), _manifest.c_str(), _N_workers);
+
+	if(_preload_plugins) {
+		for(std::vector<BatchRun>::iterator it = _runs.begin(); it != _runs.end(); it++) _preload(*it);
+		OX_LOG(Logger::LOG_INFO, "%d plugins preloaded", (int) _handles.size());
+	}
+
+	// no SA_RESTART, so that waitpid is interrupted by the signals
+	struct sigaction action;
+	action.sa_handler = BatchManager::_terminate;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = 0;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+}
+
+void BatchManager::run() {
+	unsigned int next = 0;
+	int running = 0;
+	bool forwarded = false;
+
+	while(running > 0 || (next < _runs.size() && !_stop)) {
+		while(!_stop && running < _N_workers && next < _runs.size()) {
+			_start(_runs[next]);
+			next++;
+			running++;
+		}
+
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if(pid < 0) {
+			if(errno != EINTR) throw oxDNAException("waitpid() failed (%s)", strerror(errno));
+			if(_stop && !forwarded) {
+				OX_LOG(Logger::LOG_INFO, "Caught a signal: no more runs will be started and the running ones will be stopped");
+				for(std::vector<BatchRun>::iterator it = _runs.begin(); it != _runs.end(); it++) {
+					if(it->status == "running") kill(it->pid, SIGTERM);
+				}
+				forwarded = true;
+			}
+			continue;
+		}
+
+		for(std::vector<BatchRun>::iterator it = _runs.begin(); it != _runs.end(); it++) {
+			if(it->pid != pid) continue;
+
+			it->end = _wall_time();
+			if(WIFEXITED(status)) {
+				it->status = Utils::sformat("exit_%d", WEXITSTATUS(status));
+				it->failed = (WEXITSTATUS(status) != 0);
+			}
+			else {
+				it->status = Utils::sformat("signal_%d", WTERMSIG(status));
+				it->failed = true;
+			}
+			running--;
+			OX_LOG((it->failed) ? Logger::LOG_WARNING : Logger::LOG_INFO, "Run %d finished (%s) after %.1lf s, %d runs left", it->id, it->status.c_str(), it->end - it->start, (int) (_runs.size() - next) + running);
+		}
+	}
+
+	_print_summary();
+}
+
+void BatchManager::_print_summary() {
+	FILE *out = fopen(_summary_name.c_str(), "w");
+	if(out == NULL) throw oxDNAException("Cannot open '%s' for writing", _summary_name.c_str());
+
+	fprintf(out, "# run status wall_time directory input arguments\n");
+	for(std::vector<BatchRun>::iterator it = _runs.begin(); it != _runs.end(); it++) {
+		std::string status = (it->status.empty()) ? std::string("not_started") : it->status;
+		fprintf(out, "%d %s %.3lf %s %s", it->id, status.c_str(), it->end - it->start, it->dir.c_str(), it->input.c_str());
+		for(std::vector<std::string>::iterator jt = it->args.begin(); jt != it->args.end(); jt++) fprintf(out, " %s", jt->c_str());
+		fprintf(out, "\n");
+	}
+	fclose(out);
+
+	OX_LOG(Logger::LOG_INFO, "Summary written to '%s'", _summary_name.c_str());
+}
+
+int BatchManager::N_failed() {
+	int res = 0;
+	for(std::vector<BatchRun>::iterator it = _runs.begin(); it != _runs.end(); it++) {
+		if(it->failed || it->status.empty()) res++;
+	}
+	return res;
+}
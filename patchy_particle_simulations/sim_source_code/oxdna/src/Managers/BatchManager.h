@@ -0,0 +1,124 @@
+/**
+ * @file    BatchManager.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef BATCHMANAGER_H_
+#define BATCHMANAGER_H_
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "../defs.h"
+
+/**
+ * @brief Runs many independent simulations, listed in a manifest file, on a pool of workers.
+ *
+ * Each non-empty line of the manifest that does not start with '#' describes one or more runs:
+ * @verbatim
+path/to/input_file [key=value ...]
+@endverbatim
+ * The key=value pairs override the keys of the input file, exactly as the command-line arguments of oxDNA do. Each token
+ * of a line can contain one or more brace expressions, which are expanded as the shell does: a line containing
+ * 'T={0.10,0.11}' and 'seed={1..4}' yields 8 runs, one for each combination. Relative paths are relative to the
+ * directory that contains the manifest.
+ *
+ * Runs are numbered from 0 in the order in which they appear after the expansion. Each run is executed in a process of
+ * its own, started in the directory of its input file, so that its relative paths (topology, configuration, plugins...)
+ * are resolved as if oxDNA had been launched there. Unless output_prefix is given in the manifest, the outputs of run n
+ * are prefixed by 'batch_\<n\>_', so that runs sharing a directory do not overwrite each other's files (runs that would
+ * write to the same files are rejected before any of them is started). The standard output and error of each run are
+ * written to '\<prefix\>batch.log'. Runs are completely independent: each of them stops when its own steps or stop
+ * conditions say so, and a run that fails does not affect the others.
+ *
+ * Separate processes are used rather than threads because the state of a simulation (ConfigInfo, the managers, the
+ * random number generators) is global to the process. As a consequence, the design data is not shared: each run reads
+ * and parses its own input file, topology, configuration and design files (e.g. the patch and particle files of
+ * PatchyShapeInteraction), exactly as a standalone oxDNA process would. Only the interaction and move plugins are
+ * shared: they are loaded once by the parent process, before the workers are forked, so that the workers use the
+ * already relocated libraries instead of loading them again. What is saved with respect to launching each run
+ * separately is thus the startup of the processes and the loading of the plugins.
+ *
+ * Once all the runs are over, a summary containing the exit status and the wall time of each run is written. The
+ * options are given on the command line as key=value pairs:
+ * @verbatim
+[batch_workers = <int> (number of runs executed at the same time, defaults to the number of online cores)]
+[batch_summary = <string> (file the summary is written to, defaults to 'batch_summary.dat' in the current directory)]
+[batch_preload_plugins = <bool> (whether the plugins should be loaded before the workers are forked, defaults to true)]
+@endverbatim
+ * Sending SIGINT or SIGTERM to the batch process stops the launch of new runs. The running ones are signalled in
+ * turn, so that they can stop gracefully and print their last configurations.
+ */
+class BatchManager {
+protected:
+	struct BatchRun {
+		int id;
+		/// directory the run is executed in
+		std::string dir;
+		/// input file, relative to dir
+		std::string input;
+		std::vector<std::string> args;
+		std::string prefix;
+
+		pid_t pid;
+		/// human-readable exit status, empty if the run has not been started
+		std::string status;
+		bool failed;
+		double start, end;
+
+		BatchRun() : id(-1), pid(-1), failed(false), start(0.), end(0.) {}
+	};
+
+	input_file _input;
+	std::string _manifest;
+	std::string _summary_name;
+	int _N_workers;
+	bool _preload_plugins;
+
+	std::vector<BatchRun> _runs;
+	std::vector<void *> _handles;
+	std::vector<std::string> _preloaded;
+
+	/// set by the signal handler
+	static volatile bool _stop;
+	static void _terminate(int arg);
+
+	/// returns the wall-clock time in seconds
+	static double _wall_time();
+
+	/**
+	 * @brief Applies the shell-like brace expansion to a token.
+	 *
+	 * Brace expressions can be lists ({a,b,c}) or integer ranges ({1..4}). Braces that contain neither a comma nor a
+	 * range are left untouched.
+	 *
+	 * @param token
+	 * @return the list of expanded tokens, in order
+	 */
+	static std::vector<std::string> _expand_braces(const std::string &token);
+
+	void _parse_manifest();
+	/// dlopens the interaction and move plugins required by the run, if they can be found
+	void _preload(BatchRun &run);
+	void _start(BatchRun &run);
+	/// executes the run in the current (forked) process and returns its exit status
+	static int _run_child(BatchRun &run);
+	void _print_summary();
+
+public:
+	BatchManager(int argc, char *argv[]);
+	virtual ~BatchManager();
+
+	void load_options();
+	void init();
+	void run();
+
+	/// returns the number of runs that failed or were not started
+	int N_failed();
+};
+
+#endif /* BATCHMANAGER_H_ */
@@ -0,0 +1,231 @@
+/*
+ * BenchmarkManager.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include <sys/time.h>
+#include <sstream>
+
+#include "BenchmarkManager.h"
+#include "../Backends/BackendFactory.h"
+#include "../Backends/MC_CPUBackend2.h"
+#include "../Interactions/BaseInteraction.h"
+#include "../Lists/BaseList.h"
+#include "../Boxes/BaseBox.h"
+#include "../Particles/BaseParticle.h"
+#include "../Utilities/ConfigInfo.h"
+#include "../Utilities/Utils.h"
+#include "../Utilities/RandomManager.h"
+
+BenchmarkManager::BenchmarkManager(int argc, char *argv[]) {
+	_backend = NULL;
+	_seed = 0;
+	_min_time = 0.5;
+	_label = std::string(argv[1]);
+	_output_name = std::string("stdout");
+
+	loadInputFile(&_input, argv[1]);
+	if(_input.state == ERROR) throw oxDNAException("Caught an error while opening the input file");
+	argc -= 2;
+	if(argc > 0) addCommandLineArguments(&_input, argc, argv+2);
+}
+
+BenchmarkManager::~BenchmarkManager() {
+	cleanInputFile(&_input);
+	if(_backend != NULL) delete _backend;
+}
+
+double BenchmarkManager::_wall_time() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+void BenchmarkManager::load_options() {
+	Logger::instance()->get_settings(_input);
+	RandomManager::instance()->get_settings(_input);
+
+	// benchmarks should be reproducible, hence the seed does not default to a random value
+	getInputInt(&_input, "seed", &_seed, 0);
+	getInputDouble(&_input, "benchmark_min_time", &_min_time, 0);
+	if(_min_time <= 0.) throw oxDNAException("benchmark_min_time should be larger than 0");
+	getInputString(&_input, "benchmark_output", _output_name, 0);
+	getInputString(&_input, "benchmark_label", _label, 0);
+}
+
+void BenchmarkManager::init() {
+	RandomManager::instance()->seed(_seed);
+
+	_backend = BackendFactory::make_backend(_input);
+	_backend->get_settings(_input);
+	_backend->init();
+}
+
+template<typename number>
+void BenchmarkManager::_bench_pair_interaction() {
+	ConfigInfo<number> *info = ConfigInfo<number>::instance();
+	std::vector<ParticlePair<number> > pairs = info->lists->get_potential_interactions();
+	if(pairs.size() == 0) {
+		OX_LOG(Logger::LOG_INFO, "No interacting pairs, skipping the pair_interaction benchmark");
+		return;
+	}
+
+	// the sum of the energies is logged so that the compiler cannot optimise the calls away
+	number energy = 0.;
+	llint reps = 1;
+	double elapsed;
+	while(true) {
+		energy = 0.;
+		double start = _wall_time();
+		for(llint r = 0; r < reps; r++) {
+			for(typename std::vector<ParticlePair<number> >::iterator it = pairs.begin(); it != pairs.end(); it++) {
+				energy += info->interaction->pair_interaction(it->first, it->second);
+			}
+		}
+		elapsed = _wall_time() - start;
+		if(elapsed >= _min_time) break;
+		reps *= 2;
+	}
+	info->interaction->set_is_infinite(false);
+	OX_LOG(Logger::LOG_INFO, "pair_interaction: %d pairs, total energy %g", (int) pairs.size(), energy / reps);
+
+	_results.push_back(Utils::sformat("{\"name\": \"pair_interaction\", \"pairs\": %d, \"repetitions\": %lld, \"ns_per_pair\": %.6g}", (int) pairs.size(), reps, elapsed * 1e9 / (reps * (double) pairs.size())));
+}
+
+template<typename number>
+void BenchmarkManager::_bench_lists() {
+	ConfigInfo<number> *info = ConfigInfo<number>::instance();
+	int N = *info->N;
+
+	llint reps = 1;
+	double elapsed;
+	while(true) {
+		double start = _wall_time();
+		for(llint r = 0; r < reps; r++) info->lists->global_update(true);
+		elapsed = _wall_time() - start;
+		if(elapsed >= _min_time) break;
+		reps *= 2;
+	}
+	_results.push_back(Utils::sformat("{\"name\": \"global_update\", \"repetitions\": %lld, \"ns_per_particle\": %.6g}", reps, elapsed * 1e9 / (reps * (double) N)));
+
+	std::vector<BaseParticle<number> *> neighs;
+	llint N_neighs = 0;
+	reps = 1;
+	while(true) {
+		N_neighs = 0;
+		double start = _wall_time();
+		for(llint r = 0; r < reps; r++) {
+			for(int i = 0; i < N; i++) {
+				info->lists->fill_neigh_list(info->particles[i], neighs);
+				N_neighs += neighs.size();
+			}
+		}
+		elapsed = _wall_time() - start;
+		if(elapsed >= _min_time) break;
+		reps *= 2;
+	}
+	_results.push_back(Utils::sformat("{\"name\": \"neigh_list\", \"repetitions\": %lld, \"avg_neighbours\": %.6g, \"ns_per_particle\": %.6g}", reps, N_neighs / (reps * (double) N), elapsed * 1e9 / (reps * (double) N)));
+}
+
+template<typename number>
+void BenchmarkManager::_bench_moves() {
+	MC_CPUBackend2<number> *backend = dynamic_cast<MC_CPUBackend2<number> *>(_backend);
+	if(backend == NULL) {
+		OX_LOG(Logger::LOG_INFO, "The backend is not MC2, skipping the move benchmarks");
+		return;
+	}
+
+	std::vector<std::string> move_keys;
+	getInputKeys(&_input, std::string("move_"), &move_keys, 0);
+	std::vector<BaseMove<number> *> &moves = backend->get_moves();
+	int N = *ConfigInfo<number>::instance()->N;
+
+	llint curr_step = 0;
+	for(unsigned int j = 0; j < moves.size(); j++) {
+		std::string move_string, move_type("unknown");
+		getInputString(&_input, move_keys[j].c_str(), move_string, 1);
+		input_file *move_inp = Utils::get_input_file_from_string(move_string);
+		getInputString(move_inp, "type", move_type, 0);
+		cleanInputFile(move_inp);
+		delete move_inp;
+
+		llint attempted = moves[j]->get_attempted();
+		llint accepted = moves[j]->get_accepted();
+
+		// each repetition is a sweep, i.e. N attempts
+		llint reps = 1;
+		llint done = 0;
+		double elapsed = 0.;
+		while(true) {
+			double start = _wall_time();
+			for(llint r = 0; r < reps; r++, curr_step++) {
+				for(int i = 0; i < N; i++) moves[j]->apply(curr_step);
+			}
+			elapsed += _wall_time() - start;
+			done += reps;
+			if(elapsed >= _min_time) break;
+			reps *= 2;
+		}
+
+		double acceptance = (moves[j]->get_accepted() - accepted) / (double) (moves[j]->get_attempted() - attempted);
+		_results.push_back(Utils::sformat("{\"name\": \"move\", \"key\": %s, \"type\": %s, \"sweeps\": %lld, \"acceptance\": %.6g, \"ns_per_move\": %.6g}", Utils::json_string(move_keys[j]).c_str(), Utils::json_string(move_type).c_str(), done, acceptance, elapsed * 1e9 / (done * (double) N)));
+	}
+}
+
+template<typename number>
+void BenchmarkManager::_print_json(FILE *out) {
+	ConfigInfo<number> *info = ConfigInfo<number>::instance();
+	int N = *info->N;
+	LR_vector<number> sides = info->box->box_sides();
+
+	std::string interaction_type("DNA"), list_type("verlet"), sim_type("MD"), precision("double");
+	getInputString(&_input, "interaction_type", interaction_type, 0);
+	getInputString(&_input, "list_type", list_type, 0);
+	getInputString(&_input, "sim_type", sim_type, 0);
+	getInputString(&_input, "backend_precision", precision, 0);
+
+	fprintf(out, "{\n");
+	fprintf(out, "\t\"label\": %s,\n", Utils::json_string(_label).c_str());
+	fprintf(out, "\t\"interaction_type\": %s,\n", Utils::json_string(interaction_type).c_str());
+	fprintf(out, "\t\"list_type\": %s,\n", Utils::json_string(list_type).c_str());
+	fprintf(out, "\t\"sim_type\": %s,\n", Utils::json_string(sim_type).c_str());
+	fprintf(out, "\t\"backend_precision\": %s,\n", Utils::json_string(precision).c_str());
+	fprintf(out, "\t\"N\": %d,\n", N);
+	fprintf(out, "\t\"box\": [%.6g, %.6g, %.6g],\n", (double) sides.x, (double) sides.y, (double) sides.z);
+	fprintf(out, "\t\"density\": %.6g,\n", N / (double) info->box->V());
+	fprintf(out, "\t\"min_time\": %g,\n", _min_time);
+	fprintf(out, "\t\"results\": [\n");
+	for(unsigned int i = 0; i < _results.size(); i++) fprintf(out, "\t\t%s%s\n", _results[i].c_str(), (i + 1 < _results.size()) ? "," : "");
+	fprintf(out, "\t]\n");
+	fprintf(out, "}\n");
+}
+
+void BenchmarkManager::run() {
+	std::string precision("double");
+	getInputString(&_input, "backend_precision", precision, 0);
+	bool is_double = (precision == "double");
+	if(!is_double && precision != "float") throw oxDNAException("The benchmarks support only CPU backends with backend_precision = float or double");
+
+	OX_LOG(Logger::LOG_INFO, "Timing pair_interaction...");
+	if(is_double) _bench_pair_interaction<double>();
+	else _bench_pair_interaction<float>();
+
+	OX_LOG(Logger::LOG_INFO, "Timing the lists...");
+	if(is_double) _bench_lists<double>();
+	else _bench_lists<float>();
+
+	OX_LOG(Logger::LOG_INFO, "Timing the moves...");
+	if(is_double) _bench_moves<double>();
+	else _bench_moves<float>();
+
+	FILE *out = stdout;
+	if(_output_name != "stdout") {
+		out = fopen(_output_name.c_str(), "w");
+		if(out == NULL) throw oxDNAException("Cannot open '%s' for writing", _output_name.c_str());
+	}
+	if(is_double) _print_json<double>(out);
+	else _print_json<float>(out);
+	if(out != stdout) fclose(out);
+}
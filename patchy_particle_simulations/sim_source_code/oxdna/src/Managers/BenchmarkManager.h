@@ -0,0 +1,67 @@
+/**
+ * @file    BenchmarkManager.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef BENCHMARKMANAGER_H_
+#define BENCHMARKMANAGER_H_
+
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "../defs.h"
+#include "../Backends/SimBackend.h"
+
+/**
+ * @brief Times the building blocks of a simulation on the configuration of a regular oxDNA input file.
+ *
+ * The backend is set up exactly as oxDNA would set it up. Then the following quantities are measured, in this order:
+ * - the time taken by pair_interaction, averaged over all the pairs returned by the lists (ns/pair);
+ * - the time taken by a forced global_update of the lists (ns/particle);
+ * - the time taken to fill the neighbour list of a particle (ns/particle);
+ * - for MC2 simulations, the time taken by each of the moves (ns/move). The moves act on the configuration, so they are
+ * timed last and one after the other, in the order in which they are specified in the input file.
+ *
+ * Each measurement is repeated, doubling the number of repetitions each time, until it takes at least
+ * benchmark_min_time seconds. The results are printed as a single JSON object.
+ *
+ * @verbatim
+[benchmark_min_time = <float> (minimum duration of each measurement, in seconds, defaults to 0.5)]
+[benchmark_output = <string> (file the JSON object is written to, defaults to stdout)]
+[benchmark_label = <string> (label stored in the JSON object, defaults to the name of the input file)]
+@endverbatim
+ */
+class BenchmarkManager {
+protected:
+	input_file _input;
+	ISimBackend *_backend;
+	int _seed;
+	double _min_time;
+	std::string _label;
+	std::string _output_name;
+
+	/// one JSON object per measurement
+	std::vector<std::string> _results;
+
+	/// returns the wall-clock time in seconds
+	static double _wall_time();
+
+	template<typename number> void _bench_pair_interaction();
+	template<typename number> void _bench_lists();
+	template<typename number> void _bench_moves();
+	template<typename number> void _print_json(FILE *out);
+
+public:
+	BenchmarkManager(int argc, char *argv[]);
+	virtual ~BenchmarkManager();
+
+	void load_options();
+	void init();
+	void run();
+};
+
+#endif /* BENCHMARKMANAGER_H_ */
@@ -10,6 +10,7 @@
 #include "../Forces/ForceFactory.h"
 #include "../PluginManagement/PluginManager.h"
 #include "../Boxes/BoxFactory.h"
+#include "../Utilities/RandomManager.h"
 
 GeneratorManager::GeneratorManager(int argc, char *argv[]) {
 	_use_density = false;
@@ -103,9 +104,9 @@ void GeneratorManager::load_options() {
 		}
 	}
 	OX_LOG(Logger::LOG_INFO, "Setting the random number generator with seed = %d", seed);
-	srand48((long int)seed);
-
 	Logger::instance()->get_settings(_input);
+	RandomManager::instance()->get_settings(_input);
+	RandomManager::instance()->seed((long int)seed);
 
 	PluginManager *pm = PluginManager::instance();
 	pm->init(_input);
@@ -11,6 +11,8 @@
 #include "../Backends/BackendFactory.h"
 #include "../Utilities/oxDNAException.h"
 #include "../Utilities/Timings.h"
+#include "../Utilities/RandomManager.h"
+#include "../Utilities/Utils.h"
 
 void gbl_terminate (int arg) {
 	// if the simulation has not started yet, then we make it so pressing ctrl+c twice
@@ -94,12 +96,14 @@ void SimManager::_get_options() {
 
 void SimManager::load_options() {
 	Logger::instance()->get_settings(_input);
+	RandomManager::instance()->get_settings(_input);
+	TimingManager::instance()->get_settings(_input);
 	_get_options();
 }
 
 void SimManager::init() {
 	OX_LOG(Logger::LOG_INFO, "seeding the RNG with %d", _seed);
-	srand48(_seed);
+	RandomManager::instance()->seed(_seed);
 
 	OX_LOG(Logger::LOG_INFO, "Initializing backend ", _seed);
 	_backend = BackendFactory::make_backend(_input);
@@ -126,6 +130,7 @@ void SimManager::init() {
 	else throw oxDNAException("Time scale '%s' not supported", ts_type);
 
 	_backend->init();
+	_backend->restore_state();
 
 	_start_step = _backend->_start_step_from_file;
 
@@ -149,6 +154,16 @@ void SimManager::init() {
 	_max_steps = _start_step + _steps;
 }
 
+llint SimManager::_next_event_step(llint step) {
+	llint next = _backend->next_event_step(step);
+	if(_time_scale_manager.next_step >= step) next = Utils::earliest_step(next, _time_scale_manager.next_step);
+	if(_fix_diffusion_every > 0) next = Utils::earliest_step(next, Utils::next_multiple(step, _fix_diffusion_every, 2));
+	next = Utils::earliest_step(next, TimingManager::instance()->next_telemetry_step(step));
+
+	if(next < 0 || next > _max_steps) next = _max_steps;
+	return next;
+}
+
 void SimManager::run() {
 	SimManager::started = true;
 	// equilibration loop
@@ -162,8 +177,15 @@ void SimManager::run() {
 		_backend->print_equilibration_info();
 	}
 
-	// main loop
-	for(_cur_step = _start_step; _cur_step < _max_steps && !SimManager::stop; _cur_step++) {
+	// main loop. Only the steps at which something other than sim_step may have to be done are dealt with
+	// in full: the ones in between are run in a tight loop, which still leaves as soon as SimManager::stop
+	// is set (e.g. by the stop conditions of the FFS backends, which are checked by sim_step)
+	for(_cur_step = _start_step; _cur_step < _max_steps && !SimManager::stop;) {
+		// if a stopping criterion is met we leave the loop before doing anything, so that the
+		// current step is dealt with by the code that follows the loop
+		if(_backend->check_stop_conditions(_cur_step)) break;
+		_backend->print_state(_cur_step);
+
 		if(_cur_step == _time_scale_manager.next_step) {
 			if(_cur_step > _start_step) _backend->print_conf(_cur_step);
 			setTSNextStep(&_time_scale_manager);
@@ -171,8 +193,22 @@ void SimManager::run() {
 		if (_cur_step > 1 && _cur_step % _fix_diffusion_every == 0) _backend->fix_diffusion();
 
 		_backend->print_observables(_cur_step);
+		// this has to be done after the observables have been printed and before the current step is run
+		llint next_event = _next_event_step(_cur_step + 1);
+
 		_backend->sim_step(_cur_step);
+		TimingManager::instance()->telemetry_step(_cur_step);
+		_cur_step++;
+
+		while(_cur_step < next_event && !SimManager::stop) {
+			_backend->sim_step(_cur_step);
+			_cur_step++;
+		}
 	}
+	// the state is printed before the current step is dealt with, since a simulation restarted from it will start
+	// by dealing with it
+	_backend->print_state(_cur_step, true);
+
 	// this is in case _cur_step, after being increased by 1 before exiting the loop,
 	// has become a multiple of print_conf_every
 	if (_cur_step > 1 && _cur_step % _fix_diffusion_every == 0) _backend->fix_diffusion();
@@ -185,7 +221,9 @@ void SimManager::run() {
 
 	// prints the last configuration
 	_backend->print_conf(_cur_step, false, true);
+	_backend->flush_output();
 
+	if(TimingManager::instance()->telemetry_enabled()) TimingManager::instance()->write_telemetry(_cur_step);
 	TimingManager::instance()->print(_cur_step - _start_step);
 }
 
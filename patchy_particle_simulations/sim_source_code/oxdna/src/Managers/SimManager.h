@@ -58,6 +58,15 @@ protected:
 	char _conf_file[256];
 	virtual void _get_options();
 
+	/**
+	 * @brief Returns the first step, larger than or equal to step, at which the main loop has to do something other than
+	 * running the step (printing configurations or observables, checking the stop conditions, etc.). It never returns a
+	 * step larger than the last one.
+	 *
+	 * @param step
+	 */
+	llint _next_event_step(llint step);
+
 public:
 	SimManager(int argc, char *argv[]);
 	virtual ~SimManager();
@@ -47,6 +47,29 @@ public:
 	 * @param config_info
 	 */
 	virtual void init(ConfigInfo<number> &config_info) { }
+
+	/**
+	 * @brief Writes, in binary format, whatever the observable accumulates across calls (e.g. histograms), so that a
+	 * simulation restarted from a state file (see SimBackend) goes on as if it had never stopped. Stateless observables
+	 * do not need to override it.
+	 *
+	 * @param out
+	 */
+	virtual void write_state(std::ostream &out) { }
+
+	/**
+	 * @brief Restores the state written by {\@link write_state}. It is called after init().
+	 *
+	 * @param in
+	 */
+	virtual void read_state(std::istream &in) { }
+
+	/**
+	 * @brief Returns true if the output of the observable depends on the configurations it has been computed on before
+	 * the current one (e.g. averages or histograms accumulated over the trajectory). Such observables cannot be computed
+	 * on separate parts of a trajectory (see AnalysisManager).
+	 */
+	virtual bool is_cumulative() { return false; }
 };
 
 #endif /* BASEOBSERVABLE_H_ */
@@ -32,6 +32,7 @@ std::string BinaryConfiguration<number>::_headers(llint step) {
 
 	// print out the number
 	headers.write((char *)rndseed, 3 * sizeof(unsigned short));
+	if(this->_config_info.rng->is_philox()) this->_config_info.rng->write_state(headers);
 
 	LR_vector<double> my_box_sides (this->_config_info.box->box_sides().x, this->_config_info.box->box_sides().y, this->_config_info.box->box_sides().z);
 	headers.write ((char * )(&my_box_sides.x), sizeof (double));
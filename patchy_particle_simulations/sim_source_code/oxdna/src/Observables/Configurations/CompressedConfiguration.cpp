@@ -0,0 +1,94 @@
+/*
+ * CompressedConfiguration.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include "CompressedConfiguration.h"
+#include "../../Particles/BaseParticle.h"
+
+template<typename number>
+CompressedConfiguration<number>::CompressedConfiguration() : Configuration<number>() {
+
+}
+
+template<typename number>
+CompressedConfiguration<number>::~CompressedConfiguration() {
+
+}
+
+template<typename number>
+void CompressedConfiguration<number>::get_settings(input_file &my_inp, input_file &sim_inp) {
+	Configuration<number>::get_settings(my_inp, sim_inp);
+
+	// frames should contain all the particles to be read back
+	if(this->_reduced || this->_only_type != -1 || !this->_visible_particles.empty() || !this->_hidden_particles.empty()) {
+		throw oxDNAException("compressed_configuration does not support the reduced, only_type, show and hide options");
+	}
+
+	getInputDouble(&my_inp, "position_precision", &_settings.position_precision, 0);
+	if(_settings.position_precision <= 0.) throw oxDNAException("compressed_configuration: position_precision should be larger than 0");
+	getInputInt(&my_inp, "orientation_bits", &_settings.orientation_bits, 0);
+	if(_settings.orientation_bits < 8 || _settings.orientation_bits > 20) throw oxDNAException("compressed_configuration: orientation_bits should be between 8 and 20");
+	getInputBool(&my_inp, "velocities", &_settings.velocities, 0);
+	getInputInt(&my_inp, "compression_level", &_settings.compression_level, 0);
+	if(_settings.compression_level < 0 || _settings.compression_level > 9) throw oxDNAException("compressed_configuration: compression_level should be between 0 and 9");
+#ifndef HAVE_ZLIB
+	if(_settings.compression_level > 0) OX_LOG(Logger::LOG_WARNING, "compressed_configuration: oxDNA has been compiled without zlib support, configurations will be quantised but not compressed");
+#endif
+}
+
+template<typename number>
+std::string CompressedConfiguration<number>::get_output_string(llint curr_step) {
+	int N = *this->_config_info.N;
+	LR_vector<number> box_sides = this->_config_info.box->box_sides();
+
+	_frame.step = curr_step;
+	_frame.box[0] = box_sides.x;
+	_frame.box[1] = box_sides.y;
+	_frame.box[2] = box_sides.z;
+	_frame.U = this->_tot_energy.get_U(curr_step);
+	_frame.K = this->_tot_energy.get_K(curr_step);
+	_frame.pos.resize(3 * N);
+	_frame.orientation.resize(9 * N);
+	if(_settings.velocities) _frame.vel.resize(6 * N);
+
+	if(this->_back_in_box) this->_fill_strands_cdm();
+	for(int i = 0; i < N; i++) {
+		BaseParticle<number> *p = this->_config_info.particles[i];
+
+		// the same positions printed by Configuration
+		LR_vector<double> mypos;
+		if(this->_back_in_box) {
+			LR_vector<number> &cdm = this->_strands_cdm[p->strand_id];
+			mypos.x = p->pos.x - floor(cdm.x / box_sides.x) * box_sides.x;
+			mypos.y = p->pos.y - floor(cdm.y / box_sides.y) * box_sides.y;
+			mypos.z = p->pos.z - floor(cdm.z / box_sides.z) * box_sides.z;
+		}
+		else {
+			LR_vector<number> abs_pos = this->_config_info.box->get_abs_pos(p);
+			mypos = LR_vector<double>(abs_pos.x, abs_pos.y, abs_pos.z);
+		}
+		_frame.pos[3 * i] = mypos.x;
+		_frame.pos[3 * i + 1] = mypos.y;
+		_frame.pos[3 * i + 2] = mypos.z;
+
+		LR_matrix<number> oT = p->orientation.get_transpose();
+		double *o = &_frame.orientation[9 * i];
+		o[0] = oT.v1.x; o[1] = oT.v1.y; o[2] = oT.v1.z;
+		o[3] = oT.v2.x; o[4] = oT.v2.y; o[5] = oT.v2.z;
+		o[6] = oT.v3.x; o[7] = oT.v3.y; o[8] = oT.v3.z;
+
+		if(_settings.velocities) {
+			double *v = &_frame.vel[6 * i];
+			v[0] = p->vel.x; v[1] = p->vel.y; v[2] = p->vel.z;
+			v[3] = p->L.x; v[4] = p->L.y; v[5] = p->L.z;
+		}
+	}
+
+	return CompressedTrajectory::encode_frame(_frame, _settings);
+}
+
+template class CompressedConfiguration<float>;
+template class CompressedConfiguration<double>;
@@ -0,0 +1,44 @@
+/**
+ * @file    CompressedConfiguration.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef COMPRESSEDCONFIGURATION_H_
+#define COMPRESSEDCONFIGURATION_H_
+
+#include "Configuration.h"
+#include "../../Utilities/CompressedTrajectory.h"
+
+/**
+ * @brief Prints configurations in the compressed binary format described in CompressedTrajectory.
+ *
+ * Positions are quantised and orientations are stored as compressed quaternions, so that the configurations are not
+ * stored exactly. Trajectories in this format can be read by DNAnalysis and used as initial configurations, and single
+ * frames can be accessed without reading the previous ones. The observable should be the only column of its output
+ * stream. The supported syntax is (optional values are between [])
+ * @verbatim
+[back_in_box = <bool> (if true the particle positions will be brought back in the box, defaults to false)]
+[position_precision = <float> (absolute precision with which positions are stored, defaults to 1e-5)]
+[orientation_bits = <int> (number of bits used to store each of the three components of the quaternions that are stored, between 8 and 20. 16 bits correspond to an error of the order of 1e-4 on the orientation vectors. Defaults to 16)]
+[velocities = <bool> (whether velocities and angular momenta should be stored, in single precision, defaults to false)]
+[compression_level = <int> (zlib compression level, from 0 (no compression) to 9, defaults to 1)]
+@endverbatim
+ */
+template<typename number>
+class CompressedConfiguration: public Configuration<number>  {
+protected:
+	CompressedTrajectory::Settings _settings;
+	TrajectoryFrame _frame;
+
+public:
+	CompressedConfiguration();
+	virtual ~CompressedConfiguration();
+
+	virtual void get_settings(input_file &my_inp, input_file &sim_inp);
+	std::string get_output_string(llint curr_step);
+};
+
+#endif /* COMPRESSEDCONFIGURATION_H_ */
@@ -52,6 +52,7 @@
 #include "Configurations/ChimeraOutput.h"
 #include "Configurations/Configuration.h"
 #include "Configurations/BinaryConfiguration.h"
+#include "Configurations/CompressedConfiguration.h"
 #include "Configurations/TclOutput.h"
 #include "Configurations/TEPtclOutput.h"
 #include "Configurations/TEPxyzOutput.h"
@@ -86,6 +87,7 @@ BaseObservable<number> *ObservableFactory::make_observable(input_file &obs_inp,
 	else if(!strncasecmp(obs_type, "force_energy", 512)) res = new ForceEnergy<number>();
 	else if(!strncasecmp(obs_type, "configuration", 512)) res = new Configuration<number>();
 	else if(!strncasecmp(obs_type, "binary_configuration", 512)) res = new BinaryConfiguration<number>();
+	else if(!strncasecmp(obs_type, "compressed_configuration", 512)) res = new CompressedConfiguration<number>();
 	else if(!strncasecmp(obs_type, "tcl_configuration", 512)) res = new TclOutput<number>();
 	else if(!strncasecmp(obs_type, "pressure", 512)) res = new Pressure<number>();
 	else if(!strncasecmp(obs_type, "density", 512)) res = new Density<number>();
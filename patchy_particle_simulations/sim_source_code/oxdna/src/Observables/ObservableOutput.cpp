@@ -7,15 +7,18 @@
 
 #include <sstream>
 #include <iostream>
+#include <iterator>
+#include <cstdio>
 
 #include "ObservableOutput.h"
 #include "ObservableFactory.h"
 #include "../Utilities/Utils.h"
+#include "../Utilities/AsyncWriter.h"
 
 using namespace std;
 
 template<typename number>
-ObservableOutput<number>::ObservableOutput(std::string &stream_string, input_file &sim_inp) : _prefix("") {
+ObservableOutput<number>::ObservableOutput(std::string &stream_string, input_file &sim_inp) : _prefix(""), _writer(NULL) {
 	_sim_inp = sim_inp;
 	_start_from = 0;
 	_stop_at = -1;
@@ -133,8 +136,49 @@ void ObservableOutput<number>::add_observable(std::string obs_string) {
 	delete obs_inp;
 }
 
+template<typename number>
+void ObservableOutput<number>::set_writer(AsyncWriter *writer) {
+	if(_output_name != "stdout" && _output_name != "stderr") _writer = writer;
+}
+
+template<typename number>
+void ObservableOutput<number>::set_part_file(std::string part_name) {
+	if(_update_name_with_time) return;
+	// parts are always written from scratch
+	_output_name = part_name;
+	_append = false;
+}
+
+template<typename number>
+void ObservableOutput<number>::merge_parts(const std::vector<std::string> &parts) {
+	if(_update_name_with_time) return;
+
+	std::string merged;
+	for(std::vector<std::string>::const_iterator it = parts.begin(); it != parts.end(); it++) {
+		ifstream part(it->c_str(), ios::binary);
+		if(!part.good()) continue;
+		std::string content((std::istreambuf_iterator<char>(part)), std::istreambuf_iterator<char>());
+		if(_only_last) {
+			if(content.size() > 0) merged.swap(content);
+		}
+		else merged += content;
+	}
+
+	_open_output();
+	if(_only_last && _output == &_output_stream) _output_stream.open(_output_name.c_str(), ios::binary);
+	*_output << merged;
+	_output->flush();
+	if(_output_stream.is_open()) _output_stream.close();
+	if(_output->bad()) throw oxDNAException("Error while writing to '%s'", _output_name.c_str());
+	_bytes_written += (llint) merged.size();
+
+	for(std::vector<std::string>::const_iterator it = parts.begin(); it != parts.end(); it++) remove(it->c_str());
+}
+
 template<typename number>
 void ObservableOutput<number>::change_output_file(string new_filename) {
+	// the stream is about to be closed, and so whatever has been queued for it has to be written first
+	if(_writer != NULL) _writer->flush();
 	_output_name = _prefix + new_filename;
 	if(_output_stream.is_open()) _output_stream.close();
 	_open_output();
@@ -164,6 +208,19 @@ bool ObservableOutput<number>::is_ready(llint step) {
 	}
 }
 
+template<typename number>
+llint ObservableOutput<number>::next_ready_step(llint step) {
+	llint next;
+	if(_linear) next = Utils::next_multiple(step, _print_every, _start_from);
+	else {
+		while(_log_next < step) _set_next_log_step();
+		next = _log_next;
+	}
+
+	if(_stop_at > -1 && next > _stop_at) return -1;
+	return next;
+}
+
 template<typename number>
 void ObservableOutput<number>::print_output(llint step) {
 	stringstream ss;
@@ -175,19 +232,50 @@ void ObservableOutput<number>::print_output(llint step) {
 
 	if(_update_name_with_time) {
 		string new_name = Utils::sformat("%s%lld", _base_name.c_str(), step);
-		change_output_file(new_name);
+		// each file is written only once, and so the background thread can write it from scratch
+		if(_writer != NULL) _output_name = _prefix + new_name;
+		else change_output_file(new_name);
 	}
-	else if(_only_last) _output_stream.open(_output_name.c_str());
+	else if(_only_last && _writer == NULL) _output_stream.open(_output_name.c_str());
 	
 	ss << endl;
 	std::string towrite = ss.str();
 	_bytes_written += (llint) towrite.length();
-	*_output << towrite;
-	_output->flush();
+	if(_writer != NULL) {
+		if(_only_last || _update_name_with_time) _writer->overwrite(_output_name, towrite);
+		else _writer->append(_output, _output_name, towrite);
+	}
+	else {
+		*_output << towrite;
+		_output->flush();
+	}
 	
-	if(_only_last) _output_stream.close();
+	if(_only_last && _writer == NULL) _output_stream.close();
 	if(!_linear) _set_next_log_step();
 }
 
+template<typename number>
+void ObservableOutput<number>::write_state(std::ostream &out) {
+	// each observable is stored together with its size, so that the state of an observable cannot spill into the next one
+	int N_obs = _obss.size();
+	out.write((char *) &N_obs, sizeof(int));
+	for(int i = 0; i < N_obs; i++) {
+		stringstream obs_state;
+		_obss[i]->write_state(obs_state);
+		Utils::write_blob(out, obs_state.str());
+	}
+}
+
+template<typename number>
+void ObservableOutput<number>::read_state(std::istream &in) {
+	int N_obs;
+	in.read((char *) &N_obs, sizeof(int));
+	if(!in.good() || N_obs != (int) _obss.size()) throw oxDNAException("The state of the output stream '%s' contains %d observables, but the stream has %d", _output_name.c_str(), N_obs, (int) _obss.size());
+	for(int i = 0; i < N_obs; i++) {
+		stringstream obs_state(Utils::read_blob(in));
+		_obss[i]->read_state(obs_state);
+	}
+}
+
 template class ObservableOutput<float>;
 template class ObservableOutput<double>;
@@ -13,6 +13,8 @@
 
 #include "BaseObservable.h"
 
+class AsyncWriter;
+
 /**
  * @brief Manages a single output stream.
  *
@@ -65,6 +67,8 @@ protected:
 	int _log_pos_in_cycle;
 	int _log_n_cycle;
 	bool _update_name_with_time;
+	/// if not NULL, the output is written by this object on a background thread
+	AsyncWriter *_writer;
 
 	llint _bytes_written;
 
@@ -116,6 +120,16 @@ public:
 	 */
 	void change_output_file(std::string new_filename);
 
+	/**
+	 * @brief Hands the writing of the output over to the given AsyncWriter, which must outlive the object.
+	 *
+	 * The output is still generated by print_output, but it is written on a background thread. Streams that write to
+	 * stdout or stderr are always written synchronously, so that their output is not mixed with the log messages.
+	 *
+	 * @param writer
+	 */
+	void set_writer(AsyncWriter *writer);
+
 	/**
 	 * @brief Checks whether the object is ready to print, and returns the result
 	 * @param step simulation step
@@ -123,6 +137,44 @@ public:
 	 */
 	bool is_ready(llint step);
 
+	/**
+	 * @brief Returns the first step, larger than or equal to the given one, at which the object will be ready to print.
+	 *
+	 * Steps at which is_ready returns false need not be polled: this allows SimManager to skip the steps at which
+	 * nothing has to be printed. It has the same side effects as calling is_ready on all the steps up to the given one.
+	 *
+	 * @param step simulation step
+	 * @return the step, or -1 if the object will never be ready again
+	 */
+	llint next_ready_step(llint step);
+
+	/**
+	 * @brief Makes the stream write to the given file, which will contain only the part of the output produced by this
+	 * process. Used by the parallel analysis, whose workers write to part files that are then merged by {@link merge_parts}.
+	 * It has no effect on streams whose name is updated with the time, since their files are never shared. It should be
+	 * called before {@link init}.
+	 *
+	 * @param part_name
+	 */
+	void set_part_file(std::string part_name);
+
+	/**
+	 * @brief Merges the part files written by the workers of a parallel analysis (see {@link set_part_file}) into the
+	 * output of the stream and removes them. Parts are appended in the given order, with the exception of streams with
+	 * only_last = true, which take the content of the last non-empty part.
+	 *
+	 * @param parts names of the part files
+	 */
+	void merge_parts(const std::vector<std::string> &parts);
+
+	/// returns true if at least one of the observables accumulates data over the trajectory (see BaseObservable::is_cumulative)
+	bool is_cumulative() {
+		for(typename std::vector<BaseObservable<number> *>::iterator it = _obss.begin(); it != _obss.end(); it++) {
+			if((*it)->is_cumulative()) return true;
+		}
+		return false;
+	}
+
 	/**
 	 * @brief Returns the number of bytes written to the output file
 	 *
@@ -134,6 +186,20 @@ public:
 	 *
 	 */
 	std::string get_output_name () { return _output_name; }
+
+	/**
+	 * @brief Writes the state of the stored observables (see BaseObservable::write_state), in binary format
+	 *
+	 * @param out
+	 */
+	void write_state(std::ostream &out);
+
+	/**
+	 * @brief Restores the state written by {@link write_state}
+	 *
+	 * @param in
+	 */
+	void read_state(std::istream &in);
 };
 
 #endif /* OBSERVABLEOUTPUT_H_ */
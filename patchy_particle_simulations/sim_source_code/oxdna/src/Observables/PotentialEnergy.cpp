@@ -19,7 +19,9 @@ PotentialEnergy<number>::~PotentialEnergy() {
 
 template<typename number>
 number PotentialEnergy<number>::get_potential_energy() {
-	number energy = this->_config_info.interaction->get_system_energy(this->_config_info.particles, *this->_config_info.N, this->_config_info.lists);
+	number energy;
+	if(this->_config_info.system_energy != NULL) energy = *this->_config_info.system_energy;
+	else energy = this->_config_info.interaction->get_system_energy(this->_config_info.particles, *this->_config_info.N, this->_config_info.lists);
 	energy /= *this->_config_info.N;
 
 	return energy;
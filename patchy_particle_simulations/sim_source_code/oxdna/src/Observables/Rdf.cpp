@@ -95,5 +95,22 @@ void Rdf<number>::get_settings (input_file &my_inp, input_file &sim_inp) {
 	_profile.resize(_nbins);
 }
 
+template<typename number>
+void Rdf<number>::write_state(std::ostream &out) {
+	int size = _profile.size();
+	out.write((char *) &_nconf, sizeof(long int));
+	out.write((char *) &size, sizeof(int));
+	if(size > 0) out.write((char *) &_profile[0], size * sizeof(long double));
+}
+
+template<typename number>
+void Rdf<number>::read_state(std::istream &in) {
+	int size;
+	in.read((char *) &_nconf, sizeof(long int));
+	in.read((char *) &size, sizeof(int));
+	if(!in.good() || size != (int) _profile.size()) throw oxDNAException("Rdf: the state to be restored has %d bins, but the observable has %d", size, (int) _profile.size());
+	if(size > 0) in.read((char *) &_profile[0], size * sizeof(long double));
+}
+
 template class Rdf<float>;
 template class Rdf<double>;
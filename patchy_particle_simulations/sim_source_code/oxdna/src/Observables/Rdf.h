@@ -59,7 +59,11 @@ public:
 	virtual ~Rdf();
 
 	virtual std::string get_output_string(llint curr_step);
+	virtual bool is_cumulative() { return true; }
 	void get_settings (input_file &my_inp, input_file &sim_inp);
+
+	virtual void write_state(std::ostream &out);
+	virtual void read_state(std::istream &in);
 };
 
 #endif /* RDF_H_ */
@@ -44,6 +44,7 @@ public:
 	virtual ~SaltExtrapolation();
 
 	std::string get_output_string(llint curr_step);
+	bool is_cumulative() { return true; }
 
 	virtual void get_settings(input_file &my_inp, input_file &sim_inp);
 	void init (ConfigInfo<number> &Info);
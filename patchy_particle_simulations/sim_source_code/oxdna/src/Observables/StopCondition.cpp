@@ -0,0 +1,217 @@
+/*
+ * StopCondition.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include <sstream>
+#include <cmath>
+
+#include "StopCondition.h"
+#include "ObservableFactory.h"
+#include "../Utilities/Utils.h"
+
+using namespace std;
+
+template<typename number>
+StopCondition<number>::StopCondition(int id, std::string &cond_string, input_file &sim_inp) : _id(id), _obs(NULL), _done(false) {
+	input_file *cond_input = Utils::get_input_file_from_string(cond_string);
+
+	getInputLLInt(cond_input, "check_every", &_check_every, 1);
+	if(_check_every < 1) throw oxDNAException("stop_condition_%d: check_every should be larger than 0", _id);
+	_start_from = 0;
+	getInputLLInt(cond_input, "start_from", &_start_from, 0);
+	_column = 0;
+	getInputInt(cond_input, "column", &_column, 0);
+	if(_column < 0) throw oxDNAException("stop_condition_%d: column should be a non-negative integer", _id);
+
+	string action("stop");
+	getInputString(cond_input, "action", action, 0);
+	if(action == "stop") _action = STOP;
+	else if(action == "checkpoint") _action = CHECKPOINT;
+	else throw oxDNAException("stop_condition_%d: unsupported action '%s' (should be either stop or checkpoint)", _id, action.c_str());
+
+	_window = 1;
+	_tolerance = 0.;
+	_relative = false;
+	_N_blocks = 10;
+	string test;
+	getInputString(cond_input, "test", test, 1);
+	if(test == "threshold") {
+		_test = THRESHOLD;
+		getInputDouble(cond_input, "value", &_value, 1);
+		string direction("above");
+		getInputString(cond_input, "direction", direction, 0);
+		if(direction == "above") _above = true;
+		else if(direction == "below") _above = false;
+		else throw oxDNAException("stop_condition_%d: unsupported direction '%s' (should be either above or below)", _id, direction.c_str());
+	}
+	else if(test == "slope" || test == "block_error") {
+		_test = (test == "slope") ? SLOPE : BLOCK_ERROR;
+		getInputInt(cond_input, "window", &_window, 1);
+		getInputDouble(cond_input, "tolerance", &_tolerance, 1);
+		getInputBool(cond_input, "relative", &_relative, 0);
+		if(_test == BLOCK_ERROR) {
+			getInputInt(cond_input, "N_blocks", &_N_blocks, 0);
+			if(_N_blocks < 2) throw oxDNAException("stop_condition_%d: N_blocks should be larger than 1", _id);
+			if(_window < _N_blocks) throw oxDNAException("stop_condition_%d: window should be at least as large as N_blocks", _id);
+		}
+		else if(_window < 2) throw oxDNAException("stop_condition_%d: window should be larger than 1", _id);
+		if(_tolerance < 0.) throw oxDNAException("stop_condition_%d: tolerance should be non-negative", _id);
+	}
+	else throw oxDNAException("stop_condition_%d: unsupported test '%s' (should be threshold, slope or block_error)", _id, test.c_str());
+
+	string obs_string;
+	getInputString(cond_input, "observable", obs_string, 1);
+	input_file *obs_inp = Utils::get_input_file_from_string(obs_string);
+	_obs = ObservableFactory::make_observable<number>(*obs_inp, sim_inp);
+	cleanInputFile(obs_inp);
+	delete obs_inp;
+
+	cleanInputFile(cond_input);
+	delete cond_input;
+}
+
+template<typename number>
+StopCondition<number>::~StopCondition() {
+	if(_obs != NULL) delete _obs;
+}
+
+template<typename number>
+void StopCondition<number>::init(ConfigInfo<number> &config_info) {
+	_obs->init(config_info);
+}
+
+template<typename number>
+double StopCondition<number>::_get_value(llint curr_step) {
+	istringstream output(_obs->get_output_string(curr_step));
+	string token;
+	for(int i = 0; i <= _column; i++) {
+		if(!(output >> token)) throw oxDNAException("stop_condition_%d: the output of the observable has less than %d columns", _id, _column + 1);
+	}
+
+	char *end;
+	double value = strtod(token.c_str(), &end);
+	if(end == token.c_str() || *end != '\0') throw oxDNAException("stop_condition_%d: column %d of the observable output ('%s') is not a number", _id, _column, token.c_str());
+	return value;
+}
+
+template<typename number>
+double StopCondition<number>::_get_tolerance() {
+	if(!_relative) return _tolerance;
+
+	double mean = 0.;
+	for(deque<double>::iterator it = _values.begin(); it != _values.end(); it++) mean += *it;
+	mean /= _values.size();
+	return _tolerance * fabs(mean);
+}
+
+template<typename number>
+bool StopCondition<number>::_threshold_test() {
+	double last = _values.back();
+	return (_above) ? last > _value : last < _value;
+}
+
+template<typename number>
+bool StopCondition<number>::_slope_test() {
+	// least-squares fit of the values against their (equally spaced) positions in the window
+	double x_mean = 0.5 * (_window - 1);
+	double y_mean = 0.;
+	for(deque<double>::iterator it = _values.begin(); it != _values.end(); it++) y_mean += *it;
+	y_mean /= _window;
+
+	double sxy = 0.;
+	double sxx = 0.;
+	for(int i = 0; i < _window; i++) {
+		double dx = i - x_mean;
+		sxy += dx * (_values[i] - y_mean);
+		sxx += dx * dx;
+	}
+	double slope = sxy / sxx;
+
+	return fabs(slope) * (_window - 1) <= _get_tolerance();
+}
+
+template<typename number>
+bool StopCondition<number>::_block_error_test() {
+	// if window is not a multiple of N_blocks the oldest values are left out
+	int block_size = _window / _N_blocks;
+	int offset = _window - block_size * _N_blocks;
+
+	vector<double> block_means(_N_blocks, 0.);
+	double mean = 0.;
+	for(int b = 0; b < _N_blocks; b++) {
+		for(int i = 0; i < block_size; i++) block_means[b] += _values[offset + b * block_size + i];
+		block_means[b] /= block_size;
+		mean += block_means[b];
+	}
+	mean /= _N_blocks;
+
+	double variance = 0.;
+	for(int b = 0; b < _N_blocks; b++) variance += SQR(block_means[b] - mean);
+	double error = sqrt(variance / (_N_blocks * (_N_blocks - 1.)));
+
+	return error <= _get_tolerance();
+}
+
+template<typename number>
+int StopCondition<number>::check(llint curr_step) {
+	if(_done || curr_step < _start_from || (curr_step % _check_every) != 0) return CONTINUE;
+
+	_values.push_back(_get_value(curr_step));
+	if((int) _values.size() > _window) _values.pop_front();
+	if((int) _values.size() < _window) return CONTINUE;
+
+	bool passed = false;
+	switch(_test) {
+	case THRESHOLD:
+		passed = _threshold_test();
+		break;
+	case SLOPE:
+		passed = _slope_test();
+		break;
+	case BLOCK_ERROR:
+		passed = _block_error_test();
+		break;
+	}
+
+	if(!passed) return CONTINUE;
+
+	_done = true;
+	OX_LOG(Logger::LOG_INFO, "stop_condition_%d met at step %lld (last value: %g)", _id, curr_step, _values.back());
+	return _action;
+}
+
+template<typename number>
+llint StopCondition<number>::next_check_step(llint curr_step) {
+	if(_done) return -1;
+	return Utils::next_multiple(curr_step, _check_every, _start_from);
+}
+
+template<typename number>
+void StopCondition<number>::write_state(std::ostream &out) {
+	int N_values = _values.size();
+	out.write((char *) &_done, sizeof(bool));
+	out.write((char *) &N_values, sizeof(int));
+	for(deque<double>::iterator it = _values.begin(); it != _values.end(); it++) out.write((char *) &(*it), sizeof(double));
+}
+
+template<typename number>
+void StopCondition<number>::read_state(std::istream &in) {
+	int N_values;
+	in.read((char *) &_done, sizeof(bool));
+	in.read((char *) &N_values, sizeof(int));
+	if(!in.good() || N_values < 0 || N_values > _window) throw oxDNAException("stop_condition_%d: malformed state", _id);
+
+	_values.clear();
+	for(int i = 0; i < N_values; i++) {
+		double value;
+		in.read((char *) &value, sizeof(double));
+		_values.push_back(value);
+	}
+	if(!in.good()) throw oxDNAException("stop_condition_%d: malformed state", _id);
+}
+
+template class StopCondition<float>;
+template class StopCondition<double>;
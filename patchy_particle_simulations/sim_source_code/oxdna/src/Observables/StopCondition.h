@@ -0,0 +1,128 @@
+/**
+ * @file    StopCondition.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef STOPCONDITION_H_
+#define STOPCONDITION_H_
+
+#include <vector>
+#include <deque>
+
+#include "BaseObservable.h"
+
+/**
+ * @brief Watches a column of the output of an observable and tells the backend when the simulation should be stopped
+ * or checkpointed.
+ *
+ * Every check_every steps the observable is computed and the value in the given column of its output (columns are
+ * whitespace-separated and start from 0) is stored. Then the test is applied to the last window values:
+ * - threshold: passes as soon as the last value is larger (direction = above) or smaller (direction = below) than value;
+ * - slope: passes when the least-squares straight line through the last window values changes by less than tolerance
+ * over the whole window, i.e. when the observable has reached a plateau;
+ * - block_error: the last window values are split into N_blocks blocks and the test passes when the standard error of
+ * their mean, estimated from the spread of the block averages, is smaller than tolerance.
+ *
+ * The slope and block_error tests are not applied until window values have been collected. If relative = true the
+ * tolerance is multiplied by the absolute value of the mean of the window. Once it has passed, a condition whose action
+ * is stop makes the simulation terminate, while a condition whose action is checkpoint prints the last configuration
+ * (and the last checkpoint, if any) and then stays silent for the rest of the simulation.
+ *
+ * SimBackend stores a list of StopConditions, which are specified in the input file with 'stop_condition_\<n\>' keys
+ * (\<n\> is an integer starting from 1). The supported syntax is
+ * @verbatim
+observable = {\ntype = name of the observable\n[other observable options as lines of 'key = value']\n} (the observable to watch)
+check_every = <integer> (how often the observable should be computed, in number of steps)
+test = threshold|slope|block_error (test that should pass for the action to be taken)
+[column = <integer> (column of the observable output to watch, defaults to 0)]
+[action = stop|checkpoint (what to do when the test passes, defaults to stop)]
+[start_from = <integer> (do not compute the observable before this step, defaults to 0)]
+[value = <float> (threshold for the threshold test)]
+[direction = above|below (whether the threshold test passes when the observable is above or below value, defaults to above)]
+[window = <integer> (number of values used by the slope and block_error tests)]
+[tolerance = <float> (tolerance of the slope and block_error tests)]
+[relative = <bool> (if true the tolerance is relative to the absolute value of the mean of the window, defaults to false)]
+[N_blocks = <integer> (number of blocks used by the block_error test, defaults to 10)]
+@endverbatim
+ */
+template<typename number>
+class StopCondition {
+public:
+	enum {
+		CONTINUE = 0,
+		CHECKPOINT = 1,
+		STOP = 2
+	};
+
+protected:
+	enum {
+		THRESHOLD = 0,
+		SLOPE = 1,
+		BLOCK_ERROR = 2
+	};
+
+	int _id;
+	BaseObservable<number> *_obs;
+	int _column;
+	llint _check_every;
+	llint _start_from;
+	int _test;
+	int _action;
+	bool _done;
+
+	double _value;
+	bool _above;
+
+	int _window;
+	double _tolerance;
+	bool _relative;
+	int _N_blocks;
+
+	std::deque<double> _values;
+
+	/// computes the observable and returns the value in the watched column
+	double _get_value(llint curr_step);
+	bool _threshold_test();
+	bool _slope_test();
+	bool _block_error_test();
+	/// returns the tolerance of the slope and block_error tests, possibly rescaled by the mean of the window
+	double _get_tolerance();
+
+public:
+	/**
+	 * @brief Constructor.
+	 *
+	 * @param id index of the stop_condition_<n> key the object has been built from
+	 * @param cond_string a string containing all the key=values lines related to the object and to its observable
+	 * @param sim_inp simulation input file
+	 */
+	StopCondition(int id, std::string &cond_string, input_file &sim_inp);
+	virtual ~StopCondition();
+
+	void init(ConfigInfo<number> &config_info);
+
+	/**
+	 * @brief Applies the test, if the observable has to be computed at this step.
+	 *
+	 * @param curr_step
+	 * @return CONTINUE, CHECKPOINT or STOP
+	 */
+	int check(llint curr_step);
+
+	/**
+	 * @brief Returns the first step, larger than or equal to curr_step, at which {@link check} will apply the test.
+	 *
+	 * @param curr_step
+	 * @return the step, or -1 if the condition has already been met
+	 */
+	llint next_check_step(llint curr_step);
+
+	/// writes the values collected so far and whether the condition has already been met, in binary format
+	void write_state(std::ostream &out);
+	void read_state(std::istream &in);
+};
+
+#endif /* STOPCONDITION_H_ */
@@ -140,5 +140,22 @@ std::string StructureFactor<number>::get_output_string(llint curr_step) {
 	return ret.str();
 }
 
+template<typename number>
+void StructureFactor<number>::write_state(std::ostream &out) {
+	int size = _sq.size();
+	out.write((char *) &_nconf, sizeof(long int));
+	out.write((char *) &size, sizeof(int));
+	if(size > 0) out.write((char *) &_sq[0], size * sizeof(long double));
+}
+
+template<typename number>
+void StructureFactor<number>::read_state(std::istream &in) {
+	int size;
+	in.read((char *) &_nconf, sizeof(long int));
+	in.read((char *) &size, sizeof(int));
+	if(!in.good() || size != (int) _sq.size()) throw oxDNAException("StructureFactor: the state to be restored has %d bins, but the observable has %d", size, (int) _sq.size());
+	if(size > 0) in.read((char *) &_sq[0], size * sizeof(long double));
+}
+
 template class StructureFactor<float>;
 template class StructureFactor<double>;
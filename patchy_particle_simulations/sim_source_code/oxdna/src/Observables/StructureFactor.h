@@ -57,6 +57,10 @@ public:
 	void get_settings(input_file &my_inp, input_file &sim_inp);
 	virtual void init(ConfigInfo<number> &config_info);
 	virtual std::string get_output_string(llint curr_step);
+	virtual bool is_cumulative() { return !_always_reset; }
+
+	virtual void write_state(std::ostream &out);
+	virtual void read_state(std::istream &in);
 };
 
 #endif /* STRUCTUREFACTOR_H_ */
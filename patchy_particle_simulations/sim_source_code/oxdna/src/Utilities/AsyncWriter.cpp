@@ -0,0 +1,140 @@
+/*
+ * AsyncWriter.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+#include "AsyncWriter.h"
+#include "oxDNAException.h"
+#include "Utils.h"
+#include "Logger.h"
+#include "Timings.h"
+
+AsyncWriter::AsyncWriter(size_t max_buffered) : _max_buffered(max_buffered), _buffered(0), _busy(false), _stopping(false) {
+	_stalls = TimingManager::instance()->get_counter("Async output stalls");
+
+	pthread_mutex_init(&_mutex, NULL);
+	pthread_cond_init(&_job_queued, NULL);
+	pthread_cond_init(&_job_done, NULL);
+	if(pthread_create(&_thread, NULL, _thread_main, this) != 0) {
+		pthread_cond_destroy(&_job_done);
+		pthread_cond_destroy(&_job_queued);
+		pthread_mutex_destroy(&_mutex);
+		throw oxDNAException("Cannot start the asynchronous output thread");
+	}
+}
+
+AsyncWriter::~AsyncWriter() {
+	pthread_mutex_lock(&_mutex);
+	_stopping = true;
+	pthread_cond_signal(&_job_queued);
+	pthread_mutex_unlock(&_mutex);
+	pthread_join(_thread, NULL);
+
+	if(!_error.empty()) OX_LOG(Logger::LOG_WARNING, "%s", _error.c_str());
+
+	pthread_cond_destroy(&_job_done);
+	pthread_cond_destroy(&_job_queued);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void *AsyncWriter::_thread_main(void *arg) {
+	static_cast<AsyncWriter *>(arg)->_loop();
+	return NULL;
+}
+
+void AsyncWriter::_loop() {
+	pthread_mutex_lock(&_mutex);
+	while(true) {
+		while(_jobs.empty() && !_stopping) pthread_cond_wait(&_job_queued, &_mutex);
+		// whatever has been queued before the writer was stopped is written anyway
+		if(_jobs.empty()) break;
+
+		Job job;
+		std::swap(job.out, _jobs.front().out);
+		job.name.swap(_jobs.front().name);
+		job.data.swap(_jobs.front().data);
+		_jobs.pop_front();
+		_busy = true;
+		pthread_mutex_unlock(&_mutex);
+
+		std::string error = _write(job);
+
+		pthread_mutex_lock(&_mutex);
+		_busy = false;
+		_buffered -= job.data.size();
+		// only the first error is kept, since the following ones are likely to be a consequence of it
+		if(!error.empty() && _error.empty()) _error = error;
+		pthread_cond_broadcast(&_job_done);
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+std::string AsyncWriter::_write(Job &job) {
+	if(job.out != NULL) {
+		job.out->write(job.data.c_str(), job.data.size());
+		job.out->flush();
+		if(!job.out->good()) return Utils::sformat("Error while writing to '%s'", job.name.c_str());
+		return std::string("");
+	}
+
+	FILE *out = fopen(job.name.c_str(), "wb");
+	if(out == NULL) return Utils::sformat("Cannot open '%s' for writing: %s", job.name.c_str(), strerror(errno));
+	bool ok = (fwrite(job.data.c_str(), 1, job.data.size(), out) == job.data.size());
+	ok = (fclose(out) == 0) && ok;
+	if(!ok) return Utils::sformat("Error while writing to '%s'", job.name.c_str());
+	return std::string("");
+}
+
+void AsyncWriter::_push(Job &job) {
+	size_t size = job.data.size();
+
+	pthread_mutex_lock(&_mutex);
+	if(_buffered > 0 && _buffered + size > _max_buffered) {
+		_stalls->add();
+		while(_error.empty() && _buffered > 0 && _buffered + size > _max_buffered) pthread_cond_wait(&_job_done, &_mutex);
+	}
+	if(!_error.empty()) {
+		std::string error = _error;
+		pthread_mutex_unlock(&_mutex);
+		throw oxDNAException("%s", error.c_str());
+	}
+
+	_jobs.push_back(Job());
+	Job &queued = _jobs.back();
+	queued.out = job.out;
+	queued.name.swap(job.name);
+	queued.data.swap(job.data);
+	_buffered += size;
+	pthread_cond_signal(&_job_queued);
+	pthread_mutex_unlock(&_mutex);
+}
+
+void AsyncWriter::append(std::ostream *out, const std::string &name, const std::string &data) {
+	Job job;
+	job.out = out;
+	job.name = name;
+	job.data = data;
+	_push(job);
+}
+
+void AsyncWriter::overwrite(const std::string &name, const std::string &data) {
+	Job job;
+	job.name = name;
+	job.data = data;
+	_push(job);
+}
+
+void AsyncWriter::flush() {
+	pthread_mutex_lock(&_mutex);
+	while(_error.empty() && (_busy || !_jobs.empty())) pthread_cond_wait(&_job_done, &_mutex);
+	std::string error = _error;
+	pthread_mutex_unlock(&_mutex);
+
+	if(!error.empty()) throw oxDNAException("%s", error.c_str());
+}
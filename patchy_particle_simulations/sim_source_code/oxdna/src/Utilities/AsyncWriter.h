@@ -0,0 +1,100 @@
+/**
+ * @file    AsyncWriter.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef ASYNCWRITER_H_
+#define ASYNCWRITER_H_
+
+#include <string>
+#include <deque>
+#include <ostream>
+#include <pthread.h>
+
+class Counter;
+
+/**
+ * @brief Writes data to files on a background thread, so that the simulation does not have to wait for the file system.
+ *
+ * The data to be written is handed over as a whole (e.g. the already formatted output of an ObservableOutput) and
+ * queued. A background thread takes the queued jobs in order and either appends their data to an already open stream or
+ * replaces the content of a file with it. Jobs are processed in the order in which they are queued, so that the content of
+ * each file is the same as if it had been written synchronously.
+ *
+ * The queue is bounded: if the data waiting to be written exceeds the given size the thread queuing a new job blocks until
+ * enough data has been written (a job larger than the bound is accepted as soon as the queue is empty). The number of
+ * times this happens is stored in the "Async output stalls" counter.
+ *
+ * Errors that happen on the background thread are reported by the next call to a method that queues a job or to
+ * {@link flush}, which throw an oxDNAException.
+ */
+class AsyncWriter {
+protected:
+	struct Job {
+		/// stream the data should be appended to, or NULL if the data should replace the content of the file
+		std::ostream *out;
+		std::string name;
+		std::string data;
+
+		Job() : out(NULL) {}
+	};
+
+	size_t _max_buffered;
+	size_t _buffered;
+	std::deque<Job> _jobs;
+	/// true while the background thread is writing a job that has already been removed from the queue
+	bool _busy;
+	bool _stopping;
+	std::string _error;
+
+	pthread_t _thread;
+	pthread_mutex_t _mutex;
+	/// signalled when a job is queued or the writer is stopped
+	pthread_cond_t _job_queued;
+	/// signalled when a job has been written
+	pthread_cond_t _job_done;
+
+	Counter *_stalls;
+
+	static void *_thread_main(void *arg);
+	void _loop();
+	/// writes the job, returning an empty string on success and a description of the error otherwise
+	std::string _write(Job &job);
+	/// queues the job, swapping its data into the queue
+	void _push(Job &job);
+
+public:
+	/**
+	 * @brief Constructor. Starts the background thread.
+	 *
+	 * @param max_buffered maximum number of bytes waiting to be written
+	 */
+	AsyncWriter(size_t max_buffered);
+	/// Writes whatever is still queued and stops the background thread. Errors are logged rather than thrown
+	virtual ~AsyncWriter();
+
+	/**
+	 * @brief Queues data that will be appended to the given stream. The stream must stay open until the data has been written.
+	 *
+	 * @param out
+	 * @param name name of the file the stream writes to, used in error messages
+	 * @param data
+	 */
+	void append(std::ostream *out, const std::string &name, const std::string &data);
+
+	/**
+	 * @brief Queues data that will replace the content of the given file.
+	 *
+	 * @param name
+	 * @param data
+	 */
+	void overwrite(const std::string &name, const std::string &data);
+
+	/// Blocks until all the queued data has been written
+	void flush();
+};
+
+#endif /* ASYNCWRITER_H_ */
@@ -0,0 +1,440 @@
+/*
+ * CompressedTrajectory.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "CompressedTrajectory.h"
+#include "oxDNAException.h"
+#include "Logger.h"
+
+static const char frame_magic[4] = { 'O', 'X', 'T', 'F' };
+static const char index_magic[4] = { 'O', 'X', 'T', 'I' };
+
+// offsets of the fields of the header
+#define OFF_FLAGS 4
+#define OFF_STEP 8
+#define OFF_N 16
+#define OFF_BITS 20
+#define OFF_BOX 24
+#define OFF_U 48
+#define OFF_K 56
+#define OFF_PRECISION 64
+#define OFF_RAW_SIZE 72
+#define OFF_STORED_SIZE 76
+
+namespace CompressedTrajectory {
+
+template<typename T> static void _put(char *dest, T value) {
+	memcpy(dest, &value, sizeof(T));
+}
+
+template<typename T> static T _get(const char *src) {
+	T value;
+	memcpy(&value, src, sizeof(T));
+	return value;
+}
+
+static void _put_varint(std::string &out, unsigned long long value) {
+	while(value >= 0x80) {
+		out.push_back((char) ((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	out.push_back((char) value);
+}
+
+static unsigned long long _get_varint(const unsigned char *&data, const unsigned char *end) {
+	unsigned long long value = 0;
+	for(int shift = 0; shift < 64; shift += 7) {
+		if(data == end) throw oxDNAException("Compressed trajectory: truncated frame");
+		unsigned char byte = *data;
+		data++;
+		value |= (unsigned long long) (byte & 0x7F) << shift;
+		if(!(byte & 0x80)) return value;
+	}
+	throw oxDNAException("Compressed trajectory: malformed frame");
+}
+
+static unsigned long long _zigzag(long long value) {
+	return ((unsigned long long) value << 1) ^ (unsigned long long) (value >> 63);
+}
+
+static long long _unzigzag(unsigned long long value) {
+	return (long long) (value >> 1) ^ -(long long) (value & 1);
+}
+
+/// converts the rotation whose rows are m[0..2], m[3..5] and m[6..8] into a unit quaternion (w, x, y, z)
+static void _to_quaternion(const double *m, double *q) {
+	double trace = m[0] + m[4] + m[8];
+	if(trace > 0.) {
+		double s = 0.5 / sqrt(trace + 1.);
+		q[0] = 0.25 / s;
+		q[1] = (m[7] - m[5]) * s;
+		q[2] = (m[2] - m[6]) * s;
+		q[3] = (m[3] - m[1]) * s;
+	}
+	else if(m[0] > m[4] && m[0] > m[8]) {
+		double s = 2. * sqrt(1. + m[0] - m[4] - m[8]);
+		q[0] = (m[7] - m[5]) / s;
+		q[1] = 0.25 * s;
+		q[2] = (m[1] + m[3]) / s;
+		q[3] = (m[2] + m[6]) / s;
+	}
+	else if(m[4] > m[8]) {
+		double s = 2. * sqrt(1. + m[4] - m[0] - m[8]);
+		q[0] = (m[2] - m[6]) / s;
+		q[1] = (m[1] + m[3]) / s;
+		q[2] = 0.25 * s;
+		q[3] = (m[5] + m[7]) / s;
+	}
+	else {
+		double s = 2. * sqrt(1. + m[8] - m[0] - m[4]);
+		q[0] = (m[3] - m[1]) / s;
+		q[1] = (m[2] + m[6]) / s;
+		q[2] = (m[5] + m[7]) / s;
+		q[3] = 0.25 * s;
+	}
+
+	double norm = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+	for(int i = 0; i < 4; i++) q[i] /= norm;
+}
+
+static void _to_matrix(const double *q, double *m) {
+	double w = q[0], x = q[1], y = q[2], z = q[3];
+	m[0] = 1. - 2. * (y * y + z * z);
+	m[1] = 2. * (x * y - z * w);
+	m[2] = 2. * (x * z + y * w);
+	m[3] = 2. * (x * y + z * w);
+	m[4] = 1. - 2. * (x * x + z * z);
+	m[5] = 2. * (y * z - x * w);
+	m[6] = 2. * (x * z - y * w);
+	m[7] = 2. * (y * z + x * w);
+	m[8] = 1. - 2. * (x * x + y * y);
+}
+
+static unsigned long long _pack_quaternion(const double *q, int bits) {
+	int largest = 0;
+	for(int i = 1; i < 4; i++) {
+		if(fabs(q[i]) > fabs(q[largest])) largest = i;
+	}
+	// q and -q represent the same rotation, so that the largest component can always be taken as positive
+	double sign = (q[largest] < 0.) ? -1. : 1.;
+	long long max_value = (1LL << bits) - 1;
+
+	unsigned long long packed = largest;
+	for(int i = 0; i < 4; i++) {
+		if(i == largest) continue;
+		// the other components are bound to [-1/sqrt(2), 1/sqrt(2)]
+		double scaled = 0.5 * (sign * q[i] / M_SQRT1_2 + 1.);
+		long long value = llround(scaled * max_value);
+		if(value < 0) value = 0;
+		if(value > max_value) value = max_value;
+		packed = (packed << bits) | (unsigned long long) value;
+	}
+	return packed;
+}
+
+static void _unpack_quaternion(unsigned long long packed, int bits, double *q) {
+	unsigned long long mask = (1ULL << bits) - 1;
+	double max_value = (double) mask;
+	double values[3];
+	for(int j = 2; j >= 0; j--) {
+		values[j] = (2. * (packed & mask) / max_value - 1.) * M_SQRT1_2;
+		packed >>= bits;
+	}
+	int largest = (int) packed;
+	if(largest > 3) throw oxDNAException("Compressed trajectory: malformed orientation");
+
+	double sum = 0.;
+	for(int i = 0, j = 0; i < 4; i++) {
+		if(i == largest) continue;
+		q[i] = values[j++];
+		sum += q[i] * q[i];
+	}
+	q[largest] = (sum < 1.) ? sqrt(1. - sum) : 0.;
+}
+
+std::string encode_frame(const TrajectoryFrame &frame, const Settings &settings) {
+	int N = frame.N();
+	int bits = settings.orientation_bits;
+	if(bits < 8 || bits > 20) throw oxDNAException("Compressed trajectory: the number of bits per orientation component should be between 8 and 20 (got %d)", bits);
+	if(settings.position_precision <= 0.) throw oxDNAException("Compressed trajectory: the position precision should be larger than 0");
+	bool velocities = settings.velocities && !frame.vel.empty();
+
+	std::string raw;
+	raw.reserve(N * (3 * 3 + 8) + (velocities ? 24 * N : 0));
+
+	long long previous[3] = { 0, 0, 0 };
+	for(int i = 0; i < 3 * N; i++) {
+		double scaled = frame.pos[i] / settings.position_precision;
+		if(!(fabs(scaled) < 4.e18)) throw oxDNAException("Compressed trajectory: the position %lf of particle %d cannot be stored with precision %g", frame.pos[i], i / 3, settings.position_precision);
+		long long value = llround(scaled);
+		_put_varint(raw, _zigzag(value - previous[i % 3]));
+		previous[i % 3] = value;
+	}
+
+	for(int i = 0; i < N; i++) {
+		double q[4];
+		_to_quaternion(&frame.orientation[9 * i], q);
+		_put_varint(raw, _pack_quaternion(q, bits));
+	}
+
+	if(velocities) {
+		for(int i = 0; i < 6 * N; i++) {
+			float value = (float) frame.vel[i];
+			raw.append((char *) &value, sizeof(float));
+		}
+	}
+
+	unsigned int flags = velocities ? FLAG_VELOCITIES : 0;
+	std::string payload;
+#ifdef HAVE_ZLIB
+	if(settings.compression_level > 0) {
+		uLongf compressed_size = compressBound(raw.size());
+		payload.resize(compressed_size);
+		int res = compress2((Bytef *) &payload[0], &compressed_size, (const Bytef *) raw.data(), raw.size(), settings.compression_level);
+		if(res != Z_OK) throw oxDNAException("Compressed trajectory: zlib error %d", res);
+		payload.resize(compressed_size);
+		// incompressible payloads are stored as they are
+		if(payload.size() < raw.size()) flags |= FLAG_ZLIB;
+	}
+#endif
+	if(!(flags & FLAG_ZLIB)) payload.swap(raw);
+
+	std::string out(HEADER_SIZE, '\0');
+	memcpy(&out[0], frame_magic, 4);
+	_put<unsigned int>(&out[OFF_FLAGS], flags);
+	_put<llint>(&out[OFF_STEP], frame.step);
+	_put<int>(&out[OFF_N], N);
+	_put<int>(&out[OFF_BITS], bits);
+	for(int d = 0; d < 3; d++) _put<double>(&out[OFF_BOX + d * sizeof(double)], frame.box[d]);
+	_put<double>(&out[OFF_U], frame.U);
+	_put<double>(&out[OFF_K], frame.K);
+	_put<double>(&out[OFF_PRECISION], settings.position_precision);
+	_put<unsigned int>(&out[OFF_RAW_SIZE], (flags & FLAG_ZLIB) ? raw.size() : payload.size());
+	_put<unsigned int>(&out[OFF_STORED_SIZE], payload.size());
+	out += payload;
+
+	return out;
+}
+
+size_t frame_size(const char *header, llint *step) {
+	if(memcmp(header, frame_magic, 4) != 0) return 0;
+	*step = _get<llint>(header + OFF_STEP);
+	return HEADER_SIZE + (size_t) _get<unsigned int>(header + OFF_STORED_SIZE);
+}
+
+void decode_frame(const char *data, size_t size, TrajectoryFrame &frame) {
+	llint step;
+	if(size < (size_t) HEADER_SIZE || frame_size(data, &step) == 0) throw oxDNAException("Compressed trajectory: invalid frame header");
+	if(frame_size(data, &step) > size) throw oxDNAException("Compressed trajectory: truncated frame");
+
+	unsigned int flags = _get<unsigned int>(data + OFF_FLAGS);
+	int N = _get<int>(data + OFF_N);
+	int bits = _get<int>(data + OFF_BITS);
+	double precision = _get<double>(data + OFF_PRECISION);
+	unsigned int raw_size = _get<unsigned int>(data + OFF_RAW_SIZE);
+	unsigned int stored_size = _get<unsigned int>(data + OFF_STORED_SIZE);
+	if(N < 0 || bits < 8 || bits > 20) throw oxDNAException("Compressed trajectory: invalid frame header");
+
+	frame.step = step;
+	for(int d = 0; d < 3; d++) frame.box[d] = _get<double>(data + OFF_BOX + d * sizeof(double));
+	frame.U = _get<double>(data + OFF_U);
+	frame.K = _get<double>(data + OFF_K);
+
+	const unsigned char *payload = (const unsigned char *) data + HEADER_SIZE;
+	std::vector<unsigned char> raw;
+	if(flags & FLAG_ZLIB) {
+#ifdef HAVE_ZLIB
+		raw.resize(raw_size);
+		uLongf dest_size = raw_size;
+		int res = uncompress(&raw[0], &dest_size, payload, stored_size);
+		if(res != Z_OK || dest_size != raw_size) throw oxDNAException("Compressed trajectory: cannot decompress frame at step %lld (zlib error %d)", step, res);
+		payload = &raw[0];
+#else
+		throw oxDNAException("Compressed trajectory: the frame at step %lld is compressed with zlib, but oxDNA has been compiled without zlib support", step);
+#endif
+	}
+	const unsigned char *end = payload + raw_size;
+
+	frame.pos.resize(3 * N);
+	long long previous[3] = { 0, 0, 0 };
+	for(int i = 0; i < 3 * N; i++) {
+		previous[i % 3] += _unzigzag(_get_varint(payload, end));
+		frame.pos[i] = previous[i % 3] * precision;
+	}
+
+	frame.orientation.resize(9 * N);
+	for(int i = 0; i < N; i++) {
+		double q[4];
+		_unpack_quaternion(_get_varint(payload, end), bits, q);
+		_to_matrix(q, &frame.orientation[9 * i]);
+	}
+
+	if(flags & FLAG_VELOCITIES) {
+		if(end - payload < (long) (6 * N * sizeof(float))) throw oxDNAException("Compressed trajectory: truncated frame");
+		frame.vel.resize(6 * N);
+		for(int i = 0; i < 6 * N; i++) {
+			frame.vel[i] = _get<float>((const char *) payload);
+			payload += sizeof(float);
+		}
+	}
+	else frame.vel.clear();
+}
+
+bool is_compressed_trajectory(const std::string &filename) {
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	char magic[4];
+	in.read(magic, 4);
+	return in.good() && memcmp(magic, frame_magic, 4) == 0;
+}
+
+}
+
+using namespace CompressedTrajectory;
+
+CompressedTrajectoryReader::CompressedTrajectoryReader(const std::string &filename, bool use_index_file) : _filename(filename), _indexed_size(0), _next(0) {
+	_input.open(filename.c_str(), std::ios::binary);
+	if(!_input.good()) throw oxDNAException("Cannot open the compressed trajectory '%s'", filename.c_str());
+
+	bool loaded = use_index_file && _load_index();
+	bool found = _scan();
+	if(use_index_file && (found || !loaded)) _save_index();
+}
+
+CompressedTrajectoryReader::~CompressedTrajectoryReader() {
+
+}
+
+bool CompressedTrajectoryReader::_load_index() {
+	std::string name = _filename + ".idx";
+	std::ifstream in(name.c_str(), std::ios::binary);
+	if(!in.good()) return false;
+
+	char magic[4];
+	llint indexed_size, N_frames;
+	in.read(magic, 4);
+	in.read((char *) &indexed_size, sizeof(llint));
+	in.read((char *) &N_frames, sizeof(llint));
+	if(!in.good() || memcmp(magic, index_magic, 4) != 0 || N_frames < 0) return false;
+
+	std::vector<llint> offsets(N_frames), steps(N_frames);
+	for(llint i = 0; i < N_frames; i++) {
+		in.read((char *) &offsets[i], sizeof(llint));
+		in.read((char *) &steps[i], sizeof(llint));
+	}
+	if(!in.good()) return false;
+
+	// the index is used only if it still matches the trajectory, whose last indexed frame should be where the index says
+	_input.seekg(0, std::ios::end);
+	llint file_size = _input.tellg();
+	if(indexed_size > file_size) return false;
+	if(N_frames > 0) {
+		char header[HEADER_SIZE];
+		llint step;
+		_input.seekg(offsets.back());
+		_input.read(header, HEADER_SIZE);
+		if(!_input.good() || frame_size(header, &step) == 0 || step != steps.back()) {
+			_input.clear();
+			return false;
+		}
+	}
+
+	_offsets.swap(offsets);
+	_steps.swap(steps);
+	_indexed_size = indexed_size;
+	OX_DEBUG("Loaded the index of '%s' (%lld frames)", _filename.c_str(), N_frames);
+	return true;
+}
+
+void CompressedTrajectoryReader::_save_index() {
+	std::string name = _filename + ".idx";
+	std::ofstream out(name.c_str(), std::ios::binary);
+	llint N_frames = _offsets.size();
+	out.write(index_magic, 4);
+	out.write((char *) &_indexed_size, sizeof(llint));
+	out.write((char *) &N_frames, sizeof(llint));
+	for(llint i = 0; i < N_frames; i++) {
+		out.write((char *) &_offsets[i], sizeof(llint));
+		out.write((char *) &_steps[i], sizeof(llint));
+	}
+	out.close();
+	if(out.fail()) {
+		OX_DEBUG("Cannot write the index file '%s'", name.c_str());
+		remove(name.c_str());
+	}
+}
+
+bool CompressedTrajectoryReader::_scan() {
+	_input.clear();
+	_input.seekg(0, std::ios::end);
+	llint file_size = _input.tellg();
+
+	bool found = false;
+	llint offset = _indexed_size;
+	while(offset + HEADER_SIZE <= file_size) {
+		char header[HEADER_SIZE];
+		_input.seekg(offset);
+		_input.read(header, HEADER_SIZE);
+		llint step;
+		size_t size = frame_size(header, &step);
+		if(!_input.good() || size == 0) throw oxDNAException("Compressed trajectory '%s': invalid frame found at byte %lld", _filename.c_str(), offset);
+		// a frame that has not been completely written yet
+		if(offset + (llint) size > file_size) break;
+
+		_offsets.push_back(offset);
+		_steps.push_back(step);
+		offset += size;
+		found = true;
+
+		// frames printed through an ObservableOutput are followed by a newline
+		if(offset < file_size) {
+			_input.seekg(offset);
+			if(_input.peek() == '\n') offset++;
+		}
+	}
+	_indexed_size = offset;
+	_input.clear();
+
+	return found;
+}
+
+void CompressedTrajectoryReader::seek(int frame) {
+	if(frame < 0 || frame > N_frames()) throw oxDNAException("Compressed trajectory '%s': cannot seek frame %d, since the trajectory contains %d frames", _filename.c_str(), frame, N_frames());
+	_next = frame;
+}
+
+void CompressedTrajectoryReader::read_frame(int frame, TrajectoryFrame &out) {
+	if(frame < 0 || frame >= N_frames()) throw oxDNAException("Compressed trajectory '%s': cannot read frame %d, since the trajectory contains %d frames", _filename.c_str(), frame, N_frames());
+
+	char header[HEADER_SIZE];
+	llint step;
+	_input.clear();
+	_input.seekg(_offsets[frame]);
+	_input.read(header, HEADER_SIZE);
+	size_t size = frame_size(header, &step);
+	if(!_input.good() || size == 0) throw oxDNAException("Compressed trajectory '%s': invalid frame %d", _filename.c_str(), frame);
+
+	_buffer.resize(size);
+	memcpy(&_buffer[0], header, HEADER_SIZE);
+	_input.read(&_buffer[HEADER_SIZE], size - HEADER_SIZE);
+	if(!_input.good()) throw oxDNAException("Compressed trajectory '%s': truncated frame %d", _filename.c_str(), frame);
+
+	decode_frame(&_buffer[0], size, out);
+}
+
+bool CompressedTrajectoryReader::read_next(TrajectoryFrame &out) {
+	if(_next >= N_frames()) return false;
+	read_frame(_next, out);
+	_next++;
+	return true;
+}
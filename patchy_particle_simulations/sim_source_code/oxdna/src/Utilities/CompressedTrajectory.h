@@ -0,0 +1,153 @@
+/**
+ * @file    CompressedTrajectory.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef COMPRESSEDTRAJECTORY_H_
+#define COMPRESSEDTRAJECTORY_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "../defs.h"
+
+/**
+ * @brief A configuration, stored in double precision regardless of the precision of the simulation.
+ */
+struct TrajectoryFrame {
+	llint step;
+	double box[3];
+	double U, K;
+	/// absolute positions, 3 values per particle
+	std::vector<double> pos;
+	/// v1, v2 and v3 of the transposed orientation matrix, 9 values per particle
+	std::vector<double> orientation;
+	/// velocities and angular momenta, 6 values per particle. Empty if they have not been stored
+	std::vector<double> vel;
+
+	TrajectoryFrame() : step(0), U(0.), K(0.) {
+		box[0] = box[1] = box[2] = 0.;
+	}
+
+	int N() const { return pos.size() / 3; }
+};
+
+/**
+ * @brief Encodes and decodes the frames of compressed trajectories.
+ *
+ * Each frame is a self-contained record made of a fixed-size header followed by a payload. The header contains a magic
+ * string, the step, the number of particles, the box, the energies and the parameters required to decode the payload.
+ * Positions are quantised with a given absolute precision and stored as differences between consecutive particles,
+ * encoded as variable-length integers. Orientations are converted to unit quaternions and stored with the "smallest
+ * three" scheme: the index of the largest component and the other three components, quantised with a given number of
+ * bits each. Velocities and angular momenta, if stored, are kept in single precision. The payload is then compressed with
+ * zlib, if oxDNA has been compiled with zlib support.
+ *
+ * Since frames do not depend on each other, a trajectory is simply a sequence of frames, it can be appended to (e.g. by a
+ * restarted simulation) and each frame can be decoded without decoding the previous ones. Multi-byte values are stored
+ * in native byte order, as in the other binary files written by oxDNA.
+ */
+namespace CompressedTrajectory {
+
+/// size of the header of each frame, in bytes
+const int HEADER_SIZE = 80;
+
+enum {
+	FLAG_ZLIB = 1,
+	FLAG_VELOCITIES = 2
+};
+
+struct Settings {
+	/// absolute precision of the positions
+	double position_precision;
+	/// number of bits used to store each of the three quaternion components (between 8 and 20)
+	int orientation_bits;
+	bool velocities;
+	/// zlib compression level (0 means no compression)
+	int compression_level;
+
+	Settings() : position_precision(1e-5), orientation_bits(16), velocities(false), compression_level(1) {}
+};
+
+/**
+ * @brief Encodes the given frame.
+ *
+ * @param frame
+ * @param settings
+ * @return the encoded frame, header included
+ */
+std::string encode_frame(const TrajectoryFrame &frame, const Settings &settings);
+
+/**
+ * @brief Decodes a frame encoded by {@link encode_frame}.
+ *
+ * @param data pointer to the beginning of the header
+ * @param size number of bytes available from data on
+ * @param frame
+ */
+void decode_frame(const char *data, size_t size, TrajectoryFrame &frame);
+
+/**
+ * @brief Parses the header of a frame.
+ *
+ * @param header the first HEADER_SIZE bytes of the frame
+ * @param step set to the step of the frame
+ * @return the size of the whole frame, or 0 if the header is not valid
+ */
+size_t frame_size(const char *header, llint *step);
+
+/// Returns true if the file exists and starts with a compressed frame
+bool is_compressed_trajectory(const std::string &filename);
+
+}
+
+/**
+ * @brief Gives random access to the frames of a compressed trajectory.
+ *
+ * The offsets of the frames are found by reading their headers only, and are stored in '\<trajectory\>.idx', so that
+ * they do not have to be found again the next time the trajectory is opened. The index file is updated if the trajectory
+ * has grown in the meantime, and rebuilt from scratch if it does not match the trajectory. Failing to write it is not an
+ * error. A frame that has not been completely written yet (e.g. because the simulation is still running) is ignored.
+ */
+class CompressedTrajectoryReader {
+protected:
+	std::string _filename;
+	std::ifstream _input;
+	std::vector<llint> _offsets;
+	std::vector<llint> _steps;
+	/// offset of the first byte that follows the last indexed frame
+	llint _indexed_size;
+	int _next;
+	std::vector<char> _buffer;
+
+	bool _load_index();
+	void _save_index();
+	/// indexes the frames that follow _indexed_size, returns true if any was found
+	bool _scan();
+
+public:
+	/**
+	 * @brief Constructor. Opens the trajectory and indexes its frames.
+	 *
+	 * @param filename
+	 * @param use_index_file whether the index should be read from and written to the index file
+	 */
+	CompressedTrajectoryReader(const std::string &filename, bool use_index_file=true);
+	virtual ~CompressedTrajectoryReader();
+
+	int N_frames() const { return _offsets.size(); }
+	llint step(int frame) const { return _steps[frame]; }
+	llint offset(int frame) const { return _offsets[frame]; }
+
+	/// Sets the frame returned by the next call to {@link read_next}
+	void seek(int frame);
+	void read_frame(int frame, TrajectoryFrame &out);
+	/// Reads the next frame, returning false if there are no more frames
+	bool read_next(TrajectoryFrame &out);
+};
+
+#endif /* COMPRESSEDTRAJECTORY_H_ */
@@ -8,6 +8,7 @@
 #include "ConfigInfo.h"
 
 #include "oxDNAException.h"
+#include "RandomManager.h"
 
 template<typename number>
 ConfigInfo<number> *ConfigInfo<number>::_config_info = NULL;
@@ -20,7 +21,9 @@ ConfigInfo<number>::ConfigInfo() :
 				backend_info(NULL),
 				lists(NULL),
 				box(NULL),
-				curr_step(0) {
+				rng(NULL),
+				curr_step(0),
+				system_energy(NULL) {
 
 }
 
@@ -44,6 +47,7 @@ void ConfigInfo<number>::init() {
 	if(_config_info != NULL) throw oxDNAException("The ConfigInfo object have been already initialised");
 
 	_config_info = new ConfigInfo();
+	_config_info->rng = RandomManager::instance();
 }
 
 template<typename number>
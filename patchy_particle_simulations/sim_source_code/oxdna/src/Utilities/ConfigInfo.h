@@ -18,6 +18,7 @@ template <typename number> class IBaseInteraction;
 template <typename number> class BaseParticle;
 template <typename number> class BaseList;
 template <typename number> class BaseBox;
+class RandomManager;
 
 /**
  * @brief Utility class. It is used by observables to have access to SimBackend's private members.
@@ -84,8 +85,14 @@ public:
 	/// Pointer to box object
 	BaseBox<number> *box;
 
+	/// Pointer to the random number generators
+	RandomManager *rng;
+
 	/// Current simulation step
 	long long int curr_step;
+
+	/// If not NULL, the potential energy of the system, which the backend keeps up to date while the observables are being printed
+	number *system_energy;
 };
 
 template<typename number>
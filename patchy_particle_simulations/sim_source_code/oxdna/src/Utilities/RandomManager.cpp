@@ -0,0 +1,113 @@
+/*
+ * RandomManager.cpp
+ *
+ *  Created on: 17/oct/2026
+ *      Author: petr
+ */
+
+#include "RandomManager.h"
+
+#include "Logger.h"
+
+// the ids of the streams returned by make_stream start from here, so that they never coincide with the ids of the
+// streams used by the threads
+#define RNG_FIRST_EXTRA_STREAM (1ULL << 32)
+
+RandomManager *RandomManager::_random_manager = NULL;
+
+RandomManager::RandomManager() :
+				_philox(false),
+				_seed(0),
+				_replica(0) {
+	set_N_threads(1);
+}
+
+RandomManager::~RandomManager() {
+
+}
+
+void RandomManager::init() {
+	if(_random_manager != NULL) throw oxDNAException("initializing an already initialized RandomManager");
+	_random_manager = new RandomManager();
+}
+
+void RandomManager::clear() {
+	if(_random_manager != NULL) delete _random_manager;
+	_random_manager = NULL;
+}
+
+RandomManager *RandomManager::instance() {
+	if(_random_manager == NULL) throw oxDNAException("accessing uninitialized RandomManager");
+	return _random_manager;
+}
+
+void RandomManager::get_settings(input_file &inp) {
+	std::string rng_type("drand48");
+	getInputString(&inp, "rng_type", rng_type, 0);
+	if(rng_type == "drand48") _philox = false;
+	else if(rng_type == "philox") _philox = true;
+	else throw oxDNAException("Unsupported rng_type '%s' (should be either drand48 or philox)", rng_type.c_str());
+
+	for(int t = 0; t < (int) _streams.size(); t++) _init_stream(t);
+	OX_LOG(Logger::LOG_INFO, "Using the %s random number generator", rng_type.c_str());
+}
+
+void RandomManager::_init_stream(int thread) {
+	_streams[thread].init(_key(), thread);
+	if(thread == 0 && !_philox) _streams[thread].bind_to_drand48();
+}
+
+void RandomManager::seed(long s) {
+	srand48(s + _replica);
+	_seed = (uint64_t) s;
+	for(int t = 0; t < (int) _streams.size(); t++) _init_stream(t);
+}
+
+void RandomManager::set_replica(int replica) {
+	if(replica < 0) throw oxDNAException("The replica id should be non-negative");
+	_replica = replica;
+	seed((long) _seed);
+}
+
+void RandomManager::set_N_threads(int N) {
+	if(N < 1) throw oxDNAException("The number of threads drawing random numbers should be larger than 0");
+	int old_N = _streams.size();
+	_streams.resize(N);
+	for(int t = old_N; t < N; t++) _init_stream(t);
+}
+
+RandomStream RandomManager::make_stream(uint64_t id) {
+	RandomStream new_stream;
+	new_stream.init(_key(), RNG_FIRST_EXTRA_STREAM + id);
+	return new_stream;
+}
+
+void RandomManager::write_state(std::ostream &out) {
+	int N = _streams.size();
+	out.write((char *) &_seed, sizeof(uint64_t));
+	out.write((char *) &N, sizeof(int));
+	for(int t = 0; t < N; t++) {
+		uint64_t position = _streams[t].get_position();
+		out.write((char *) &position, sizeof(uint64_t));
+	}
+}
+
+void RandomManager::read_state(std::istream &in, bool restore) {
+	uint64_t seed;
+	int N;
+	in.read((char *) &seed, sizeof(uint64_t));
+	in.read((char *) &N, sizeof(int));
+	if(!in.good() || N < 1) throw oxDNAException("Malformed random number generator state");
+
+	std::vector<uint64_t> positions(N);
+	in.read((char *) &positions[0], N * sizeof(uint64_t));
+	if(!in.good()) throw oxDNAException("Malformed random number generator state");
+	if(!restore) return;
+
+	_seed = seed;
+	for(int t = 0; t < (int) _streams.size(); t++) {
+		_init_stream(t);
+		if(t < N && !_streams[t].is_bound_to_drand48()) _streams[t].seek(positions[t]);
+	}
+	if(N != (int) _streams.size()) OX_LOG(Logger::LOG_WARNING, "The random number generator state contains %d streams, but %d threads are in use: the streams of the extra threads will start from scratch", N, (int) _streams.size());
+}
@@ -0,0 +1,152 @@
+/**
+ * @file    RandomManager.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef RANDOMMANAGER_H_
+#define RANDOMMANAGER_H_
+
+#include <vector>
+#include <iostream>
+
+#include "RandomStream.h"
+#include "parse_input/parse_input.h"
+
+#ifdef HAVE_OPENMP
+#include <omp.h>
+#endif
+
+/**
+ * @brief Singleton that provides the random numbers used by the simulation.
+ *
+ * Each thread draws its numbers from its own RandomStream, so that OpenMP threads never share any generator state.
+ * More streams, independent of the ones used by the threads (e.g. for replicas or for the domains of a checkerboard
+ * sweep), can be obtained with make_stream().
+ *
+ * With rng_type = drand48 (the default) the stream of the master thread is bound to drand48(), so that simulations
+ * give the same results they gave before the streams were introduced. With rng_type = philox all the streams are
+ * counter-based and their state can be saved and restored exactly with write_state() and read_state(). Binary
+ * configurations written with rng_type = philox store this state right after the state of drand48(), and hence can only
+ * be read back with rng_type = philox. In both cases drand48() is seeded with the same seed, so that the code that still
+ * calls it directly stays reproducible.
+ *
+ * Processes that run replicas of the same system (e.g. the MPI processes of a parallel tempering simulation) are
+ * started with the same seed, and should call set_replica() so that each replica draws different numbers. The replica
+ * id is added to the seed of drand48() and is used as the upper half of the key of the counter-based streams. Replica 0
+ * draws the same numbers as a process that never calls set_replica().
+ *
+ * @verbatim
+[rng_type = drand48|philox (generator used by the random number streams, defaults to drand48)]
+@endverbatim
+ */
+class RandomManager {
+private:
+	static RandomManager *_random_manager;
+
+	/// one stream per thread
+	std::vector<RandomStream> _streams;
+	bool _philox;
+	uint64_t _seed;
+	int _replica;
+
+	/**
+	 * @brief Default constructor. It is kept private to enforce the singleton pattern.
+	 */
+	RandomManager();
+
+	/**
+	 * @brief Copy constructor. It is kept private to enforce the singleton pattern.
+	 */
+	RandomManager(RandomManager const&) {
+	}
+
+	void _init_stream(int thread);
+
+	/// returns the key of the counter-based streams, which depends on both the seed and the replica id
+	uint64_t _key() {
+		return _seed ^ ((uint64_t) _replica << 32);
+	}
+
+public:
+	virtual ~RandomManager();
+
+	/// singleton
+	static RandomManager *instance();
+
+	/// init function
+	static void init();
+
+	/// clear function
+	static void clear();
+
+	void get_settings(input_file &inp);
+
+	/// seeds drand48() and restarts all the streams
+	void seed(long s);
+
+	/// makes drand48() and all the streams depend on the given replica id, and restarts them
+	void set_replica(int replica);
+
+	int get_replica() {
+		return _replica;
+	}
+
+	/// sets the number of threads that will draw random numbers at the same time
+	void set_N_threads(int N);
+
+	int get_N_threads() {
+		return _streams.size();
+	}
+
+	bool is_philox() {
+		return _philox;
+	}
+
+	/// returns the stream of the calling thread
+	RandomStream &stream() {
+#ifdef HAVE_OPENMP
+		if(omp_in_parallel()) return _streams[omp_get_thread_num()];
+#endif
+		return _streams[0];
+	}
+
+	/// returns a random number uniformly distributed in [0, 1), drawn from the stream of the calling thread
+	double uniform() {
+		return stream().uniform();
+	}
+
+	/// fills out with n random numbers uniformly distributed in [0, 1), drawn from the stream of the calling thread
+	void fill_uniform(double *out, int n) {
+		stream().fill_uniform(out, n);
+	}
+
+	/**
+	 * @brief Returns a new counter-based stream. Streams created with different ids are independent of each other and
+	 * of the streams used by the threads.
+	 *
+	 * @param id
+	 * @return
+	 */
+	RandomStream make_stream(uint64_t id);
+
+	/**
+	 * @brief Writes the state of the thread streams, in binary format. Only the counter-based streams have a state to
+	 * be saved: the state of drand48() is stored by the configurations themselves.
+	 *
+	 * @param out
+	 */
+	void write_state(std::ostream &out);
+
+	/**
+	 * @brief Reads the state written by write_state.
+	 *
+	 * @param in
+	 * @param restore if false the state is read and discarded
+	 */
+	void read_state(std::istream &in, bool restore=true);
+};
+
+#endif /* RANDOMMANAGER_H_ */
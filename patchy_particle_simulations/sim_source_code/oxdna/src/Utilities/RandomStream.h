@@ -0,0 +1,142 @@
+/**
+ * @file    RandomStream.h
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ *
+ */
+
+#ifndef RANDOMSTREAM_H_
+#define RANDOMSTREAM_H_
+
+#include <cstdlib>
+#include <stdint.h>
+
+#include "oxDNAException.h"
+
+/**
+ * @brief An independent, seekable stream of uniformly distributed random numbers.
+ *
+ * The numbers are generated by the counter-based Philox4x32-10 generator (J. K. Salmon et al., "Parallel random
+ * numbers: as easy as 1, 2, 3", SC11 (2011)): the k-th block of random bits of a stream is a bijective function of the
+ * seed, which is used as the key, and of a counter made of the id of the stream and of k. As a consequence, streams
+ * with different ids never overlap, each position of a stream can be reached in constant time with seek(), and the
+ * state of a stream is completely given by its seed, id and position. Each block gives two uniform numbers with 53
+ * random bits each.
+ *
+ * A stream can also be bound to drand48(), in which case it simply forwards all the calls to it. Such a stream cannot be
+ * seeked and its state is the state of drand48().
+ */
+class RandomStream {
+protected:
+	uint64_t _seed;
+	uint64_t _id;
+	/// number of random numbers drawn since the beginning of the stream
+	uint64_t _position;
+	bool _drand48;
+	/// the two numbers of the block that contains the current position
+	double _block[2];
+
+	/// computes the two numbers of the given block
+	void _generate(uint64_t block) {
+		uint32_t ctr[4] = { (uint32_t) block, (uint32_t) (block >> 32), (uint32_t) _id, (uint32_t) (_id >> 32) };
+		uint32_t key[2] = { (uint32_t) _seed, (uint32_t) (_seed >> 32) };
+		philox4x32(ctr, key);
+
+		// 53 random bits per number, so that all the doubles in [0, 1) with that resolution are possible
+		const double norm = 1. / 9007199254740992.;
+		_block[0] = ((((uint64_t) ctr[0] << 32) | ctr[1]) >> 11) * norm;
+		_block[1] = ((((uint64_t) ctr[2] << 32) | ctr[3]) >> 11) * norm;
+	}
+
+public:
+	RandomStream() : _seed(0), _id(0), _position(0), _drand48(false) {
+		_block[0] = _block[1] = 0.;
+	}
+
+	/**
+	 * @brief Applies the ten rounds of the Philox4x32 bijection to ctr, using the given key.
+	 */
+	static void philox4x32(uint32_t ctr[4], const uint32_t key[2]) {
+		uint32_t k0 = key[0], k1 = key[1];
+		for(int round = 0; round < 10; round++) {
+			uint64_t p0 = (uint64_t) 0xD2511F53U * ctr[0];
+			uint64_t p1 = (uint64_t) 0xCD9E8D57U * ctr[2];
+			uint32_t new_ctr[4] = { (uint32_t) (p1 >> 32) ^ ctr[1] ^ k0, (uint32_t) p1, (uint32_t) (p0 >> 32) ^ ctr[3] ^ k1, (uint32_t) p0 };
+			for(int i = 0; i < 4; i++) ctr[i] = new_ctr[i];
+			k0 += 0x9E3779B9U;
+			k1 += 0xBB67AE85U;
+		}
+	}
+
+	/// (re)starts the stream with the given seed and id
+	void init(uint64_t seed, uint64_t id) {
+		_seed = seed;
+		_id = id;
+		_drand48 = false;
+		seek(0);
+	}
+
+	/// binds the stream to drand48()
+	void bind_to_drand48() {
+		_drand48 = true;
+	}
+
+	bool is_bound_to_drand48() const {
+		return _drand48;
+	}
+
+	uint64_t get_seed() const {
+		return _seed;
+	}
+
+	uint64_t get_id() const {
+		return _id;
+	}
+
+	uint64_t get_position() const {
+		return _position;
+	}
+
+	/// moves the stream so that the next number will be the one with the given index
+	void seek(uint64_t position) {
+		if(_drand48) throw oxDNAException("A random stream bound to drand48() cannot be seeked");
+		_position = position;
+		if(_position & 1) _generate(_position >> 1);
+	}
+
+	/// returns a random number uniformly distributed in [0, 1)
+	double uniform() {
+		if(_drand48) return drand48();
+		int offset = _position & 1;
+		if(offset == 0) _generate(_position >> 1);
+		_position++;
+		return _block[offset];
+	}
+
+	/**
+	 * @brief Fills out with n random numbers uniformly distributed in [0, 1). They are the same numbers that n calls to
+	 * uniform() would return, but whole blocks are generated at once.
+	 */
+	void fill_uniform(double *out, int n) {
+		if(_drand48) {
+			for(int i = 0; i < n; i++) out[i] = drand48();
+			return;
+		}
+
+		int i = 0;
+		if((_position & 1) && n > 0) {
+			out[i++] = _block[1];
+			_position++;
+		}
+		for(; i + 1 < n; i += 2) {
+			_generate(_position >> 1);
+			out[i] = _block[0];
+			out[i + 1] = _block[1];
+			_position += 2;
+		}
+		if(i < n) out[i] = uniform();
+	}
+};
+
+#endif /* RANDOMSTREAM_H_ */
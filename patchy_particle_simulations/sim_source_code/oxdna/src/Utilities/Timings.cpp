@@ -8,8 +8,10 @@
 #include "Timings.h"
 #include "oxDNAException.h"
 #include "Logger.h"
+#include "Utils.h"
 
 #include <algorithm>
+#include <sys/time.h>
 
 #ifdef NOCUDA
 #define SYNCHRONIZE()
@@ -65,11 +67,19 @@ long long int Timer::get_time() {
 
 /***************** END OF TIMER CLASS *********************/
 
+Counter::Counter(std::string desc) : _desc(desc), _value(0), _active(false) {
+
+}
+
+Counter::~Counter() {
+
+}
+
 // singleton
 TimingManager * TimingManager::_timingManager = NULL;
 
 // time manager class
-TimingManager::TimingManager() {
+TimingManager::TimingManager() : _telemetry_every(0), _telemetry_start(0.) {
 
 }
 
@@ -80,6 +90,8 @@ TimingManager::~TimingManager() {
 			delete _timers[i];
 		}
 	}
+	for(unsigned int i = 0; i < _counters.size(); i++) delete _counters[i];
+	if(_telemetry.is_open()) _telemetry.close();
 }
 
 void TimingManager::init() {
@@ -102,6 +114,63 @@ void TimingManager::add_timer(Timer * arg) {
 	_desc_map.insert(std::make_pair(arg->get_desc(), arg));
 }
 
+Counter * TimingManager::get_counter(std::string desc) {
+	std::map<std::string, Counter *>::iterator it = _counter_map.find(desc);
+	if(it != _counter_map.end()) return it->second;
+
+	Counter * counter = new Counter(desc);
+	counter->set_active(telemetry_enabled());
+	_counters.push_back(counter);
+	_counter_map[desc] = counter;
+
+	return counter;
+}
+
+void TimingManager::get_settings(input_file &inp) {
+	std::string telemetry_file;
+	if(getInputString(&inp, "telemetry_file", telemetry_file, 0) == KEY_NOT_FOUND) return;
+
+	_telemetry_every = 10000;
+	getInputLLInt(&inp, "telemetry_every", &_telemetry_every, 0);
+	if(_telemetry_every < 1) throw oxDNAException("telemetry_every should be larger than 0");
+
+	bool restart_step_counter = false;
+	getInputBool(&inp, "restart_step_counter", &restart_step_counter, 0);
+	if(restart_step_counter) _telemetry.open(telemetry_file.c_str());
+	else _telemetry.open(telemetry_file.c_str(), std::ios_base::app);
+	if(!_telemetry.good()) throw oxDNAException("Telemetry file '%s' is not writable", telemetry_file.c_str());
+
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	_telemetry_start = tv.tv_sec + tv.tv_usec * 1e-6;
+
+	for(unsigned int i = 0; i < _counters.size(); i++) _counters[i]->set_active(true);
+	OX_LOG(Logger::LOG_INFO, "Writing the telemetry to '%s' every %lld steps", telemetry_file.c_str(), _telemetry_every);
+}
+
+void TimingManager::write_telemetry(long long int step) {
+	if(!telemetry_enabled()) return;
+
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	double wall_time = tv.tv_sec + tv.tv_usec * 1e-6 - _telemetry_start;
+
+	// timers are reported in seconds of CPU time, in the order in which they have been created
+	std::string line = Utils::sformat("{\"step\": %lld, \"wall_time\": %.3lf, \"timers\": {", step, wall_time);
+	for(unsigned int i = 0; i < _timers.size(); i++) {
+		if(i > 0) line += ", ";
+		line += Utils::sformat("%s: %.6lf", Utils::json_string(_timers[i]->get_desc()).c_str(), _timers[i]->get_time() / CPSF);
+	}
+	line += "}, \"counters\": {";
+	for(unsigned int i = 0; i < _counters.size(); i++) {
+		if(i > 0) line += ", ";
+		line += Utils::sformat("%s: %lld", Utils::json_string(_counters[i]->get_desc()).c_str(), _counters[i]->get_value());
+	}
+	line += "}}";
+
+	_telemetry << line << std::endl;
+}
+
 Timer * TimingManager::new_timer(std::string desc) {
 	if(_desc_map.count(desc) != 0) throw oxDNAException("timer %s already used! Aborting", desc.c_str());
 
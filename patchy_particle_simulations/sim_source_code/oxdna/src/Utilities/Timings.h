@@ -12,6 +12,9 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <fstream>
+
+#include "parse_input/parse_input.h"
 
 #ifndef CPS
 #define CPS (CLOCKS_PER_SEC)
@@ -72,6 +75,48 @@ public:
 	}
 };
 
+/// counts events (e.g. energy evaluations) for the telemetry. Counters do nothing unless the telemetry is enabled
+class Counter {
+private:
+	/// string describing the counter
+	std::string _desc;
+
+	long long int _value;
+
+	/// whether the counter is counting
+	bool _active;
+
+public:
+	Counter(std::string desc);
+	~Counter();
+
+	/// adds n to the counter. It is safe to call it from different threads at the same time
+	void add(long long int n=1) {
+		if(!_active) return;
+#ifdef HAVE_OPENMP
+#pragma omp atomic
+#endif
+		_value += n;
+	}
+
+	void set_active(bool active) {
+		_active = active;
+	}
+
+	bool is_active() {
+		return _active;
+	}
+
+	long long int get_value() {
+		return _value;
+	}
+
+	/// returns the description of the counter
+	std::string get_desc() {
+		return _desc;
+	}
+};
+
 /// new attempt at a singleton to be able to add from anywhere within the code a timer and have it do what expected
 class TimingManager {
 private:
@@ -80,6 +125,14 @@ private:
 	std::map<Timer *, Timer *> _parents;
 	std::map<std::string, Timer *> _desc_map;
 
+	std::vector<Counter *> _counters;
+	std::map<std::string, Counter *> _counter_map;
+
+	std::ofstream _telemetry;
+	long long int _telemetry_every;
+	/// wall-clock time at which the telemetry has been enabled, in seconds
+	double _telemetry_start;
+
 	static TimingManager * _timingManager;
 
 	/**
@@ -117,6 +170,41 @@ public:
 		return _desc_map[desc];
 	}
 
+	/// returns the counter with the given description, creating it if it does not exist
+	Counter * get_counter(std::string desc);
+
+	/**
+	 * @brief Reads the telemetry options. If the telemetry is enabled, the values of all the timers and counters are
+	 * appended to the telemetry file, as a JSON object per line, every telemetry_every steps.
+	 *
+	 * @verbatim
+[telemetry_file = <string> (name of the telemetry file. If not specified the telemetry is disabled and the counters do not count)]
+[telemetry_every = <int> (number of steps between two consecutive telemetry lines, defaults to 10000)]
+@endverbatim
+	 *
+	 * @param inp
+	 */
+	void get_settings(input_file &inp);
+
+	bool telemetry_enabled() {
+		return _telemetry_every > 0;
+	}
+
+	/// writes a line to the telemetry file if the telemetry is enabled and it is time to do so
+	void telemetry_step(long long int step) {
+		if(_telemetry_every > 0 && step % _telemetry_every == 0) write_telemetry(step);
+	}
+
+	/// returns the first step, larger than or equal to the given one, at which telemetry_step will write a line, or -1 if the telemetry is disabled
+	long long int next_telemetry_step(long long int step) {
+		if(_telemetry_every < 1) return -1;
+		long long int rest = step % _telemetry_every;
+		return (rest == 0) ? step : step + _telemetry_every - rest;
+	}
+
+	/// writes the current values of all the timers and counters to the telemetry file
+	void write_telemetry(long long int step);
+
 	/// singleton
 	static TimingManager * instance();
 
@@ -109,6 +109,31 @@ std::string Utils::sformat_ap(const std::string &fmt, va_list &ap) {
 	return str;
 }
 
+std::string Utils::json_string(const std::string &s) {
+	std::string res("\"");
+	for(unsigned int i = 0; i < s.size(); i++) {
+		if(s[i] == '"' || s[i] == '\\') res += '\\';
+		res += s[i];
+	}
+	return res + "\"";
+}
+
+void Utils::write_blob(std::ostream &out, const std::string &data) {
+	llint size = data.size();
+	out.write((char *) &size, sizeof(llint));
+	out.write(data.c_str(), size);
+}
+
+std::string Utils::read_blob(std::istream &in) {
+	llint size;
+	in.read((char *) &size, sizeof(llint));
+	if(!in.good() || size < 0) throw oxDNAException("Malformed binary data: cannot read the size of a block");
+	std::string data(size, '\0');
+	if(size > 0) in.read(&data[0], size);
+	if(!in.good()) throw oxDNAException("Malformed binary data: a block of %lld bytes ends prematurely", size);
+	return data;
+}
+
 input_file *Utils::get_input_file_from_string(const std::string &inp) {
 	std::string real_inp(inp);
 
@@ -236,7 +261,7 @@ number Utils::gamma(number alpha, number beta) {
 	double d = alpha - 1. / 3.;
 	double c = (1. / 3.) / sqrt(d);
 
-	if(alpha < 1.) return pow(drand48(), 1. / alpha) * gamma((number) 1. + alpha, beta);
+	if(alpha < 1.) return pow(RandomManager::instance()->uniform(), 1. / alpha) * gamma((number) 1. + alpha, beta);
 
 	while(true) {
 		do {
@@ -245,7 +270,7 @@ number Utils::gamma(number alpha, number beta) {
 		} while(v <= 0);
 
 		v = v * v * v;
-		u = drand48();
+		u = RandomManager::instance()->uniform();
 
 		if(u < 1. - 0.0331 * x * x * x * x) break;
 
@@ -266,6 +291,14 @@ bool Utils::is_integer(std::string s) {
 
 }
 
+llint Utils::next_multiple(llint step, llint every, llint start) {
+	if(every < 1) return -1;
+	if(step < start) step = start;
+	llint rest = step % every;
+	if(rest < 0) rest += every;
+	return (rest == 0) ? step : step + every - rest;
+}
+
 template<typename number>
 std::vector<int> Utils::getParticlesFromString(BaseParticle<number> **particles, int N, std::string particle_string, char const *identifier) {
 	// first remove all the spaces from the string, so that the parsing goes well.
@@ -18,8 +18,10 @@
 #include <cstdarg>
 #include <cstdio>
 #include <vector>
+#include <iostream>
 
 #include "../defs.h"
+#include "RandomManager.h"
 
 template<typename number> class BaseParticle;
 
@@ -86,6 +88,30 @@ public:
 	 */
 	static std::string sformat_ap(const std::string &fmt, va_list &ap);
 
+	/**
+	 * @brief Returns the given string as a quoted JSON string, escaping the characters that need to be escaped.
+	 *
+	 * @param s
+	 * @return
+	 */
+	static std::string json_string(const std::string &s);
+
+	/**
+	 * @brief Writes the size of data followed by its content, so that it can be read back by read_blob without knowing its length beforehand.
+	 *
+	 * @param out
+	 * @param data
+	 */
+	static void write_blob(std::ostream &out, const std::string &data);
+
+	/**
+	 * @brief Reads a string written by write_blob. Throws an oxDNAException if the stream ends too early.
+	 *
+	 * @param in
+	 * @return
+	 */
+	static std::string read_blob(std::istream &in);
+
 	/**
 	 * @brief Generates a random vector having module 1.
 	 *
@@ -207,6 +233,25 @@ public:
 	 */
 	static bool is_integer(std::string s);
 
+	/**
+	 * @brief Utility function that returns the first step that is larger than or equal to both step and start and is a
+	 * multiple of every.
+	 * @param step
+	 * @param every
+	 * @param start
+	 * @return the step, or -1 if every is smaller than 1
+	 */
+	static llint next_multiple(llint step, llint every, llint start=0);
+
+	/**
+	 * @brief Utility function that returns the earliest of two steps, either of which can be -1 (meaning "never").
+	 */
+	static llint earliest_step(llint a, llint b) {
+		if(a < 0) return b;
+		if(b < 0) return a;
+		return (a < b) ? a : b;
+	}
+
 };
 
 template<typename number>
@@ -215,8 +260,8 @@ inline LR_vector<number> Utils::get_random_vector() {
 	number ran1, ran2;
 
 	while(ransq >= 1) {
-		ran1 = 1. - 2. * drand48();
-		ran2 = 1. - 2. * drand48();
+		ran1 = 1. - 2. * RandomManager::instance()->uniform();
+		ran2 = 1. - 2. * RandomManager::instance()->uniform();
 		ransq = ran1 * ran1 + ran2 * ran2;
 	}
 
@@ -230,7 +275,7 @@ inline LR_vector<number> Utils::get_random_vector_in_sphere(number r) {
 	LR_vector<number> res = LR_vector<number>(r, r, r);
 
 	while(res.norm() > r2) {
-		res = LR_vector<number>(2. * r * (drand48() - 0.5), 2. * r * (drand48() - 0.5), 2. * r * (drand48() - 0.5));
+		res = LR_vector<number>(2. * r * (RandomManager::instance()->uniform() - 0.5), 2. * r * (RandomManager::instance()->uniform() - 0.5), 2. * r * (RandomManager::instance()->uniform() - 0.5));
 	}
 
 	return res;
@@ -277,7 +322,7 @@ inline LR_matrix<number> Utils::get_random_rotation_matrix_from_angle(number ang
 
 template<typename number>
 inline LR_matrix<number> Utils::get_random_rotation_matrix(number max_angle) {
-	number t = max_angle * (drand48() - 0.5);
+	number t = max_angle * (RandomManager::instance()->uniform() - 0.5);
 	return get_random_rotation_matrix_from_angle(t);
 }
 
@@ -295,8 +340,8 @@ inline number Utils::gaussian() {
 
 	w = 2.;
 	while(w >= 1.0) {
-		u = 2. * drand48() - 1.0;
-		v = 2. * drand48() - 1.0;
+		u = 2. * RandomManager::instance()->uniform() - 1.0;
+		v = 2. * RandomManager::instance()->uniform() - 1.0;
 		w = u * u + v * v;
 	}
 
@@ -0,0 +1,63 @@
+/**
+ * @file    batch.cpp
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ * @brief Main file for the batch runner
+ */
+
+#include "defs.h"
+#include "Managers/BatchManager.h"
+#include "Utilities/SignalManager.h"
+#include "Utilities/oxDNAException.h"
+#include "Utilities/Timings.h"
+#include "Utilities/RandomManager.h"
+
+/**
+ * oxDNA_batch runs all the simulations listed in a manifest file on a pool of worker processes. See BatchManager for
+ * the format of the manifest and for the supported options.
+ */
+
+void print_version() {
+	fprintf(stdout, "Batch runner for oxDNA %d.%d.%d by Lorenzo Rovigatti, Flavio Romano, Petr Sulc and Benedict Snodin (c) 2013\n", VERSION_MAJOR, VERSION_MINOR, VERSION_STAGE);
+	exit(-1);
+}
+
+int main(int argc, char *argv[]) {
+	BatchManager *mybatch = NULL;
+	int N_failed = 0;
+
+	try {
+		Logger::init();
+		SignalManager::manage_segfault();
+		TimingManager::init();
+		RandomManager::init();
+
+		if(argc < 2) throw oxDNAException("Usage is '%s manifest_file [key=value ...]'", argv[0]);
+		if(!strcmp(argv[1], "-v")) print_version();
+
+		mybatch = new BatchManager(argc, argv);
+		mybatch->load_options();
+
+		OX_DEBUG("Initializing");
+		mybatch->init();
+
+		OX_DEBUG("Running");
+		mybatch->run();
+
+		N_failed = mybatch->N_failed();
+		if(N_failed > 0) OX_LOG(Logger::LOG_WARNING, "%d runs failed or were not started", N_failed);
+		else OX_LOG(Logger::LOG_INFO, "END OF THE BATCH, everything went OK!");
+	}
+	catch (oxDNAException &e) {
+		OX_LOG(Logger::LOG_ERROR, "%s", e.error());
+		return 1;
+	}
+
+	delete mybatch;
+	RandomManager::clear();
+	TimingManager::clear();
+	Logger::clear();
+
+	return (N_failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file    benchmark.cpp
+ * @date    17/oct/2026
+ * @author  petr
+ *
+ * @brief Main file for the micro-benchmarks
+ */
+
+#include "defs.h"
+#include "Managers/BenchmarkManager.h"
+#include "Utilities/SignalManager.h"
+#include "Utilities/oxDNAException.h"
+#include "Utilities/Timings.h"
+#include "Utilities/RandomManager.h"
+
+/**
+ * benchmark times pair_interaction, the lists and the MC moves on the configuration of an oxDNA input file and
+ * prints the results in JSON format. See BenchmarkManager for the supported options.
+ */
+
+void print_version() {
+	fprintf(stdout, "Micro-benchmarks for oxDNA %d.%d.%d by Lorenzo Rovigatti, Flavio Romano, Petr Sulc and Benedict Snodin (c) 2013\n", VERSION_MAJOR, VERSION_MINOR, VERSION_STAGE);
+	exit(-1);
+}
+
+int main(int argc, char *argv[]) {
+	BenchmarkManager *mybench = NULL;
+
+	try {
+		Logger::init();
+		SignalManager::manage_segfault();
+		TimingManager::init();
+		RandomManager::init();
+
+		if(argc < 2) throw oxDNAException("Usage is '%s input_file [key=value ...]'", argv[0]);
+		if(!strcmp(argv[1], "-v")) print_version();
+
+		mybench = new BenchmarkManager(argc, argv);
+		mybench->load_options();
+
+		OX_DEBUG("Initializing");
+		mybench->init();
+
+		OX_LOG(Logger::LOG_INFO, "SVN CODE VERSION: %s", SVN_VERSION);
+		OX_LOG(Logger::LOG_INFO, "COMPILED ON: %s", BUILD_TIME);
+
+		OX_DEBUG("Running");
+		mybench->run();
+
+		OX_LOG(Logger::LOG_INFO, "END OF THE BENCHMARKS, everything went OK!");
+	}
+	catch (oxDNAException &e) {
+		OX_LOG(Logger::LOG_ERROR, "%s", e.error());
+		return 1;
+	}
+
+	delete mybench;
+	RandomManager::clear();
+	TimingManager::clear();
+	Logger::clear();
+
+	return 0;
+}
@@ -7,6 +7,8 @@
 #include "defs.h"
 #include "Managers/GeneratorManager.h"
 #include "Utilities/SignalManager.h"
+#include "Utilities/RandomManager.h"
+#include "Utilities/Timings.h"
 
 /**
  * confGenerator is a tool to generate initial configurations for oxDNA
@@ -22,6 +24,8 @@ void print_version() {
 int main(int argc, char *argv[]) {
 	try {
 		Logger::init();
+		RandomManager::init();
+		TimingManager::init();
 		SignalManager::manage_segfault();
 		if(argc < 3) throw oxDNAException("Usage is '%s input_file [box_size|density]'\nthe third argument will be interpreted as a density if it is less than 2.0", argv[0]);
 		else if(argc > 1 && !strcmp(argv[1], "-v")) print_version();
@@ -47,6 +51,8 @@ int main(int argc, char *argv[]) {
 		exit(1);
 	}
 
+	TimingManager::clear();
+	RandomManager::clear();
 	Logger::clear();
 
 	return 0;
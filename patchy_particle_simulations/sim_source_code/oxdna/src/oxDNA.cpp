@@ -22,6 +22,7 @@
 #include "Utilities/SignalManager.h"
 #include "Utilities/oxDNAException.h"
 #include "Utilities/Timings.h"
+#include "Utilities/RandomManager.h"
 
 using namespace std;
 
@@ -37,6 +38,7 @@ int main(int argc, char *argv[]) {
 		Logger::init();
 		SignalManager::manage_segfault();
 		TimingManager::init();
+		RandomManager::init();
 
 		if(argc < 2) throw oxDNAException("Usage is '%s input_file'", argv[0]);
 		if(!strcmp(argv[1], "-v")) print_version();
@@ -61,6 +63,7 @@ int main(int argc, char *argv[]) {
 	}
 
 	delete mysim;
+	RandomManager::clear();
 	TimingManager::clear();
 	Logger::clear();
 
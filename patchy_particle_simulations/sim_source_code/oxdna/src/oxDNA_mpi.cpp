@@ -24,6 +24,7 @@
 #include "Utilities/SignalManager.h"
 #include "Utilities/oxDNAException.h"
 #include "Utilities/Timings.h"
+#include "Utilities/RandomManager.h"
 #include "Utilities/Utils.h"
 
 
@@ -50,6 +51,7 @@ int main(int argc, char *argv[]) {
 
 	try {
 		TimingManager::init();
+		RandomManager::init();
 		if(argc < 2) throw oxDNAException("Usage is '%s input_file'", argv[0]);
 		if(!strcmp(argv[1], "-v")) print_version();
 
@@ -78,6 +80,7 @@ int main(int argc, char *argv[]) {
 		return 1;
 	}
 
+	RandomManager::clear();
 	TimingManager::clear();
 	Logger::clear();
 
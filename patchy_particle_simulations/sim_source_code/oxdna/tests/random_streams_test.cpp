@@ -0,0 +1,100 @@
+/**
+ * @file    random_streams_test.cpp
+ * @date    18/oct/2026
+ * @author  petr
+ *
+ * @brief Checks that the replicas of a simulation draw different random numbers
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <string>
+
+#include "../src/Utilities/Logger.h"
+#include "../src/Utilities/oxDNAException.h"
+#include "../src/Utilities/Timings.h"
+#include "../src/Utilities/RandomManager.h"
+
+/**
+ * random_streams_test seeds the RandomManager with the same seed several times, each time with a different replica
+ * id, as the processes of a parallel tempering simulation do, and draws numbers from drand48(), from the stream of the
+ * master thread and from an extra stream obtained with make_stream(). The program exits with a non-zero status if two
+ * different replicas draw the same numbers from any of them, or if replica 0 does not draw the same numbers drawn by
+ * a manager whose replica id was never set. Both rng_types are tested.
+ *
+ * Usage is 'random_streams_test [seed]'.
+ */
+
+/// number of random numbers drawn from each source
+#define STREAMS_TEST_N 16
+
+/// the numbers drawn by a single replica: one set for each source
+struct Draws {
+	std::vector<double> drand;
+	std::vector<double> master;
+	std::vector<double> extra;
+};
+
+/// initialises a new RandomManager with the given rng_type, seed and replica (if non-negative) and draws the numbers
+Draws draw(const std::string &rng_type, long seed, int replica) {
+	RandomManager::init();
+	RandomManager *rng = RandomManager::instance();
+
+	input_file inp;
+	addInput(&inp, std::string("rng_type = ") + rng_type);
+	rng->get_settings(inp);
+	cleanInputFile(&inp);
+
+	rng->seed(seed);
+	if(replica >= 0) rng->set_replica(replica);
+
+	Draws res;
+	RandomStream extra = rng->make_stream(7);
+	for(int i = 0; i < STREAMS_TEST_N; i++) {
+		res.drand.push_back(drand48());
+		res.master.push_back(rng->uniform());
+		res.extra.push_back(extra.uniform());
+	}
+
+	RandomManager::clear();
+	return res;
+}
+
+/// returns the number of sources that gave the same numbers to the two replicas
+int N_equal(const Draws &a, const Draws &b) {
+	return (a.drand == b.drand) + (a.master == b.master) + (a.extra == b.extra);
+}
+
+int main(int argc, char *argv[]) {
+	long seed = (argc > 1) ? atol(argv[1]) : 12345;
+
+	try {
+		Logger::init();
+		TimingManager::init();
+
+		const char *rng_types[2] = { "drand48", "philox" };
+		for(int t = 0; t < 2; t++) {
+			Draws unset = draw(rng_types[t], seed, -1);
+			std::vector<Draws> replicas;
+			for(int r = 0; r < 3; r++) replicas.push_back(draw(rng_types[t], seed, r));
+
+			if(N_equal(unset, replicas[0]) != 3) throw oxDNAException("rng_type = %s: replica 0 does not draw the numbers drawn by a manager without replica id", rng_types[t]);
+			for(int r = 0; r < 3; r++) {
+				for(int s = r + 1; s < 3; s++) {
+					if(N_equal(replicas[r], replicas[s]) != 0) throw oxDNAException("rng_type = %s: replicas %d and %d draw the same random numbers", rng_types[t], r, s);
+				}
+			}
+			printf("rng_type = %s: the replicas draw different random numbers\n", rng_types[t]);
+		}
+	}
+	catch (oxDNAException &e) {
+		OX_LOG(Logger::LOG_ERROR, "%s", e.error());
+		return 1;
+	}
+
+	TimingManager::clear();
+	Logger::clear();
+
+	return 0;
+}